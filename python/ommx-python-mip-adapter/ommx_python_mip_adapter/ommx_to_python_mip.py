@@ -94,6 +94,15 @@ class PythonMIPBuilder:
                 )
                 + ommx_linear.constant
             )  # type: ignore
+        elif f.HasField("columnar_linear"):
+            columnar = f.columnar_linear
+            return (
+                mip.xsum(
+                    coefficient * self.model.vars[str(id)]  # type: ignore
+                    for id, coefficient in zip(columnar.ids, columnar.coefficients)
+                )
+                + columnar.constant
+            )  # type: ignore
         raise OMMXPythonMIPAdapterError(
             "The function must be either `constant` or `linear`."
         )
@@ -102,6 +111,34 @@ class PythonMIPBuilder:
         self.model.objective = self.as_lin_expr(self.instance.raw.objective)  # type: ignore
 
     def set_constraints(self):
+        try:
+            matrix = self.instance.linear_constraint_matrix()
+        except RuntimeError:
+            # Build one by one to report which constraint is not supported
+            self._set_constraints_one_by_one()
+            return
+
+        vars = [self.model.vars[str(id)] for id in matrix["variable_ids"].tolist()]
+        offsets = matrix["row_offsets"].tolist()
+        columns = matrix["columns"].tolist()
+        values = matrix["values"].tolist()
+        rhs = matrix["rhs"].tolist()
+        equalities = matrix["equalities"].tolist()
+        for k, id in enumerate(matrix["constraint_ids"].tolist()):
+            start, end = offsets[k], offsets[k + 1]
+            if equalities[k] == Constraint.EQUAL_TO_ZERO:
+                sense = "="
+            else:
+                sense = "<"
+            lin_expr = mip.LinExpr(
+                variables=[vars[c] for c in columns[start:end]],
+                coeffs=values[start:end],
+                const=-rhs[k],
+                sense=sense,
+            )
+            self.model.add_constr(lin_expr, name=str(id))
+
+    def _set_constraints_one_by_one(self):
         for constraint in self.instance.raw.constraints:
             lin_expr = self.as_lin_expr(constraint.function)
             if constraint.equality == Constraint.EQUAL_TO_ZERO:
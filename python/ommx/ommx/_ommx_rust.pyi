@@ -1,5 +1,8 @@
 from __future__ import annotations
 
+import os
+import numpy
+
 class Descriptor:
     @property
     def digest(self) -> str: ...
@@ -15,6 +18,99 @@ class Descriptor:
     def to_dict(self) -> dict[str, str | int | dict[str, str]]: ...
     def to_json(self) -> str: ...
 
+class Blob:
+    def __len__(self) -> int: ...
+    def __buffer__(self, flags: int) -> memoryview: ...
+
+class Linear:
+    def __init__(self, terms: dict[int, float], constant: float = 0.0): ...
+    @staticmethod
+    def from_arrays(
+        ids: numpy.ndarray, coefficients: numpy.ndarray, constant: float = 0.0
+    ) -> Linear: ...
+    @staticmethod
+    def decode(bytes: bytes) -> Linear: ...
+    def to_bytes(self) -> bytes: ...
+    @property
+    def terms(self) -> dict[int, float]: ...
+    @property
+    def constant(self) -> float: ...
+    def copy(self) -> Linear: ...
+    def add_term(self, id: int, coefficient: float): ...
+    def add_constant(self, constant: float): ...
+    def add_linear(self, other: Linear): ...
+    def scale(self, factor: float): ...
+    def mul_linear(self, other: Linear) -> Quadratic: ...
+    def __len__(self) -> int: ...
+
+class Quadratic:
+    def __init__(
+        self,
+        rows: list[int],
+        columns: list[int],
+        values: list[float],
+        linear: Linear | None = None,
+    ): ...
+    @staticmethod
+    def from_arrays(
+        rows: numpy.ndarray,
+        columns: numpy.ndarray,
+        values: numpy.ndarray,
+        linear: Linear | None = None,
+    ) -> Quadratic: ...
+    def to_bytes(self) -> bytes: ...
+    @property
+    def linear(self) -> Linear: ...
+    def copy(self) -> Quadratic: ...
+    def add_term(self, row: int, column: int, value: float): ...
+    def add_linear(self, other: Linear): ...
+    def add_constant(self, constant: float): ...
+    def add_quadratic(self, other: Quadratic): ...
+    def scale(self, factor: float): ...
+    def __len__(self) -> int: ...
+
+class Polynomial:
+    def __init__(self, terms: list[tuple[list[int], float]]): ...
+    def to_bytes(self) -> bytes: ...
+    def copy(self) -> Polynomial: ...
+    def add_term(self, ids: list[int], coefficient: float): ...
+    def add_linear(self, other: Linear): ...
+    def add_quadratic(self, other: Quadratic): ...
+    def add_polynomial(self, other: Polynomial): ...
+    def scale(self, factor: float): ...
+    def __len__(self) -> int: ...
+
+class Instance:
+    @staticmethod
+    def from_bytes(bytes: bytes) -> Instance: ...
+    def to_bytes(self) -> bytes: ...
+    @property
+    def variable_ids(self) -> numpy.ndarray: ...
+    @property
+    def constraint_ids(self) -> numpy.ndarray: ...
+    def evaluate(
+        self, state: dict[int, float] | numpy.ndarray, *, dense_state: bool = False
+    ) -> Solution: ...
+    def evaluate_samples(
+        self,
+        states: list[dict[int, float] | numpy.ndarray],
+        *,
+        dense_state: bool = False,
+    ) -> list[Solution]: ...
+    def evaluate_dense(self, samples: numpy.ndarray) -> dict[str, numpy.ndarray]: ...
+
+class Solution:
+    def to_bytes(self) -> bytes: ...
+    @property
+    def objective(self) -> float: ...
+    @property
+    def feasible(self) -> bool: ...
+    @property
+    def entries(self) -> dict[int, float]: ...
+    @property
+    def constraint_values(self) -> dict[int, float]: ...
+    def columns(self) -> dict[str, numpy.ndarray | list]: ...
+
 class ArtifactArchive:
     @staticmethod
     def from_oci_archive(path: str) -> ArtifactArchive: ...
@@ -24,7 +120,7 @@ class ArtifactArchive:
     def annotations(self) -> dict[str, str]: ...
     @property
     def layers(self) -> list[Descriptor]: ...
-    def get_blob(self, digest: str) -> bytes: ...
+    def get_blob(self, digest: str) -> Blob: ...
     def push(self): ...
 
 class ArtifactDir:
@@ -38,7 +134,7 @@ class ArtifactDir:
     def annotations(self) -> dict[str, str]: ...
     @property
     def layers(self) -> list[Descriptor]: ...
-    def get_blob(self, digest: str) -> bytes: ...
+    def get_blob(self, digest: str) -> Blob: ...
     def push(self): ...
 
 class ArtifactArchiveBuilder:
@@ -71,4 +167,21 @@ def evaluate_quadratic(evaluated: bytes, state: bytes) -> tuple[float, set[int]]
 def evaluate_polynomial(evaluated: bytes, state: bytes) -> tuple[float, set[int]]: ...
 def evaluate_constraint(evaluated: bytes, state: bytes) -> tuple[bytes, set[int]]: ...
 def evaluate_instance(evaluated: bytes, state: bytes) -> tuple[bytes, set[int]]: ...
+def evaluate_instance_samples(evaluated: bytes, states: list[bytes]) -> list[bytes]: ...
+def partial_evaluate_instance(instance: bytes, state: bytes) -> bytes: ...
 def used_decision_variable_ids(function: bytes) -> set[int]: ...
+def encode_instance_zstd(instance: bytes, level: int) -> bytes: ...
+def decode_instance_zstd(blob: bytes | memoryview) -> bytes: ...
+def linear_constraint_matrix(
+    instance: bytes,
+) -> dict[str, numpy.ndarray | float]: ...
+def solution_columns(
+    solution: bytes, atol: float
+) -> dict[str, numpy.ndarray | list]: ...
+def write_mps(instance: bytes, path: str | os.PathLike) -> None: ...
+def read_mps(path: str | os.PathLike) -> bytes: ...
+def write_lp(instance: bytes, path: str | os.PathLike) -> None: ...
+def read_lp(path: str | os.PathLike) -> bytes: ...
+def pull_artifacts(
+    image_names: list[str], concurrency: int = 4, jobs: int = 4
+) -> list[ArtifactDir]: ...
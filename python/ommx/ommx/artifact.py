@@ -1,11 +1,13 @@
 from __future__ import annotations
 
+import asyncio
 import io
 import json
 import pandas
 import numpy
 from dataclasses import dataclass
 from pathlib import Path
+from typing import Iterable
 from dateutil import parser
 
 from ._ommx_rust import (
@@ -14,6 +16,9 @@ from ._ommx_rust import (
     Descriptor,
     ArtifactArchiveBuilder,
     ArtifactDirBuilder,
+    encode_instance_zstd,
+    decode_instance_zstd,
+    pull_artifacts,
 )
 from .v1 import Instance, Solution
 
@@ -69,12 +74,58 @@ class Artifact:
         base = ArtifactDir.from_image_name(image_name)
         return Artifact(base)
 
+    @staticmethod
+    async def load_async(image_name: str) -> Artifact:
+        """
+        Awaitable :py:meth:`load`, which pulls the image without blocking the event loop
+
+        >>> import asyncio
+        >>> name = "ghcr.io/jij-inc/ommx/random_lp_instance:4303c7f"
+        >>> artifact = asyncio.run(Artifact.load_async(name))
+        >>> print(artifact.image_name)
+        ghcr.io/jij-inc/ommx/random_lp_instance:4303c7f
+
+        """
+        (artifact,) = await Artifact.load_all([image_name])
+        return artifact
+
+    @staticmethod
+    async def load_all(
+        image_names: Iterable[str], concurrency: int = 4, jobs: int = 4
+    ) -> list[Artifact]:
+        """
+        Load the artifacts concurrently, in the order of ``image_names``
+
+        At most ``concurrency`` images are pulled at once in Rust, and each of them downloads ``jobs`` blobs concurrently.
+        The pulls run without the GIL in a worker thread, and do not block the event loop.
+        Duplicated names are pulled only once.
+
+        >>> import asyncio
+        >>> names = ["ghcr.io/jij-inc/ommx/random_lp_instance:4303c7f"] * 2
+        >>> artifacts = asyncio.run(Artifact.load_all(names))
+        >>> print([a.image_name == names[0] for a in artifacts])
+        [True, True]
+
+        """
+        loop = asyncio.get_running_loop()
+        bases = await loop.run_in_executor(
+            None, pull_artifacts, list(image_names), concurrency, jobs
+        )
+        return [Artifact(base) for base in bases]
+
     def push(self):
         """
         Push the artifact to remote registry
         """
         self._base.push()
 
+    async def push_async(self):
+        """
+        Awaitable :py:meth:`push`, which uploads in a worker thread without blocking the event loop
+        """
+        loop = asyncio.get_running_loop()
+        await loop.run_in_executor(None, self.push)
+
     @property
     def image_name(self) -> str | None:
         return self._base.image_name
@@ -112,10 +163,16 @@ class Artifact:
                 return layer
         raise ValueError(f"Layer {digest} not found")
 
-    def get_blob(self, digest: str | Descriptor) -> bytes:
+    def get_blob(self, digest: str | Descriptor) -> memoryview:
+        """
+        Get the blob of the layer as a read-only :py:class:`memoryview`
+
+        The blob is memory-mapped from the artifact file without copying, and can be passed to APIs accepting bytes-like objects.
+        Use ``bytes(blob)`` to get a copy as :py:class:`bytes`.
+        """
         if isinstance(digest, Descriptor):
             digest = digest.digest
-        return self._base.get_blob(digest)
+        return memoryview(self._base.get_blob(digest))
 
     def get_layer(self, descriptor: Descriptor) -> Instance | Solution | numpy.ndarray:
         """
@@ -123,7 +180,12 @@ class Artifact:
 
         This is dynamically dispatched based on the :py:attr:`Descriptor.media_type`.
         """
-        if descriptor.media_type == "application/org.ommx.v1.instance":
+        if descriptor.media_type in (
+            "application/org.ommx.v1.instance",
+            "application/org.ommx.v1.instance+zstd",
+            "application/org.ommx.v1.instance.header",
+            "application/org.ommx.v1.instance.shard",
+        ):
             return self.get_instance(descriptor)
         if descriptor.media_type == "application/org.ommx.v1.solution":
             return self.get_solution(descriptor)
@@ -149,10 +211,24 @@ class Artifact:
         >>> print(instance.created)
         2024-05-28 08:40:28.728169+00:00
 
-        """
-        assert descriptor.media_type == "application/org.ommx.v1.instance"
+        For a sharded instance, pass the descriptor of ``application/org.ommx.v1.instance.header``
+        to get the whole instance merged with its shards.
+        The descriptor of ``application/org.ommx.v1.instance.shard`` yields the instance of the single shard,
+        which has only a part of constraints and decision variables.
 
+        """
         blob = self.get_blob(descriptor)
+        if descriptor.media_type == "application/org.ommx.v1.instance+zstd":
+            blob = decode_instance_zstd(blob)
+        elif descriptor.media_type == "application/org.ommx.v1.instance.header":
+            # Repeated fields of protobuf messages are merged by concatenation
+            shards = self._shard_descriptors(descriptor)
+            blob = b"".join([blob] + [self.get_blob(shard) for shard in shards])
+        else:
+            assert descriptor.media_type in (
+                "application/org.ommx.v1.instance",
+                "application/org.ommx.v1.instance.shard",
+            )
         instance = Instance.from_bytes(blob)
         annotations = descriptor.annotations
         if "org.ommx.v1.instance.created" in annotations:
@@ -163,6 +239,27 @@ class Artifact:
             instance.title = annotations["org.ommx.v1.instance.title"]
         return instance
 
+    def _shard_descriptors(self, header: Descriptor) -> list[Descriptor]:
+        """
+        Descriptors of the shards of the header in order of ``org.ommx.v1.instance.shard.index``
+        """
+        num_shards = int(header.annotations["org.ommx.v1.instance.shards"])
+        shards = sorted(
+            (
+                (int(layer.annotations["org.ommx.v1.instance.shard.index"]), layer)
+                for layer in self.layers
+                if layer.media_type == "application/org.ommx.v1.instance.shard"
+                and layer.annotations.get("org.ommx.v1.instance.shard.header")
+                == header.digest
+            ),
+            key=lambda shard: shard[0],
+        )
+        if [index for index, _ in shards] != list(range(num_shards)):
+            raise ValueError(
+                f"Shards of instance {header.digest} are broken: expected {num_shards} shards"
+            )
+        return [layer for _, layer in shards]
+
     def get_solution(self, descriptor: Descriptor) -> Solution:
         assert descriptor.media_type == "application/org.ommx.v1.solution"
 
@@ -363,17 +460,43 @@ class ArtifactBuilder:
         """
         return ArtifactBuilder(ArtifactDirBuilder.for_github(org, repo, name, tag))
 
-    def add_instance(self, instance: Instance) -> Descriptor:
+    def add_instance(
+        self, instance: Instance, compression_level: int | None = None
+    ) -> Descriptor:
         """
         Add an instance to the artifact with annotations
+
+        If ``compression_level`` is given, the instance is compressed by zstd of the level,
+        and stored as a layer of ``application/org.ommx.v1.instance+zstd``.
+
+        >>> from ommx.v1 import Instance, DecisionVariable
+        >>> x = [DecisionVariable.binary(i) for i in range(3)]
+        >>> instance = Instance.from_components(
+        ...     decision_variables=x,
+        ...     objective=sum(x),
+        ...     constraints=[],
+        ...     sense=Instance.MAXIMIZE,
+        ... )
+        >>> builder = ArtifactBuilder.temp()
+        >>> desc = builder.add_instance(instance, compression_level=3)
+        >>> print(desc.media_type)
+        application/org.ommx.v1.instance+zstd
+        >>> artifact = builder.build()
+        >>> artifact.get_instance(desc).raw == instance.raw
+        True
+
         """
         blob = instance.to_bytes()
+        media_type = "application/org.ommx.v1.instance"
+        if compression_level is not None:
+            blob = encode_instance_zstd(blob, compression_level)
+            media_type = "application/org.ommx.v1.instance+zstd"
         annotations = instance.annotations.copy()
         if instance.created:
             annotations["org.ommx.v1.instance.created"] = instance.created.isoformat()
         if instance.title:
             annotations["org.ommx.v1.instance.title"] = instance.title
-        return self.add_layer("application/org.ommx.v1.instance", blob, annotations)
+        return self.add_layer(media_type, blob, annotations)
 
     def add_solution(self, solution: Solution) -> Descriptor:
         """
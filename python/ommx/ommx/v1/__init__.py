@@ -1,10 +1,13 @@
 from __future__ import annotations
-from typing import Optional, Iterable
+from typing import Optional, Iterable, Any
 from datetime import datetime
+import os
 from dataclasses import dataclass, field
 from pandas import DataFrame, concat, MultiIndex
+from numpy.typing import ArrayLike
+import numpy
 
-from .solution_pb2 import State, Solution as _Solution
+from .solution_pb2 import State, DenseState, Solution as _Solution
 from .instance_pb2 import Instance as _Instance
 from .function_pb2 import Function as _Function
 from .quadratic_pb2 import Quadratic as _Quadratic
@@ -13,7 +16,22 @@ from .linear_pb2 import Linear as _Linear
 from .constraint_pb2 import Equality, Constraint as _Constraint
 from .decision_variables_pb2 import DecisionVariable as _DecisionVariable, Bound
 
-from .._ommx_rust import evaluate_instance, used_decision_variable_ids
+from .._ommx_rust import (
+    Instance as _CompiledInstance,
+    Linear as _LinearBuilder,
+    Quadratic as _QuadraticBuilder,
+    Polynomial as _PolynomialBuilder,
+    evaluate_instance,
+    evaluate_instance_samples,
+    partial_evaluate_instance,
+    linear_constraint_matrix,
+    solution_columns,
+    used_decision_variable_ids,
+    write_mps,
+    read_mps,
+    write_lp,
+    read_lp,
+)
 
 
 @dataclass
@@ -145,9 +163,213 @@ class Instance:
         return concat([df, parameters], axis=1).set_index("id")
 
     def evaluate(self, state: State) -> Solution:
+        """
+        Evaluate the instance with the state.
+
+        Values of contiguous IDs can be given in the dense form by :class:`DenseState`,
+        which is smaller to serialize and faster to look up than ``entries``.
+
+        >>> from ommx.v1 import Instance, DecisionVariable, DenseState, State
+        >>> x = [DecisionVariable.binary(i) for i in range(3)]
+        >>> instance = Instance.from_components(
+        ...     decision_variables=x,
+        ...     objective=sum(x),
+        ...     constraints=[x[0] + x[1] <= 1],
+        ...     sense=Instance.MAXIMIZE,
+        ... )
+        >>> solution = instance.evaluate(State(dense=DenseState(offset=0, values=[1, 0, 1])))
+        >>> (solution.raw.objective, solution.raw.feasible)
+        (2.0, True)
+
+        """
         out, _ = evaluate_instance(self.to_bytes(), state.SerializeToString())
         return Solution.from_bytes(out)
 
+    def partial_evaluate(self, state: State) -> Instance:
+        """
+        Fix the decision variables in ``state`` and return the reduced instance.
+
+        The fixed variables are folded into constants and removed from ``decision_variables``.
+        Constraints which become constant are removed if satisfied, and ``RuntimeError`` is raised if violated.
+
+        >>> from ommx.v1 import Instance, DecisionVariable, State
+        >>> x = [DecisionVariable.binary(i) for i in range(3)]
+        >>> instance = Instance.from_components(
+        ...     decision_variables=x,
+        ...     objective=x[0] + x[1] + x[2],
+        ...     constraints=[x[0] + x[1] <= 1, x[1] + x[2] <= 1],
+        ...     sense=Instance.MAXIMIZE,
+        ... )
+        >>> reduced = instance.partial_evaluate(State(entries={0: 1, 1: 0}))
+        >>> [v.id for v in reduced.raw.decision_variables]
+        [2]
+        >>> len(reduced.raw.constraints)
+        1
+        >>> reduced.evaluate(State(entries={2: 1})).raw.objective
+        2.0
+
+        """
+        out = partial_evaluate_instance(self.to_bytes(), state.SerializeToString())
+        return Instance.from_bytes(out)
+
+    def evaluate_samples(self, states: Iterable[State]) -> list[Solution]:
+        """
+        Evaluate many states at once. The instance is serialized only once and the states are evaluated in parallel.
+
+        >>> from ommx.v1 import Instance, DecisionVariable
+        >>> from ommx.v1.solution_pb2 import State
+        >>> x = [DecisionVariable.binary(i) for i in range(3)]
+        >>> instance = Instance.from_components(
+        ...     decision_variables=x,
+        ...     objective=sum(x),
+        ...     constraints=[x[0] + x[1] <= 1],
+        ...     sense=Instance.MAXIMIZE,
+        ... )
+        >>> solutions = instance.evaluate_samples([
+        ...     State(entries={0: 1, 1: 0, 2: 1}),
+        ...     State(entries={0: 1, 1: 1, 2: 1}),
+        ... ])
+        >>> [(s.raw.objective, s.raw.feasible) for s in solutions]
+        [(2.0, True), (3.0, False)]
+
+        """
+        out = evaluate_instance_samples(
+            self.to_bytes(), [state.SerializeToString() for state in states]
+        )
+        return [Solution.from_bytes(solution) for solution in out]
+
+    def compile(self) -> _CompiledInstance:
+        """
+        Decode and compile this instance once in Rust for repeated evaluation.
+
+        The returned object accepts states as dicts or NumPy arrays in the order of ``variable_ids``
+        without serializing them, and the evaluated solutions are serialized into ``ommx.v1.Solution`` only by ``to_bytes``.
+        Changes of :py:attr:`raw` after this call are not reflected.
+
+        A state given as a NumPy array is stored in the serialized solution as ``State.entries``.
+        Pass ``dense_state=True`` to ``evaluate`` or ``evaluate_samples`` to store it as ``State.dense`` without building the map,
+        where ``State.entries`` of the serialized solution is empty. ``Solution.entries`` returns the values in either form.
+
+        >>> import numpy
+        >>> from ommx.v1 import Instance, DecisionVariable
+        >>> x = [DecisionVariable.binary(i) for i in range(3)]
+        >>> instance = Instance.from_components(
+        ...     decision_variables=x,
+        ...     objective=sum(x),
+        ...     constraints=[x[0] + x[1] <= 1],
+        ...     sense=Instance.MAXIMIZE,
+        ... )
+        >>> compiled = instance.compile()
+        >>> solution = compiled.evaluate({0: 1, 1: 0, 2: 1})
+        >>> solution.objective, solution.feasible
+        (2.0, True)
+        >>> compiled.evaluate(numpy.array([1.0, 1.0, 1.0])).feasible
+        False
+        >>> dense = compiled.evaluate(numpy.array([1.0, 0.0, 1.0]), dense_state=True)
+        >>> dense.entries == solution.entries
+        True
+        >>> Solution.from_bytes(solution.to_bytes()).raw.objective
+        2.0
+
+        """
+        return _CompiledInstance.from_bytes(self.to_bytes())
+
+    def linear_constraint_matrix(self) -> dict[str, Any]:
+        """
+        Export the linear objective and constraints as NumPy arrays for matrix APIs of solvers.
+
+        The constraint matrix is in CSR format, i.e. the ``k``-th row is ``columns[row_offsets[k]:row_offsets[k+1]]``
+        and ``values[row_offsets[k]:row_offsets[k+1]]``, and columns are the decision variables sorted by ID.
+        Each row means ``a @ x == rhs`` or ``a @ x <= rhs`` according to ``equalities``.
+        ``RuntimeError`` is raised if the objective or a constraint is not linear.
+
+        >>> from ommx.v1 import Instance, DecisionVariable
+        >>> x = [DecisionVariable.binary(i) for i in range(3)]
+        >>> instance = Instance.from_components(
+        ...     decision_variables=x,
+        ...     objective=sum(x),
+        ...     constraints=[x[0] + 2 * x[2] <= 1],
+        ...     sense=Instance.MAXIMIZE,
+        ... )
+        >>> matrix = instance.linear_constraint_matrix()
+        >>> matrix["row_offsets"].tolist(), matrix["columns"].tolist(), matrix["values"].tolist()
+        ([0, 2], [0, 2], [1.0, 2.0])
+        >>> matrix["rhs"].tolist(), matrix["lower"].tolist(), matrix["upper"].tolist()
+        ([1.0], [0.0, 0.0, 0.0], [1.0, 1.0, 1.0])
+
+        """
+        return linear_constraint_matrix(self.to_bytes())
+
+    def write_mps(self, path: str | os.PathLike):
+        """
+        Write the instance to a free MPS file for solvers.
+
+        Decision variables and constraints are named as ``x{id}`` and ``c{id}``, and they are read back by :py:meth:`load_mps`.
+        ``RuntimeError`` is raised if the objective or a constraint is not linear.
+
+        >>> import tempfile, os
+        >>> from ommx.v1 import Instance, DecisionVariable
+        >>> x = [DecisionVariable.binary(i) for i in range(3)]
+        >>> instance = Instance.from_components(
+        ...     decision_variables=x,
+        ...     objective=sum(x),
+        ...     constraints=[x[0] + x[1] <= 1],
+        ...     sense=Instance.MAXIMIZE,
+        ... )
+        >>> with tempfile.TemporaryDirectory() as dir:
+        ...     path = os.path.join(dir, "instance.mps")
+        ...     instance.write_mps(path)
+        ...     loaded = Instance.load_mps(path)
+        >>> [v.id for v in loaded.raw.decision_variables]
+        [0, 1, 2]
+        >>> loaded.evaluate(State(entries={0: 1, 1: 0, 2: 1})).raw.objective
+        2.0
+
+        """
+        write_mps(self.to_bytes(), path)
+
+    @staticmethod
+    def load_mps(path: str | os.PathLike) -> Instance:
+        """
+        Read an instance from a free MPS file, see :py:meth:`write_mps`.
+        """
+        return Instance.from_bytes(read_mps(path))
+
+    def write_lp(self, path: str | os.PathLike):
+        """
+        Write the instance to a CPLEX LP file for solvers.
+
+        Decision variables and constraints are named as ``x{id}`` and ``c{id}``, and they are read back by :py:meth:`load_lp`.
+        ``RuntimeError`` is raised if the objective or a constraint is not linear.
+
+        >>> import tempfile, os
+        >>> from ommx.v1 import Instance, DecisionVariable
+        >>> x = [DecisionVariable.integer(i, lower=0, upper=5) for i in range(2)]
+        >>> instance = Instance.from_components(
+        ...     decision_variables=x,
+        ...     objective=x[0] - 2 * x[1],
+        ...     constraints=[x[0] + x[1] == 3],
+        ...     sense=Instance.MINIMIZE,
+        ... )
+        >>> with tempfile.TemporaryDirectory() as dir:
+        ...     path = os.path.join(dir, "instance.lp")
+        ...     instance.write_lp(path)
+        ...     loaded = Instance.load_lp(path)
+        >>> loaded.raw.constraints[0].equality == Equality.EQUALITY_EQUAL_TO_ZERO
+        True
+        >>> loaded.evaluate(State(entries={0: 1, 1: 2})).raw.objective
+        -3.0
+
+        """
+        write_lp(self.to_bytes(), path)
+
+    @staticmethod
+    def load_lp(path: str | os.PathLike) -> Instance:
+        """
+        Read an instance from a CPLEX LP file, see :py:meth:`write_lp`.
+        """
+        return Instance.from_bytes(read_lp(path))
+
 
 @dataclass
 class Solution:
@@ -192,6 +414,11 @@ class Solution:
     Arbitrary annotations stored in OMMX artifact. Use :py:attr:`parameters` or other specific attributes if possible.
     """
 
+    _columns: dict[float, dict[str, numpy.ndarray | list]] = field(
+        default_factory=dict, init=False, repr=False, compare=False
+    )
+    """Cache of :py:meth:`columns` for each ``atol``"""
+
     @staticmethod
     def from_bytes(data: bytes) -> Solution:
         raw = _Solution()
@@ -201,30 +428,83 @@ class Solution:
     def to_bytes(self) -> bytes:
         return self.raw.SerializeToString()
 
+    def columns(self, atol: float = 1e-6) -> dict[str, numpy.ndarray | list]:
+        """
+        Decision variables and evaluated constraints as columns built in Rust, see ``ommx::SolutionColumns``.
+
+        ``variable_ids``, ``kinds``, ``lower``, ``upper`` and ``values`` are NumPy arrays in the order of ``raw.decision_variables``,
+        and ``names``, ``subscripts``, ``descriptions`` and ``parameters`` are lists in the same order.
+        ``constraint_ids``, ``equalities``, ``constraint_values`` and ``constraint_feasible`` are NumPy arrays in the order of ``raw.evaluated_constraints``,
+        and ``used_decision_variable_ids``, ``constraint_names``, ``constraint_descriptions`` and ``constraint_parameters`` are lists in the same order.
+        ``values`` is ``nan`` for decision variables not in the state, and ``constraint_feasible`` allows the absolute violation ``atol``.
+
+        The columns are built only at the first call for each ``atol``, and shared by :py:attr:`decision_variables` and :py:attr:`constraints`.
+        Changes of :py:attr:`raw` after the call are not reflected.
+
+        >>> from ommx.v1 import Instance, DecisionVariable
+        >>> x = [DecisionVariable.binary(i) for i in range(3)]
+        >>> instance = Instance.from_components(
+        ...     decision_variables=x,
+        ...     objective=sum(x),
+        ...     constraints=[x[0] + x[1] <= 1],
+        ...     sense=Instance.MAXIMIZE,
+        ... )
+        >>> solution = instance.evaluate(State(entries={0: 1, 1: 1, 2: 0}))
+        >>> columns = solution.columns()
+        >>> columns["variable_ids"].tolist(), columns["values"].tolist()
+        ([0, 1, 2], [1.0, 1.0, 0.0])
+        >>> columns["constraint_values"].tolist(), columns["constraint_feasible"].tolist()
+        ([1.0], [False])
+
+        """
+        if atol not in self._columns:
+            self._columns[atol] = solution_columns(self.to_bytes(), atol)
+        return self._columns[atol]
+
     @property
     def decision_variables(self) -> DataFrame:
-        return _decision_variables(self.raw)
+        columns = self.columns()
+        df = DataFrame(
+            {
+                "id": columns["variable_ids"],
+                "kind": _KINDS[columns["kinds"]],
+                "lower": columns["lower"],
+                "upper": columns["upper"],
+                "name": columns["names"],
+                "subscripts": columns["subscripts"],
+                "description": columns["descriptions"],
+            }
+        )
+        return _with_parameters(df, columns["parameters"])
 
     @property
     def constraints(self) -> DataFrame:
-        evaluation = self.raw.evaluated_constraints
-        parameters = DataFrame(dict(v.parameters) for v in evaluation)
-        parameters.columns = MultiIndex.from_product(
-            [["parameters"], parameters.columns]
-        )
+        columns = self.columns()
         df = DataFrame(
             {
-                "id": v.id,
-                "equality": _equality(v.equality),
-                "value": v.evaluated_value,
-                "used_ids": set(v.used_decision_variable_ids),
-                "name": v.name,
-                "description": v.description,
+                "id": columns["constraint_ids"],
+                "equality": _EQUALITIES[columns["equalities"]],
+                "value": columns["constraint_values"],
+                "used_ids": columns["used_decision_variable_ids"],
+                "name": columns["constraint_names"],
+                "description": columns["constraint_descriptions"],
             }
-            for v in evaluation
         )
-        df.columns = MultiIndex.from_product([df.columns, [""]])
-        return concat([df, parameters], axis=1).set_index("id")
+        return _with_parameters(df, columns["constraint_parameters"])
+
+
+def _with_parameters(df: DataFrame, parameters: list[dict[str, str]]) -> DataFrame:
+    """
+    Append ``parameters`` as the second level of columns, and set ``id`` as the index.
+
+    ``parameters`` are appended only when any of them is not empty.
+    """
+    df.columns = MultiIndex.from_product([df.columns, [""]])
+    if any(parameters):
+        frame = DataFrame(parameters)
+        frame.columns = MultiIndex.from_product([["parameters"], frame.columns])
+        df = concat([df, frame], axis=1)
+    return df.set_index("id")
 
 
 def _decision_variables(obj: _Instance | _Solution) -> DataFrame:
@@ -250,7 +530,7 @@ def _decision_variables(obj: _Instance | _Solution) -> DataFrame:
 def _function_type(function: _Function) -> str:
     if function.HasField("constant"):
         return "constant"
-    if function.HasField("linear"):
+    if function.HasField("linear") or function.HasField("columnar_linear"):
         return "linear"
     if function.HasField("quadratic"):
         return "quadratic"
@@ -275,6 +555,21 @@ def _kind(kind: _DecisionVariable.Kind.ValueType) -> str:
     raise ValueError("Unknown kind")
 
 
+# Names of `Kind` and `Equality` indexed by their protobuf values, for the codes returned by `solution_columns`
+_KINDS = numpy.array(
+    [
+        "unspecified",
+        "binary",
+        "integer",
+        "continuous",
+        "semi-integer",
+        "semi-continuous",
+    ],
+    dtype=object,
+)
+_EQUALITIES = numpy.array(["unspecified", "=0", "<=0"], dtype=object)
+
+
 def _equality(equality: Equality.ValueType) -> str:
     if equality == Equality.EQUALITY_EQUAL_TO_ZERO:
         return "=0"
@@ -445,14 +740,12 @@ class DecisionVariable:
         """
         return self.raw == other.raw
 
+    def _as_linear(self) -> Linear:
+        return Linear(terms={self.raw.id: 1})
+
     def __add__(self, other: int | float | DecisionVariable) -> Linear:
-        if isinstance(other, float) or isinstance(other, int):
-            return Linear(terms={self.raw.id: 1}, constant=other)
-        if isinstance(other, DecisionVariable):
-            if self.raw.id == other.raw.id:
-                return Linear(terms={self.raw.id: 2})
-            else:
-                return Linear(terms={self.raw.id: 1, other.raw.id: 1})
+        if isinstance(other, (float, int, DecisionVariable)):
+            return self._as_linear().__iadd__(other)
         return NotImplemented
 
     def __sub__(self, other) -> Linear:
@@ -467,12 +760,16 @@ class DecisionVariable:
     def __rsub__(self, other) -> Linear:
         return -self + other
 
-    def __mul__(self, other: int | float) -> Linear:
+    def __mul__(
+        self, other: int | float | DecisionVariable | Linear
+    ) -> Linear | Quadratic:
         if isinstance(other, float) or isinstance(other, int):
             return Linear(terms={self.raw.id: other})
+        if isinstance(other, (DecisionVariable, Linear)):
+            return self._as_linear() * other
         return NotImplemented
 
-    def __rmul__(self, other) -> Linear:
+    def __rmul__(self, other) -> Linear | Quadratic:
         return self * other
 
     def __eq__(self, other) -> Constraint:  # type: ignore[reportGeneralTypeIssues]
@@ -513,9 +810,98 @@ class DecisionVariable:
         return self.__le__(other)
 
 
-@dataclass
 class Linear:
-    raw: _Linear
+    """
+    Linear function backed by a Rust hash map of decision variable ID to coefficient.
+
+    The protobuf message :py:attr:`raw` is serialized only when it is requested, e.g. when building :py:class:`Instance`.
+    Use ``+=`` to accumulate terms in-place, since ``+`` copies the terms to create a new object:
+
+    >>> x = [DecisionVariable.binary(i) for i in range(3)]
+    >>> f = Linear(terms={})
+    >>> for i in range(3):
+    ...     f += (i + 1) * x[i]
+    >>> f.terms
+    {0: 1.0, 1: 2.0, 2: 3.0}
+
+    For the same reason, the builtin :py:func:`sum` takes quadratic time for many terms. Use :py:meth:`Linear.sum` instead.
+
+    """
+
+    _inner: _LinearBuilder
+
+    def __init__(self, *, terms: dict[int, float | int], constant: float | int = 0):
+        self._inner = _LinearBuilder(terms, constant)
+
+    @staticmethod
+    def _from_inner(inner: _LinearBuilder) -> Linear:
+        out = Linear.__new__(Linear)
+        out._inner = inner
+        return out
+
+    @staticmethod
+    def from_arrays(
+        ids: ArrayLike, coefficients: ArrayLike, constant: float | int = 0
+    ) -> Linear:
+        """
+        Create from arrays of decision variable IDs and coefficients without iterating in Python.
+        Coefficients of the same ID are summed up.
+
+        >>> import numpy
+        >>> f = Linear.from_arrays(numpy.array([1, 2, 1]), numpy.array([1.0, 2.0, 3.0]), constant=5)
+        >>> f.terms, f.constant
+        ({1: 4.0, 2: 2.0}, 5.0)
+
+        """
+        return Linear._from_inner(
+            _LinearBuilder.from_arrays(
+                numpy.asarray(ids, dtype=numpy.uint64),
+                numpy.asarray(coefficients, dtype=numpy.float64),
+                constant,
+            )
+        )
+
+    @staticmethod
+    def sum(functions: Iterable[int | float | DecisionVariable | Linear]) -> Linear:
+        """
+        Sum up the functions in-place into a new linear function, in linear time of the number of terms.
+
+        The builtin :py:func:`sum` copies the accumulated terms for every addition.
+
+        >>> x = [DecisionVariable.binary(i) for i in range(3)]
+        >>> f = Linear.sum((i + 1) * x[i] for i in range(3))
+        >>> f.terms, f.constant
+        ({0: 1.0, 1: 2.0, 2: 3.0}, 0.0)
+
+        """
+        out = Linear(terms={})
+        for f in functions:
+            out += f
+        return out
+
+    @property
+    def raw(self) -> _Linear:
+        """
+        The protobuf message, whose terms are sorted by ID
+
+        .. versionchanged:: 0.6.0
+            Since the terms are kept in Rust, a new message is serialized for every access.
+            Modifying the returned message does not change this function,
+            and accessing it in a loop costs the whole serialization each time.
+        """
+        return _Linear.FromString(self._inner.to_bytes())
+
+    @property
+    def terms(self) -> dict[int, float]:
+        """Coefficients of the decision variable IDs, sorted by ID"""
+        return self._inner.terms
+
+    @property
+    def constant(self) -> float:
+        return self._inner.constant
+
+    def copy(self) -> Linear:
+        return Linear._from_inner(self._inner.copy())
 
     def equals_to(self, other: Linear) -> bool:
         """
@@ -523,30 +909,30 @@ class Linear:
         """
         return self.raw == other.raw
 
-    def __init__(self, *, terms: dict[int, float | int], constant: float | int = 0):
-        self.raw = _Linear(
-            terms=[
-                _Linear.Term(id=id, coefficient=coefficient)
-                for id, coefficient in terms.items()
-            ],
-            constant=constant,
-        )
+    def __repr__(self) -> str:
+        return f"Linear(terms={self.terms}, constant={self.constant})"
 
-    def __add__(self, other: int | float | DecisionVariable | Linear) -> Linear:
+    def __iadd__(self, other: int | float | DecisionVariable | Linear) -> Linear:
         if isinstance(other, float) or isinstance(other, int):
-            self.raw.constant += other
+            self._inner.add_constant(other)
             return self
         if isinstance(other, DecisionVariable):
-            terms = {term.id: term.coefficient for term in self.raw.terms}
-            terms[other.raw.id] = terms.get(other.raw.id, 0) + 1
-            return Linear(terms=terms, constant=self.raw.constant)
+            self._inner.add_term(other.raw.id, 1)
+            return self
         if isinstance(other, Linear):
-            terms = {term.id: term.coefficient for term in self.raw.terms}
-            for term in other.raw.terms:
-                terms[term.id] = terms.get(term.id, 0) + term.coefficient
-            return Linear(terms=terms, constant=self.raw.constant + other.raw.constant)
+            if other is self:
+                self._inner.scale(2)
+            else:
+                self._inner.add_linear(other._inner)
+            return self
         return NotImplemented
 
+    def __add__(self, other: int | float | DecisionVariable | Linear) -> Linear:
+        if isinstance(other, (Quadratic, Polynomial)):
+            return other + self
+        out = self.copy()
+        return out.__iadd__(other)
+
     def __sub__(self, other) -> Linear:
         return self + (-other)
 
@@ -556,15 +942,20 @@ class Linear:
     def __rsub__(self, other) -> Linear:
         return -self + other
 
-    def __mul__(self, other: int | float) -> Linear:
+    def __mul__(
+        self, other: int | float | DecisionVariable | Linear
+    ) -> Linear | Quadratic:
         if isinstance(other, float) or isinstance(other, int):
-            return Linear(
-                terms={term.id: term.coefficient * other for term in self.raw.terms},
-                constant=self.raw.constant * other,
-            )
+            out = self.copy()
+            out._inner.scale(other)
+            return out
+        if isinstance(other, DecisionVariable):
+            other = other._as_linear()
+        if isinstance(other, Linear):
+            return Quadratic._from_inner(self._inner.mul_linear(other._inner))
         return NotImplemented
 
-    def __rmul__(self, other) -> Linear:
+    def __rmul__(self, other) -> Linear | Quadratic:
         return self * other
 
     def __neg__(self) -> Linear:
@@ -611,9 +1002,21 @@ class Linear:
         return self.__le__(other)
 
 
-@dataclass
 class Quadratic:
-    raw: _Quadratic
+    """
+    Quadratic function backed by a Rust hash map of ``(row, column)`` IDs to value, with its linear part.
+
+    The protobuf message :py:attr:`raw` is serialized only when it is requested, same as :py:class:`Linear`.
+
+    >>> x = DecisionVariable.binary(1)
+    >>> y = DecisionVariable.binary(2)
+    >>> q = x * y + 2 * x * x + y + 1
+    >>> q.raw.rows, q.raw.columns, q.raw.values
+    ([1, 1], [1, 2], [2.0, 1.0])
+
+    """
+
+    _inner: _QuadraticBuilder
 
     def __init__(
         self,
@@ -623,29 +1026,228 @@ class Quadratic:
         values: Iterable[float | int],
         linear: Optional[Linear] = None,
     ):
-        self.raw = _Quadratic(
-            columns=columns,
-            rows=raws,
-            values=values,
-            linear=linear.raw if linear else None,
+        self._inner = _QuadraticBuilder(
+            list(raws),
+            list(columns),
+            list(values),
+            linear._inner if linear else None,
         )
 
-    # TODO: Implement __add__, __radd__, __mul__, __rmul__
+    @staticmethod
+    def _from_inner(inner: _QuadraticBuilder) -> Quadratic:
+        out = Quadratic.__new__(Quadratic)
+        out._inner = inner
+        return out
+
+    @staticmethod
+    def from_arrays(
+        rows: ArrayLike,
+        columns: ArrayLike,
+        values: ArrayLike,
+        linear: Optional[Linear] = None,
+    ) -> Quadratic:
+        """
+        Create from COO arrays without iterating in Python. Values of the same ``(row, column)`` are summed up.
+        """
+        return Quadratic._from_inner(
+            _QuadraticBuilder.from_arrays(
+                numpy.asarray(rows, dtype=numpy.uint64),
+                numpy.asarray(columns, dtype=numpy.uint64),
+                numpy.asarray(values, dtype=numpy.float64),
+                linear._inner if linear else None,
+            )
+        )
+
+    @property
+    def raw(self) -> _Quadratic:
+        """
+        The protobuf message, whose entries are sorted by ``(row, column)``
+
+        .. versionchanged:: 0.6.0
+            A new message is serialized for every access, see :py:attr:`Linear.raw`.
+        """
+        return _Quadratic.FromString(self._inner.to_bytes())
+
+    def copy(self) -> Quadratic:
+        return Quadratic._from_inner(self._inner.copy())
+
+    def __repr__(self) -> str:
+        raw = self.raw
+        linear = Linear._from_inner(self._inner.linear)
+        return (
+            f"Quadratic(rows={list(raw.rows)}, columns={list(raw.columns)}, "
+            f"values={list(raw.values)}, linear={linear})"
+        )
+
+    def __iadd__(
+        self, other: int | float | DecisionVariable | Linear | Quadratic
+    ) -> Quadratic:
+        if isinstance(other, float) or isinstance(other, int):
+            self._inner.add_constant(other)
+            return self
+        if isinstance(other, DecisionVariable):
+            other = other._as_linear()
+        if isinstance(other, Linear):
+            self._inner.add_linear(other._inner)
+            return self
+        if isinstance(other, Quadratic):
+            if other is self:
+                self._inner.scale(2)
+            else:
+                self._inner.add_quadratic(other._inner)
+            return self
+        return NotImplemented
+
+    def __add__(self, other: int | float | DecisionVariable | Linear | Quadratic):
+        if isinstance(other, Polynomial):
+            return other + self
+        out = self.copy()
+        return out.__iadd__(other)
+
+    def __sub__(self, other) -> Quadratic:
+        return self + (-other)
+
+    def __radd__(self, other) -> Quadratic:
+        return self + other
+
+    def __rsub__(self, other) -> Quadratic:
+        return -self + other
+
+    def __mul__(self, other: int | float) -> Quadratic:
+        if isinstance(other, float) or isinstance(other, int):
+            out = self.copy()
+            out._inner.scale(other)
+            return out
+        return NotImplemented
+
+    def __rmul__(self, other) -> Quadratic:
+        return self * other
+
+    def __neg__(self) -> Quadratic:
+        return -1 * self
+
+    def __eq__(self, other) -> Constraint:  # type: ignore[reportGeneralTypeIssues]
+        return Constraint(
+            function=self - other, equality=Equality.EQUALITY_EQUAL_TO_ZERO
+        )
+
+    def __le__(self, other) -> Constraint:
+        return Constraint(
+            function=self - other, equality=Equality.EQUALITY_LESS_THAN_OR_EQUAL_TO_ZERO
+        )
+
+    def __ge__(self, other) -> Constraint:
+        return Constraint(
+            function=other - self, equality=Equality.EQUALITY_LESS_THAN_OR_EQUAL_TO_ZERO
+        )
 
 
-@dataclass
 class Polynomial:
-    raw: _Polynomial
+    """
+    Polynomial backed by a Rust hash map of monomials to coefficient.
+
+    The order of IDs in a monomial is ignored, i.e. ``x1 * x2`` and ``x2 * x1`` are the same monomial.
+
+    >>> p = Polynomial(coefficients=[([1, 2], 1), ([2, 1], 2), ([1, 1, 1], 3)])
+    >>> p += 1
+    >>> [(list(m.ids), m.coefficient) for m in p.raw.terms]
+    [([], 1.0), ([1, 2], 3.0), ([1, 1, 1], 3.0)]
+
+    """
+
+    _inner: _PolynomialBuilder
 
     def __init__(self, *, coefficients: Iterable[tuple[Iterable[int], float | int]]):
-        self.raw = _Polynomial(
-            terms=[
-                _Monomial(ids=ids, coefficient=coefficient)
-                for ids, coefficient in coefficients
-            ]
+        self._inner = _PolynomialBuilder(
+            [(list(ids), coefficient) for ids, coefficient in coefficients]
+        )
+
+    @staticmethod
+    def _from_inner(inner: _PolynomialBuilder) -> Polynomial:
+        out = Polynomial.__new__(Polynomial)
+        out._inner = inner
+        return out
+
+    @property
+    def raw(self) -> _Polynomial:
+        """
+        The protobuf message, whose monomials are sorted by degree, then IDs
+
+        .. versionchanged:: 0.6.0
+            A new message is serialized for every access, see :py:attr:`Linear.raw`.
+        """
+        return _Polynomial.FromString(self._inner.to_bytes())
+
+    def copy(self) -> Polynomial:
+        return Polynomial._from_inner(self._inner.copy())
+
+    def __repr__(self) -> str:
+        terms = [(list(m.ids), m.coefficient) for m in self.raw.terms]
+        return f"Polynomial(coefficients={terms})"
+
+    def __iadd__(
+        self, other: int | float | DecisionVariable | Linear | Quadratic | Polynomial
+    ) -> Polynomial:
+        if isinstance(other, float) or isinstance(other, int):
+            self._inner.add_term([], other)
+            return self
+        if isinstance(other, DecisionVariable):
+            self._inner.add_term([other.raw.id], 1)
+            return self
+        if isinstance(other, Linear):
+            self._inner.add_linear(other._inner)
+            return self
+        if isinstance(other, Quadratic):
+            self._inner.add_quadratic(other._inner)
+            return self
+        if isinstance(other, Polynomial):
+            if other is self:
+                self._inner.scale(2)
+            else:
+                self._inner.add_polynomial(other._inner)
+            return self
+        return NotImplemented
+
+    def __add__(self, other) -> Polynomial:
+        out = self.copy()
+        return out.__iadd__(other)
+
+    def __sub__(self, other) -> Polynomial:
+        return self + (-other)
+
+    def __radd__(self, other) -> Polynomial:
+        return self + other
+
+    def __rsub__(self, other) -> Polynomial:
+        return -self + other
+
+    def __mul__(self, other: int | float) -> Polynomial:
+        if isinstance(other, float) or isinstance(other, int):
+            out = self.copy()
+            out._inner.scale(other)
+            return out
+        return NotImplemented
+
+    def __rmul__(self, other) -> Polynomial:
+        return self * other
+
+    def __neg__(self) -> Polynomial:
+        return -1 * self
+
+    def __eq__(self, other) -> Constraint:  # type: ignore[reportGeneralTypeIssues]
+        return Constraint(
+            function=self - other, equality=Equality.EQUALITY_EQUAL_TO_ZERO
         )
 
-    # TODO: Implement __add__, __radd__, __mul__, __rmul__
+    def __le__(self, other) -> Constraint:
+        return Constraint(
+            function=self - other, equality=Equality.EQUALITY_LESS_THAN_OR_EQUAL_TO_ZERO
+        )
+
+    def __ge__(self, other) -> Constraint:
+        return Constraint(
+            function=other - self, equality=Equality.EQUALITY_LESS_THAN_OR_EQUAL_TO_ZERO
+        )
 
 
 def as_function(
@@ -654,7 +1256,7 @@ def as_function(
     if isinstance(f, (int, float)):
         return _Function(constant=f)
     elif isinstance(f, DecisionVariable):
-        return _Function(linear=Linear(terms={f.raw.id: 1}).raw)
+        return _Function(linear=f._as_linear().raw)
     elif isinstance(f, Linear):
         return _Function(linear=f.raw)
     elif isinstance(f, Quadratic):
@@ -23,6 +23,7 @@ class Function(google.protobuf.message.Message):
     LINEAR_FIELD_NUMBER: builtins.int
     QUADRATIC_FIELD_NUMBER: builtins.int
     POLYNOMIAL_FIELD_NUMBER: builtins.int
+    COLUMNAR_LINEAR_FIELD_NUMBER: builtins.int
     constant: builtins.float
     """Constant function like `f(x_1, x_2) = 2`"""
     @property
@@ -37,6 +38,10 @@ class Function(google.protobuf.message.Message):
     def polynomial(self) -> ommx.v1.polynomial_pb2.Polynomial:
         """Polynomial like `f(x_1, x_2) = 4 x_1^2 + 5 x_2^3 + 6 x_1 x_2^2 + 7 x_2^2 + 8 x_1 x_2 + 9 x_1 + 10 x_2 + 11`"""
 
+    @property
+    def columnar_linear(self) -> ommx.v1.linear_pb2.ColumnarLinear:
+        """Linear function stored as packed arrays, see `ColumnarLinear`"""
+
     def __init__(
         self,
         *,
@@ -44,10 +49,13 @@ class Function(google.protobuf.message.Message):
         linear: ommx.v1.linear_pb2.Linear | None = ...,
         quadratic: ommx.v1.quadratic_pb2.Quadratic | None = ...,
         polynomial: ommx.v1.polynomial_pb2.Polynomial | None = ...,
+        columnar_linear: ommx.v1.linear_pb2.ColumnarLinear | None = ...,
     ) -> None: ...
     def HasField(
         self,
         field_name: typing.Literal[
+            "columnar_linear",
+            b"columnar_linear",
             "constant",
             b"constant",
             "function",
@@ -63,6 +71,8 @@ class Function(google.protobuf.message.Message):
     def ClearField(
         self,
         field_name: typing.Literal[
+            "columnar_linear",
+            b"columnar_linear",
             "constant",
             b"constant",
             "function",
@@ -77,6 +87,11 @@ class Function(google.protobuf.message.Message):
     ) -> None: ...
     def WhichOneof(
         self, oneof_group: typing.Literal["function", b"function"]
-    ) -> typing.Literal["constant", "linear", "quadratic", "polynomial"] | None: ...
+    ) -> (
+        typing.Literal[
+            "constant", "linear", "quadratic", "polynomial", "columnar_linear"
+        ]
+        | None
+    ): ...
 
 global___Function = Function
@@ -14,7 +14,7 @@ _sym_db = _symbol_database.Default()
 
 
 DESCRIPTOR = _descriptor_pool.Default().AddSerializedFile(
-    b'\n\x14ommx/v1/linear.proto\x12\x07ommx.v1"\x8a\x01\n\x06Linear\x12*\n\x05terms\x18\x01 \x03(\x0b\x32\x14.ommx.v1.Linear.TermR\x05terms\x12\x1a\n\x08\x63onstant\x18\x02 \x01(\x01R\x08\x63onstant\x1a\x38\n\x04Term\x12\x0e\n\x02id\x18\x01 \x01(\x04R\x02id\x12 \n\x0b\x63oefficient\x18\x02 \x01(\x01R\x0b\x63oefficientBW\n\x0b\x63om.ommx.v1B\x0bLinearProtoP\x01\xa2\x02\x03OXX\xaa\x02\x07Ommx.V1\xca\x02\x07Ommx\\V1\xe2\x02\x13Ommx\\V1\\GPBMetadata\xea\x02\x08Ommx::V1b\x06proto3'
+    b'\n\x14ommx/v1/linear.proto\x12\x07ommx.v1"\x8a\x01\n\x06Linear\x12*\n\x05terms\x18\x01 \x03(\x0b\x32\x14.ommx.v1.Linear.TermR\x05terms\x12\x1a\n\x08\x63onstant\x18\x02 \x01(\x01R\x08\x63onstant\x1a\x38\n\x04Term\x12\x0e\n\x02id\x18\x01 \x01(\x04R\x02id\x12 \n\x0b\x63oefficient\x18\x02 \x01(\x01R\x0b\x63oefficient"b\n\x0e\x43olumnarLinear\x12\x10\n\x03ids\x18\x01 \x03(\x04R\x03ids\x12"\n\x0c\x63oefficients\x18\x02 \x03(\x01R\x0c\x63oefficients\x12\x1a\n\x08\x63onstant\x18\x03 \x01(\x01R\x08\x63onstantBW\n\x0b\x63om.ommx.v1B\x0bLinearProtoP\x01\xa2\x02\x03OXX\xaa\x02\x07Ommx.V1\xca\x02\x07Ommx\\V1\xe2\x02\x13Ommx\\V1\\GPBMetadata\xea\x02\x08Ommx::V1b\x06proto3'
 )
 
 _globals = globals()
@@ -29,4 +29,6 @@ if not _descriptor._USE_C_DESCRIPTORS:
     _globals["_LINEAR"]._serialized_end = 172
     _globals["_LINEAR_TERM"]._serialized_start = 116
     _globals["_LINEAR_TERM"]._serialized_end = 172
+    _globals["_COLUMNARLINEAR"]._serialized_start = 174
+    _globals["_COLUMNARLINEAR"]._serialized_end = 272
 # @@protoc_insertion_point(module_scope)
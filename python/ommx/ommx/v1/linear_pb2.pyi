@@ -54,3 +54,50 @@ class Linear(google.protobuf.message.Message):
     ) -> None: ...
 
 global___Linear = Linear
+
+@typing.final
+class ColumnarLinear(google.protobuf.message.Message):
+    """Linear function as packed parallel arrays of decision variable IDs and coefficients,
+    i.e. a columnar (struct-of-arrays) alternative of `Linear`.
+
+    `{ ids: [1, 2], coefficients: [2, 3], constant: 4 }` represents `2 x_1 + 3 x_2 + 4`
+    the same as `Linear { terms: [{ id: 1, coefficient: 2 }, { id: 2, coefficient: 3 }], constant: 4 }`.
+    Since repeated scalars are packed, this is smaller on the wire and decoded without parsing each term as a message.
+
+    - `ids` and `coefficients` must have the same length.
+    - IDs may be duplicated, and the coefficients of the same ID are summed up.
+    """
+
+    DESCRIPTOR: google.protobuf.descriptor.Descriptor
+
+    IDS_FIELD_NUMBER: builtins.int
+    COEFFICIENTS_FIELD_NUMBER: builtins.int
+    CONSTANT_FIELD_NUMBER: builtins.int
+    constant: builtins.float
+    @property
+    def ids(
+        self,
+    ) -> google.protobuf.internal.containers.RepeatedScalarFieldContainer[
+        builtins.int
+    ]: ...
+    @property
+    def coefficients(
+        self,
+    ) -> google.protobuf.internal.containers.RepeatedScalarFieldContainer[
+        builtins.float
+    ]: ...
+    def __init__(
+        self,
+        *,
+        ids: collections.abc.Iterable[builtins.int] | None = ...,
+        coefficients: collections.abc.Iterable[builtins.float] | None = ...,
+        constant: builtins.float = ...,
+    ) -> None: ...
+    def ClearField(
+        self,
+        field_name: typing.Literal[
+            "coefficients", b"coefficients", "constant", b"constant", "ids", b"ids"
+        ],
+    ) -> None: ...
+
+global___ColumnarLinear = ColumnarLinear
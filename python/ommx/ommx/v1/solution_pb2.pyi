@@ -69,6 +69,33 @@ RELAXATION_LP_RELAXED: Relaxation.ValueType  # 1
 """The solution is obtained by a relaxed linear programming problem."""
 global___Relaxation = Relaxation
 
+@typing.final
+class DenseState(google.protobuf.message.Message):
+    """Values of decision variables of contiguous IDs, i.e. `values[i]` is the value of the variable of ID `offset + i`."""
+
+    DESCRIPTOR: google.protobuf.descriptor.Descriptor
+
+    OFFSET_FIELD_NUMBER: builtins.int
+    VALUES_FIELD_NUMBER: builtins.int
+    offset: builtins.int
+    @property
+    def values(
+        self,
+    ) -> google.protobuf.internal.containers.RepeatedScalarFieldContainer[
+        builtins.float
+    ]: ...
+    def __init__(
+        self,
+        *,
+        offset: builtins.int = ...,
+        values: collections.abc.Iterable[builtins.float] | None = ...,
+    ) -> None: ...
+    def ClearField(
+        self, field_name: typing.Literal["offset", b"offset", "values", b"values"]
+    ) -> None: ...
+
+global___DenseState = DenseState
+
 @typing.final
 class State(google.protobuf.message.Message):
     """A set of values of decision variables, without any evaluation, even the
@@ -96,18 +123,31 @@ class State(google.protobuf.message.Message):
         ) -> None: ...
 
     ENTRIES_FIELD_NUMBER: builtins.int
+    DENSE_FIELD_NUMBER: builtins.int
     @property
     def entries(
         self,
     ) -> google.protobuf.internal.containers.ScalarMap[builtins.int, builtins.float]:
         """The value of the solution for each variable ID."""
 
+    @property
+    def dense(self) -> global___DenseState:
+        """Values of variables of contiguous IDs in a packed array, which is smaller and faster to look up than `entries`.
+        An ID may be stored in either `dense` or `entries`. If both have the ID, the value in `dense` is used.
+        """
+
     def __init__(
         self,
         *,
         entries: collections.abc.Mapping[builtins.int, builtins.float] | None = ...,
+        dense: global___DenseState | None = ...,
+    ) -> None: ...
+    def HasField(
+        self, field_name: typing.Literal["dense", b"dense"]
+    ) -> builtins.bool: ...
+    def ClearField(
+        self, field_name: typing.Literal["dense", b"dense", "entries", b"entries"]
     ) -> None: ...
-    def ClearField(self, field_name: typing.Literal["entries", b"entries"]) -> None: ...
 
 global___State = State
 
@@ -1,12 +1,12 @@
-use crate::PyDescriptor;
+use crate::{PyBlob, PyDescriptor};
 use anyhow::Result;
 use derive_more::{Deref, From};
 use ocipkg::{
     image::{Image, OciArchive, OciDir},
     Digest, ImageName,
 };
-use ommx::artifact::{image_dir, Artifact};
-use pyo3::{prelude::*, types::PyBytes};
+use ommx::artifact::{image_dir, pull_all, Artifact};
+use pyo3::prelude::*;
 use std::{collections::HashMap, path::PathBuf};
 
 #[pyclass]
@@ -17,8 +17,8 @@ pub struct ArtifactArchive(Artifact<OciArchive>);
 #[pymethods]
 impl ArtifactArchive {
     #[staticmethod]
-    pub fn from_oci_archive(path: PathBuf) -> Result<Self> {
-        let artifact = Artifact::from_oci_archive(&path)?;
+    pub fn from_oci_archive(py: Python<'_>, path: PathBuf) -> Result<Self> {
+        let artifact = py.allow_threads(|| Artifact::from_oci_archive(&path))?;
         Ok(Self(artifact))
     }
 
@@ -29,13 +29,13 @@ impl ArtifactArchive {
 
     #[getter]
     pub fn annotations(&mut self) -> Result<HashMap<String, String>> {
-        let manifest = self.0.get_manifest()?;
+        let manifest = self.0.manifest()?;
         Ok(manifest.annotations().as_ref().cloned().unwrap_or_default())
     }
 
     #[getter]
     pub fn layers(&mut self) -> Result<Vec<PyDescriptor>> {
-        let manifest = self.0.get_manifest()?;
+        let manifest = self.0.manifest()?;
         Ok(manifest
             .layers()
             .iter()
@@ -44,16 +44,20 @@ impl ArtifactArchive {
             .collect())
     }
 
-    pub fn get_blob<'py>(&mut self, py: Python<'py>, digest: &str) -> Result<Bound<'py, PyBytes>> {
+    pub fn get_blob(&mut self, py: Python<'_>, digest: &str) -> Result<PyBlob> {
         let digest = Digest::new(digest)?;
-        let blob = self.0.get_blob(&digest)?;
-        Ok(PyBytes::new_bound(py, blob.as_ref()))
+        let artifact = &mut self.0;
+        Ok(py
+            .allow_threads(|| artifact.get_layer_blob(&digest))?
+            .into())
     }
 
-    pub fn push(&mut self) -> Result<()> {
+    /// Push the artifact without the GIL, so that other Python threads can run during the upload
+    pub fn push(&mut self, py: Python<'_>) -> Result<()> {
         // Do not expose Artifact<Remote> to Python API for simplicity.
         // In Python API, the `Artifact` class always refers to the local artifact, which may be either an OCI archive or an OCI directory.
-        let _remote = self.0.push()?;
+        let artifact = &mut self.0;
+        let _remote = py.allow_threads(|| artifact.push())?;
         Ok(())
     }
 }
@@ -66,19 +70,23 @@ pub struct ArtifactDir(Artifact<OciDir>);
 #[pymethods]
 impl ArtifactDir {
     #[staticmethod]
-    pub fn from_image_name(image_name: &str) -> Result<Self> {
+    pub fn from_image_name(py: Python<'_>, image_name: &str) -> Result<Self> {
         let image_name = ImageName::parse(image_name)?;
         let local_path = image_dir(&image_name)?;
-        if local_path.exists() {
-            return Ok(Self(Artifact::from_oci_dir(&local_path)?));
-        }
-        let mut remote = Artifact::from_remote(image_name)?;
-        Ok(Self(remote.pull()?))
+        // Pull without the GIL, so that other Python threads can run during the download
+        let artifact = py.allow_threads(|| {
+            if local_path.exists() {
+                return Artifact::from_oci_dir(&local_path);
+            }
+            let mut remote = Artifact::from_remote(image_name)?;
+            remote.pull()
+        })?;
+        Ok(Self(artifact))
     }
 
     #[staticmethod]
-    pub fn from_oci_dir(path: PathBuf) -> Result<Self> {
-        let artifact = Artifact::from_oci_dir(&path)?;
+    pub fn from_oci_dir(py: Python<'_>, path: PathBuf) -> Result<Self> {
+        let artifact = py.allow_threads(|| Artifact::from_oci_dir(&path))?;
         Ok(Self(artifact))
     }
 
@@ -89,13 +97,13 @@ impl ArtifactDir {
 
     #[getter]
     pub fn annotations(&mut self) -> Result<HashMap<String, String>> {
-        let manifest = self.0.get_manifest()?;
+        let manifest = self.0.manifest()?;
         Ok(manifest.annotations().as_ref().cloned().unwrap_or_default())
     }
 
     #[getter]
     pub fn layers(&mut self) -> Result<Vec<PyDescriptor>> {
-        let manifest = self.0.get_manifest()?;
+        let manifest = self.0.manifest()?;
         Ok(manifest
             .layers()
             .iter()
@@ -104,16 +112,43 @@ impl ArtifactDir {
             .collect())
     }
 
-    pub fn get_blob<'py>(&mut self, py: Python<'py>, digest: &str) -> Result<Bound<'py, PyBytes>> {
+    pub fn get_blob(&mut self, py: Python<'_>, digest: &str) -> Result<PyBlob> {
         let digest = Digest::new(digest)?;
-        let blob = self.0.get_blob(&digest)?;
-        Ok(PyBytes::new_bound(py, blob.as_ref()))
+        let artifact = &mut self.0;
+        Ok(py
+            .allow_threads(|| artifact.get_layer_blob(&digest))?
+            .into())
     }
 
-    pub fn push(&mut self) -> Result<()> {
+    /// Push the artifact without the GIL, so that other Python threads can run during the upload
+    pub fn push(&mut self, py: Python<'_>) -> Result<()> {
         // Do not expose Artifact<Remote> to Python API for simplicity.
         // In Python API, the `Artifact` class always refers to the local artifact, which may be either an OCI archive or an OCI directory.
-        let _remote = self.0.push()?;
+        let artifact = &mut self.0;
+        let _remote = py.allow_threads(|| artifact.push())?;
         Ok(())
     }
 }
+
+/// Pull the images concurrently without the GIL, at most `concurrency` images at once, see `ommx::artifact::pull_all`
+///
+/// Images found in the local registry are opened without accessing the remote registry.
+#[pyfunction]
+#[pyo3(signature = (image_names, concurrency = 4, jobs = 4))]
+pub fn pull_artifacts(
+    py: Python<'_>,
+    image_names: Vec<String>,
+    concurrency: usize,
+    jobs: usize,
+) -> Result<Vec<ArtifactDir>> {
+    let image_names = image_names
+        .iter()
+        .map(|name| ImageName::parse(name))
+        .collect::<Result<Vec<_>>>()?;
+    let artifacts = py.allow_threads(|| {
+        // Pulls run on the blocking thread pool of tokio, so that the runtime does not need worker threads
+        let runtime = tokio::runtime::Builder::new_current_thread().build()?;
+        runtime.block_on(pull_all(image_names, concurrency, jobs))
+    })?;
+    Ok(artifacts.into_iter().map(ArtifactDir).collect())
+}
@@ -0,0 +1,44 @@
+use derive_more::From;
+use ommx::artifact::Blob;
+use pyo3::{exceptions::PyBufferError, ffi, prelude::*};
+use std::os::raw::c_int;
+
+/// Read-only blob exposed to Python via the buffer protocol without copying, e.g. `memoryview(blob)`
+#[pyclass(frozen)]
+#[pyo3(module = "ommx._ommx_rust", name = "Blob")]
+#[derive(From)]
+pub struct PyBlob(Blob);
+
+#[pymethods]
+impl PyBlob {
+    pub fn __len__(&self) -> usize {
+        self.0.len()
+    }
+
+    /// # Safety
+    ///
+    /// `view` must be a valid pointer given by the Python interpreter.
+    /// The exported memory is kept alive by the reference to `slf` stored in `view.obj`.
+    pub unsafe fn __getbuffer__(
+        slf: Bound<'_, Self>,
+        view: *mut ffi::Py_buffer,
+        flags: c_int,
+    ) -> PyResult<()> {
+        if (flags & ffi::PyBUF_WRITABLE) == ffi::PyBUF_WRITABLE {
+            return Err(PyBufferError::new_err("Blob is read-only"));
+        }
+        let bytes: &[u8] = &slf.get().0;
+        let ret = ffi::PyBuffer_FillInfo(
+            view,
+            slf.as_ptr(),
+            bytes.as_ptr() as *mut _,
+            bytes.len() as ffi::Py_ssize_t,
+            1,
+            flags,
+        );
+        if ret == -1 {
+            return Err(PyErr::fetch(slf.py()));
+        }
+        Ok(())
+    }
+}
@@ -36,12 +36,15 @@ impl ArtifactArchiveBuilder {
 
     pub fn add_layer(
         &mut self,
+        py: Python<'_>,
         media_type: &str,
         blob: Bound<PyBytes>,
         annotations: HashMap<String, String>,
     ) -> Result<PyDescriptor> {
         if let Some(builder) = self.0.as_mut() {
-            let desc = builder.add_layer(media_type.into(), blob.as_bytes(), annotations)?;
+            let blob = blob.as_bytes();
+            let desc =
+                py.allow_threads(|| builder.add_layer(media_type.into(), blob, annotations))?;
             Ok(PyDescriptor::from(desc))
         } else {
             bail!("Already built artifact")
@@ -57,9 +60,9 @@ impl ArtifactArchiveBuilder {
         }
     }
 
-    pub fn build(&mut self) -> Result<ArtifactArchive> {
+    pub fn build(&mut self, py: Python<'_>) -> Result<ArtifactArchive> {
         if let Some(builder) = self.0.take() {
-            let artifact = builder.build()?;
+            let artifact = py.allow_threads(|| builder.build())?;
             Ok(ArtifactArchive::from(artifact))
         } else {
             bail!("Already built artifact")
@@ -88,12 +91,15 @@ impl ArtifactDirBuilder {
 
     pub fn add_layer(
         &mut self,
+        py: Python<'_>,
         media_type: &str,
         blob: Bound<PyBytes>,
         annotations: HashMap<String, String>,
     ) -> Result<PyDescriptor> {
         if let Some(builder) = self.0.as_mut() {
-            let desc = builder.add_layer(media_type.into(), blob.as_bytes(), annotations)?;
+            let blob = blob.as_bytes();
+            let desc =
+                py.allow_threads(|| builder.add_layer(media_type.into(), blob, annotations))?;
             Ok(PyDescriptor::from(desc))
         } else {
             bail!("Already built artifact")
@@ -109,9 +115,9 @@ impl ArtifactDirBuilder {
         }
     }
 
-    pub fn build(&mut self) -> Result<ArtifactDir> {
+    pub fn build(&mut self, py: Python<'_>) -> Result<ArtifactDir> {
         if let Some(builder) = self.0.take() {
-            let artifact = builder.build()?;
+            let artifact = py.allow_threads(|| builder.build())?;
             Ok(ArtifactDir::from(artifact))
         } else {
             bail!("Already built artifact")
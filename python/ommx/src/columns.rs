@@ -0,0 +1,64 @@
+use anyhow::Result;
+use numpy::IntoPyArray;
+use ommx::{v1::Solution, Message, SolutionColumns};
+use pyo3::{
+    prelude::*,
+    types::{PyBytes, PyDict},
+};
+use std::collections::HashSet;
+
+/// NumPy arrays taking over the buffers of the numeric columns of [SolutionColumns] without copying,
+/// and lists of the other columns
+pub fn solution_columns_dict(py: Python<'_>, columns: SolutionColumns) -> PyResult<Bound<PyDict>> {
+    let out = PyDict::new_bound(py);
+    out.set_item("variable_ids", columns.variable_ids.into_pyarray_bound(py))?;
+    out.set_item("kinds", columns.kinds.into_pyarray_bound(py))?;
+    out.set_item("lower", columns.lower.into_pyarray_bound(py))?;
+    out.set_item("upper", columns.upper.into_pyarray_bound(py))?;
+    out.set_item("values", columns.values.into_pyarray_bound(py))?;
+    out.set_item("names", columns.names)?;
+    out.set_item("subscripts", columns.subscripts)?;
+    out.set_item("descriptions", columns.descriptions)?;
+    out.set_item("parameters", columns.parameters)?;
+    out.set_item(
+        "constraint_ids",
+        columns.constraint_ids.into_pyarray_bound(py),
+    )?;
+    out.set_item("equalities", columns.equalities.into_pyarray_bound(py))?;
+    out.set_item(
+        "constraint_values",
+        columns.constraint_values.into_pyarray_bound(py),
+    )?;
+    out.set_item(
+        "constraint_feasible",
+        columns.constraint_feasible.into_pyarray_bound(py),
+    )?;
+    out.set_item(
+        "used_decision_variable_ids",
+        columns
+            .used_decision_variable_ids
+            .into_iter()
+            .map(|ids| ids.into_iter().collect::<HashSet<u64>>())
+            .collect::<Vec<_>>(),
+    )?;
+    out.set_item("constraint_names", columns.constraint_names)?;
+    out.set_item("constraint_descriptions", columns.constraint_descriptions)?;
+    out.set_item("constraint_parameters", columns.constraint_parameters)?;
+    Ok(out)
+}
+
+/// Decision variables and evaluated constraints of the serialized solution as columns, see `ommx::SolutionColumns`
+///
+/// The columns are built without the GIL.
+#[pyfunction]
+pub fn solution_columns<'py>(
+    py: Python<'py>,
+    solution: &Bound<'py, PyBytes>,
+    atol: f64,
+) -> Result<Bound<'py, PyDict>> {
+    let solution = solution.as_bytes();
+    let columns = py.allow_threads(|| -> Result<_> {
+        Ok(SolutionColumns::new(&Solution::decode(solution)?, atol))
+    })?;
+    Ok(solution_columns_dict(py, columns)?)
+}
@@ -0,0 +1,39 @@
+use anyhow::{ensure, Result};
+use ommx::artifact;
+use pyo3::{buffer::PyBuffer, prelude::*, types::PyBytes};
+
+/// Compress the serialized instance by zstd for the `application/org.ommx.v1.instance+zstd` layer
+///
+/// The bytes are compressed as they are without being decoded as an instance.
+#[pyfunction]
+pub fn encode_instance_zstd<'py>(
+    py: Python<'py>,
+    instance: &Bound<'py, PyBytes>,
+    level: i32,
+) -> Result<Bound<'py, PyBytes>> {
+    let instance = instance.as_bytes();
+    let blob = py.allow_threads(|| artifact::compress_zstd(instance, level))?;
+    Ok(PyBytes::new_bound(py, &blob))
+}
+
+/// Decompress the `application/org.ommx.v1.instance+zstd` layer into the serialized instance
+///
+/// `blob` may be any bytes-like object, e.g. the memory-mapped blob returned by `Artifact.get_blob`.
+/// The GIL is released while decompressing if the buffer is read-only,
+/// since a writable buffer, e.g. `bytearray`, may be modified by other Python threads.
+#[pyfunction]
+pub fn decode_instance_zstd<'py>(
+    py: Python<'py>,
+    blob: PyBuffer<u8>,
+) -> Result<Bound<'py, PyBytes>> {
+    ensure!(blob.is_c_contiguous(), "Blob must be contiguous");
+    // SAFETY: The buffer is contiguous, and kept alive while `blob` is alive
+    let bytes =
+        unsafe { std::slice::from_raw_parts(blob.buf_ptr() as *const u8, blob.len_bytes()) };
+    let instance = if blob.readonly() {
+        py.allow_threads(|| artifact::decompress_zstd(bytes))?
+    } else {
+        artifact::decompress_zstd(bytes)?
+    };
+    Ok(PyBytes::new_bound(py, &instance))
+}
@@ -1,21 +1,28 @@
 use anyhow::Result;
 use ommx::{
     v1::{Constraint, Function, Instance, Linear, Polynomial, Quadratic, State},
-    Evaluate, Message,
+    CompiledInstance, Evaluate, Message, PartialEvaluate,
 };
 use pyo3::{prelude::*, types::PyBytes};
 use std::collections::BTreeSet;
 
+// The functions in this module decode and evaluate without the GIL.
+// This is safe since `bytes` objects are immutable, and are kept alive by the arguments.
+
 macro_rules! define_evaluate_function {
     ($evaluated:ty, $name:ident) => {
         #[pyfunction]
         pub fn $name<'py>(
+            py: Python<'py>,
             function: &Bound<'py, PyBytes>,
             state: &Bound<'py, PyBytes>,
         ) -> Result<(f64, BTreeSet<u64>)> {
-            let state = State::decode(state.as_bytes())?;
-            let function = <$evaluated>::decode(function.as_bytes())?;
-            function.evaluate(&state)
+            let (function, state) = (function.as_bytes(), state.as_bytes());
+            py.allow_threads(|| {
+                let state = State::decode(state)?;
+                let function = <$evaluated>::decode(function)?;
+                function.evaluate(&state)
+            })
         }
     };
 }
@@ -33,10 +40,14 @@ macro_rules! define_evaluate_object {
             function: &Bound<'py, PyBytes>,
             state: &Bound<'py, PyBytes>,
         ) -> Result<(Bound<'py, PyBytes>, BTreeSet<u64>)> {
-            let state = State::decode(state.as_bytes())?;
-            let function = <$evaluated>::decode(function.as_bytes())?;
-            let (evaluated, used_ids) = function.evaluate(&state)?;
-            Ok((PyBytes::new_bound(py, &evaluated.encode_to_vec()), used_ids))
+            let (function, state) = (function.as_bytes(), state.as_bytes());
+            let (evaluated, used_ids) = py.allow_threads(|| -> Result<_> {
+                let state = State::decode(state)?;
+                let function = <$evaluated>::decode(function)?;
+                let (evaluated, used_ids) = function.evaluate(&state)?;
+                Ok((evaluated.encode_to_vec(), used_ids))
+            })?;
+            Ok((PyBytes::new_bound(py, &evaluated), used_ids))
         }
     };
 }
@@ -44,8 +55,56 @@ macro_rules! define_evaluate_object {
 define_evaluate_object!(Constraint, evaluate_constraint);
 define_evaluate_object!(Instance, evaluate_instance);
 
+/// Evaluate many states against one instance in parallel, decoding the instance only once
+#[pyfunction]
+pub fn evaluate_instance_samples<'py>(
+    py: Python<'py>,
+    instance: &Bound<'py, PyBytes>,
+    states: Vec<Bound<'py, PyBytes>>,
+) -> Result<Vec<Bound<'py, PyBytes>>> {
+    let instance = instance.as_bytes();
+    let states: Vec<&[u8]> = states.iter().map(|state| state.as_bytes()).collect();
+    let solutions = py.allow_threads(|| -> Result<Vec<Vec<u8>>> {
+        let instance = Instance::decode_parallel(instance)?;
+        let compiled = CompiledInstance::new(&instance)?;
+        let states = states
+            .iter()
+            .map(|state| Ok(State::decode(*state)?))
+            .collect::<Result<Vec<_>>>()?;
+        // Decision variables are written from the compiled instance into each serialized solution without cloning
+        Ok(compiled
+            .evaluate_samples_shared(&states)?
+            .iter()
+            .map(|solution| compiled.encode_shared_solution(solution))
+            .collect())
+    })?;
+    Ok(solutions
+        .iter()
+        .map(|solution| PyBytes::new_bound(py, solution))
+        .collect())
+}
+
+/// Substitute the partial state into the instance, and return the reduced instance, see `ommx::PartialEvaluate`
+#[pyfunction]
+pub fn partial_evaluate_instance<'py>(
+    py: Python<'py>,
+    instance: &Bound<'py, PyBytes>,
+    state: &Bound<'py, PyBytes>,
+) -> Result<Bound<'py, PyBytes>> {
+    let (instance, state) = (instance.as_bytes(), state.as_bytes());
+    let reduced = py.allow_threads(|| -> Result<_> {
+        let instance = Instance::decode_parallel(instance)?;
+        let state = State::decode(state)?;
+        Ok(instance.partial_evaluate(&state)?.encode_to_vec())
+    })?;
+    Ok(PyBytes::new_bound(py, &reduced))
+}
+
 #[pyfunction]
-pub fn used_decision_variable_ids(function: &Bound<PyBytes>) -> BTreeSet<u64> {
-    let function = Function::decode(function.as_bytes()).unwrap();
-    function.used_decision_variable_ids()
+pub fn used_decision_variable_ids(py: Python<'_>, function: &Bound<PyBytes>) -> BTreeSet<u64> {
+    let function = function.as_bytes();
+    py.allow_threads(|| {
+        let function = Function::decode(function).unwrap();
+        function.used_decision_variable_ids()
+    })
 }
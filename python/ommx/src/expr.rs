@@ -0,0 +1,372 @@
+use anyhow::{ensure, Result};
+use numpy::PyReadonlyArray1;
+use ommx::{
+    v1::{self, Monomial},
+    Message,
+};
+use pyo3::{prelude::*, types::PyBytes};
+use std::collections::{BTreeMap, HashMap};
+
+/// Linear function accumulated in a hash map of decision variable ID to coefficient
+///
+/// Terms are serialized into `ommx.v1.Linear` sorted by ID only when `to_bytes` is called.
+#[pyclass]
+#[pyo3(module = "ommx._ommx_rust", name = "Linear")]
+#[derive(Debug, Clone, PartialEq, Default)]
+pub struct PyLinear {
+    terms: HashMap<u64, f64>,
+    constant: f64,
+}
+
+impl PyLinear {
+    fn to_v1(&self) -> v1::Linear {
+        let mut terms: Vec<(u64, f64)> = self.terms.iter().map(|(id, c)| (*id, *c)).collect();
+        terms.sort_unstable_by_key(|(id, _)| *id);
+        v1::Linear::new(terms.into_iter(), self.constant)
+    }
+}
+
+#[pymethods]
+impl PyLinear {
+    #[new]
+    #[pyo3(signature = (terms, constant = 0.0))]
+    pub fn new(terms: HashMap<u64, f64>, constant: f64) -> Self {
+        Self { terms, constant }
+    }
+
+    /// Create from arrays of IDs and coefficients. Coefficients of the same ID are summed up.
+    #[staticmethod]
+    #[pyo3(signature = (ids, coefficients, constant = 0.0))]
+    pub fn from_arrays(
+        ids: PyReadonlyArray1<u64>,
+        coefficients: PyReadonlyArray1<f64>,
+        constant: f64,
+    ) -> Result<Self> {
+        let ids = ids.as_array();
+        let coefficients = coefficients.as_array();
+        ensure!(
+            ids.len() == coefficients.len(),
+            "Lengths of ids ({}) and coefficients ({}) are different",
+            ids.len(),
+            coefficients.len()
+        );
+        let mut out = Self {
+            terms: HashMap::with_capacity(ids.len()),
+            constant,
+        };
+        for (id, c) in ids.iter().zip(coefficients.iter()) {
+            out.add_term(*id, *c);
+        }
+        Ok(out)
+    }
+
+    #[staticmethod]
+    pub fn decode(bytes: &Bound<PyBytes>) -> Result<Self> {
+        let linear = v1::Linear::decode(bytes.as_bytes())?;
+        let mut out = Self {
+            terms: HashMap::with_capacity(linear.terms.len()),
+            constant: linear.constant,
+        };
+        for term in linear.terms {
+            out.add_term(term.id, term.coefficient);
+        }
+        Ok(out)
+    }
+
+    pub fn to_bytes<'py>(&self, py: Python<'py>) -> Bound<'py, PyBytes> {
+        PyBytes::new_bound(py, &self.to_v1().encode_to_vec())
+    }
+
+    /// Terms sorted by ID, converted into `dict` in this order
+    #[getter]
+    pub fn terms(&self) -> BTreeMap<u64, f64> {
+        self.terms.iter().map(|(id, c)| (*id, *c)).collect()
+    }
+
+    #[getter]
+    pub fn constant(&self) -> f64 {
+        self.constant
+    }
+
+    pub fn copy(&self) -> Self {
+        self.clone()
+    }
+
+    pub fn add_term(&mut self, id: u64, coefficient: f64) {
+        *self.terms.entry(id).or_insert(0.0) += coefficient;
+    }
+
+    pub fn add_constant(&mut self, constant: f64) {
+        self.constant += constant;
+    }
+
+    /// Add `other` in-place
+    pub fn add_linear(&mut self, other: &Self) {
+        self.terms.reserve(other.terms.len());
+        for (id, c) in &other.terms {
+            self.add_term(*id, *c);
+        }
+        self.constant += other.constant;
+    }
+
+    /// Multiply by a scalar in-place
+    pub fn scale(&mut self, factor: f64) {
+        for c in self.terms.values_mut() {
+            *c *= factor;
+        }
+        self.constant *= factor;
+    }
+
+    /// Product of two linear functions
+    pub fn mul_linear(&self, other: &Self) -> PyQuadratic {
+        let mut out = PyQuadratic::default();
+        for (i, a) in &self.terms {
+            for (j, b) in &other.terms {
+                out.add_term(*i, *j, a * b);
+            }
+        }
+        // Skip the linear terms of zero constants not to emit explicit zeros
+        if other.constant != 0.0 {
+            for (i, a) in &self.terms {
+                out.linear.add_term(*i, a * other.constant);
+            }
+        }
+        if self.constant != 0.0 {
+            for (j, b) in &other.terms {
+                out.linear.add_term(*j, b * self.constant);
+            }
+        }
+        out.linear.constant = self.constant * other.constant;
+        out
+    }
+
+    pub fn __len__(&self) -> usize {
+        self.terms.len()
+    }
+}
+
+/// Quadratic function accumulated in a hash map of `(row, column)` IDs to value, with its linear part
+///
+/// Entries are serialized into `ommx.v1.Quadratic` sorted by `(row, column)` only when `to_bytes` is called.
+#[pyclass]
+#[pyo3(module = "ommx._ommx_rust", name = "Quadratic")]
+#[derive(Debug, Clone, PartialEq, Default)]
+pub struct PyQuadratic {
+    terms: HashMap<(u64, u64), f64>,
+    linear: PyLinear,
+}
+
+impl PyQuadratic {
+    fn to_v1(&self) -> v1::Quadratic {
+        let mut terms: Vec<((u64, u64), f64)> =
+            self.terms.iter().map(|(ij, v)| (*ij, *v)).collect();
+        terms.sort_unstable_by_key(|(ij, _)| *ij);
+        let mut out = v1::Quadratic {
+            rows: Vec::with_capacity(terms.len()),
+            columns: Vec::with_capacity(terms.len()),
+            values: Vec::with_capacity(terms.len()),
+            linear: None,
+        };
+        for ((i, j), v) in terms {
+            out.rows.push(i);
+            out.columns.push(j);
+            out.values.push(v);
+        }
+        if !self.linear.terms.is_empty() || self.linear.constant != 0.0 {
+            out.linear = Some(self.linear.to_v1());
+        }
+        out
+    }
+}
+
+#[pymethods]
+impl PyQuadratic {
+    #[new]
+    #[pyo3(signature = (rows, columns, values, linear = None))]
+    pub fn new(
+        rows: Vec<u64>,
+        columns: Vec<u64>,
+        values: Vec<f64>,
+        linear: Option<PyLinear>,
+    ) -> Result<Self> {
+        ensure!(
+            rows.len() == columns.len() && rows.len() == values.len(),
+            "Lengths of rows ({}), columns ({}) and values ({}) are different",
+            rows.len(),
+            columns.len(),
+            values.len()
+        );
+        let mut out = Self {
+            terms: HashMap::with_capacity(rows.len()),
+            linear: linear.unwrap_or_default(),
+        };
+        for ((i, j), v) in rows.into_iter().zip(columns).zip(values) {
+            out.add_term(i, j, v);
+        }
+        Ok(out)
+    }
+
+    /// Create from arrays of rows, columns and values. Values of the same `(row, column)` are summed up.
+    #[staticmethod]
+    #[pyo3(signature = (rows, columns, values, linear = None))]
+    pub fn from_arrays(
+        rows: PyReadonlyArray1<u64>,
+        columns: PyReadonlyArray1<u64>,
+        values: PyReadonlyArray1<f64>,
+        linear: Option<PyLinear>,
+    ) -> Result<Self> {
+        let (rows, columns, values) = (rows.as_array(), columns.as_array(), values.as_array());
+        ensure!(
+            rows.len() == columns.len() && rows.len() == values.len(),
+            "Lengths of rows ({}), columns ({}) and values ({}) are different",
+            rows.len(),
+            columns.len(),
+            values.len()
+        );
+        let mut out = Self {
+            terms: HashMap::with_capacity(rows.len()),
+            linear: linear.unwrap_or_default(),
+        };
+        for ((i, j), v) in rows.iter().zip(columns.iter()).zip(values.iter()) {
+            out.add_term(*i, *j, *v);
+        }
+        Ok(out)
+    }
+
+    pub fn to_bytes<'py>(&self, py: Python<'py>) -> Bound<'py, PyBytes> {
+        PyBytes::new_bound(py, &self.to_v1().encode_to_vec())
+    }
+
+    #[getter]
+    pub fn linear(&self) -> PyLinear {
+        self.linear.clone()
+    }
+
+    pub fn copy(&self) -> Self {
+        self.clone()
+    }
+
+    pub fn add_term(&mut self, row: u64, column: u64, value: f64) {
+        *self.terms.entry((row, column)).or_insert(0.0) += value;
+    }
+
+    /// Add `other` into the linear part in-place
+    pub fn add_linear(&mut self, other: &PyLinear) {
+        self.linear.add_linear(other);
+    }
+
+    pub fn add_constant(&mut self, constant: f64) {
+        self.linear.constant += constant;
+    }
+
+    /// Add `other` in-place
+    pub fn add_quadratic(&mut self, other: &Self) {
+        self.terms.reserve(other.terms.len());
+        for ((i, j), v) in &other.terms {
+            self.add_term(*i, *j, *v);
+        }
+        self.linear.add_linear(&other.linear);
+    }
+
+    /// Multiply by a scalar in-place
+    pub fn scale(&mut self, factor: f64) {
+        for v in self.terms.values_mut() {
+            *v *= factor;
+        }
+        self.linear.scale(factor);
+    }
+
+    pub fn __len__(&self) -> usize {
+        self.terms.len()
+    }
+}
+
+/// Polynomial accumulated in a hash map of sorted IDs of monomial to coefficient
+///
+/// Monomials are serialized into `ommx.v1.Polynomial` sorted by degree, then IDs only when `to_bytes` is called.
+#[pyclass]
+#[pyo3(module = "ommx._ommx_rust", name = "Polynomial")]
+#[derive(Debug, Clone, PartialEq, Default)]
+pub struct PyPolynomial {
+    terms: HashMap<Vec<u64>, f64>,
+}
+
+impl PyPolynomial {
+    fn to_v1(&self) -> v1::Polynomial {
+        let mut terms: Vec<(&Vec<u64>, f64)> =
+            self.terms.iter().map(|(ids, c)| (ids, *c)).collect();
+        terms.sort_unstable_by(|(a, _), (b, _)| (a.len(), a).cmp(&(b.len(), b)));
+        v1::Polynomial {
+            terms: terms
+                .into_iter()
+                .map(|(ids, coefficient)| Monomial {
+                    ids: ids.clone(),
+                    coefficient,
+                })
+                .collect(),
+        }
+    }
+}
+
+#[pymethods]
+impl PyPolynomial {
+    #[new]
+    pub fn new(terms: Vec<(Vec<u64>, f64)>) -> Self {
+        let mut out = Self {
+            terms: HashMap::with_capacity(terms.len()),
+        };
+        for (ids, c) in terms {
+            out.add_term(ids, c);
+        }
+        out
+    }
+
+    pub fn to_bytes<'py>(&self, py: Python<'py>) -> Bound<'py, PyBytes> {
+        PyBytes::new_bound(py, &self.to_v1().encode_to_vec())
+    }
+
+    pub fn copy(&self) -> Self {
+        self.clone()
+    }
+
+    /// Add a monomial. The order of `ids` is ignored since the product is commutative.
+    pub fn add_term(&mut self, mut ids: Vec<u64>, coefficient: f64) {
+        ids.sort_unstable();
+        *self.terms.entry(ids).or_insert(0.0) += coefficient;
+    }
+
+    pub fn add_linear(&mut self, other: &PyLinear) {
+        for (id, c) in &other.terms {
+            self.add_term(vec![*id], *c);
+        }
+        if other.constant != 0.0 {
+            self.add_term(Vec::new(), other.constant);
+        }
+    }
+
+    pub fn add_quadratic(&mut self, other: &PyQuadratic) {
+        for ((i, j), v) in &other.terms {
+            self.add_term(vec![*i, *j], *v);
+        }
+        self.add_linear(&other.linear);
+    }
+
+    /// Add `other` in-place
+    pub fn add_polynomial(&mut self, other: &Self) {
+        self.terms.reserve(other.terms.len());
+        for (ids, c) in &other.terms {
+            *self.terms.entry(ids.clone()).or_insert(0.0) += c;
+        }
+    }
+
+    /// Multiply by a scalar in-place
+    pub fn scale(&mut self, factor: f64) {
+        for c in self.terms.values_mut() {
+            *c *= factor;
+        }
+    }
+
+    pub fn __len__(&self) -> usize {
+        self.terms.len()
+    }
+}
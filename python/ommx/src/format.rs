@@ -0,0 +1,38 @@
+use anyhow::Result;
+use ommx::{
+    format::{lp, mps},
+    v1::Instance,
+    Message,
+};
+use pyo3::{prelude::*, types::PyBytes};
+use std::path::PathBuf;
+
+/// Write the serialized instance to an MPS file, see `ommx::format::mps`
+#[pyfunction]
+pub fn write_mps(py: Python<'_>, instance: &Bound<PyBytes>, path: PathBuf) -> Result<()> {
+    let instance = instance.as_bytes();
+    py.allow_threads(|| mps::write_file(&Instance::decode_parallel(instance)?, &path))
+}
+
+/// Read an MPS file into the serialized instance
+#[pyfunction]
+pub fn read_mps(py: Python<'_>, path: PathBuf) -> Result<Bound<PyBytes>> {
+    let instance =
+        py.allow_threads(|| -> Result<_> { Ok(mps::read_file(&path)?.encode_to_vec()) })?;
+    Ok(PyBytes::new_bound(py, &instance))
+}
+
+/// Write the serialized instance to a CPLEX LP file, see `ommx::format::lp`
+#[pyfunction]
+pub fn write_lp(py: Python<'_>, instance: &Bound<PyBytes>, path: PathBuf) -> Result<()> {
+    let instance = instance.as_bytes();
+    py.allow_threads(|| lp::write_file(&Instance::decode_parallel(instance)?, &path))
+}
+
+/// Read a CPLEX LP file into the serialized instance
+#[pyfunction]
+pub fn read_lp(py: Python<'_>, path: PathBuf) -> Result<Bound<PyBytes>> {
+    let instance =
+        py.allow_threads(|| -> Result<_> { Ok(lp::read_file(&path)?.encode_to_vec()) })?;
+    Ok(PyBytes::new_bound(py, &instance))
+}
@@ -0,0 +1,244 @@
+use crate::solution_columns_dict;
+use anyhow::{ensure, Result};
+use numpy::{prelude::*, PyArray1, PyReadonlyArray1, PyReadonlyArray2};
+use ommx::{
+    v1::{self, State},
+    CompiledInstance, Message, SolutionColumns,
+};
+use pyo3::{
+    prelude::*,
+    types::{PyBytes, PyDict},
+};
+use std::{collections::HashMap, sync::Arc};
+
+/// State given from Python, either a dict of ID to value or a dense array in the order of `Instance.variable_ids`
+#[derive(FromPyObject)]
+pub enum StateInput<'py> {
+    Dict(HashMap<u64, f64>),
+    Dense(PyReadonlyArray1<'py, f64>),
+}
+
+/// Decoded instance kept alive in Python with its compiled evaluator
+///
+/// Unlike the functions taking serialized messages, e.g. `evaluate_instance`,
+/// this decodes and compiles the instance only once, and states are given without serialization.
+#[pyclass]
+#[pyo3(module = "ommx._ommx_rust", name = "Instance")]
+pub struct PyInstance {
+    instance: v1::Instance,
+    /// Shared with the solutions, which refer its decision variables instead of cloning them
+    compiled: Arc<CompiledInstance>,
+}
+
+impl PyInstance {
+    /// Convert the input into [State]
+    ///
+    /// A dense array is stored as `State.entries` unless `dense_state` is set,
+    /// since the readers of serialized solutions may expect only `entries`.
+    /// If `dense_state` is set and the IDs are contiguous, it is stored as `State.dense` without building a map.
+    fn state(&self, state: StateInput, dense_state: bool) -> Result<State> {
+        match state {
+            StateInput::Dict(entries) => Ok(entries.into()),
+            StateInput::Dense(x) => {
+                let x = x.as_array();
+                let ids = self.compiled.variables().ids();
+                ensure!(
+                    x.len() == ids.len(),
+                    "Length of dense state ({}) must be the number of decision variables ({})",
+                    x.len(),
+                    ids.len()
+                );
+                // IDs are sorted, and usually contiguous
+                if let (true, Some(first), Some(last)) = (dense_state, ids.first(), ids.last()) {
+                    if last - first + 1 == ids.len() as u64 {
+                        return Ok(State::dense(*first, x.to_vec()));
+                    }
+                }
+                Ok(ids
+                    .iter()
+                    .cloned()
+                    .zip(x.iter().cloned())
+                    .collect::<HashMap<_, _>>()
+                    .into())
+            }
+        }
+    }
+}
+
+#[pymethods]
+impl PyInstance {
+    #[staticmethod]
+    pub fn from_bytes(py: Python<'_>, bytes: &Bound<PyBytes>) -> Result<Self> {
+        let bytes = bytes.as_bytes();
+        py.allow_threads(|| {
+            let instance = v1::Instance::decode_parallel(bytes)?;
+            let compiled = Arc::new(CompiledInstance::new(&instance)?);
+            Ok(Self { instance, compiled })
+        })
+    }
+
+    pub fn to_bytes<'py>(&self, py: Python<'py>) -> Bound<'py, PyBytes> {
+        PyBytes::new_bound(py, &self.instance.encode_to_vec())
+    }
+
+    /// Decision variable IDs in the order of dense states
+    #[getter]
+    pub fn variable_ids<'py>(&self, py: Python<'py>) -> Bound<'py, PyArray1<u64>> {
+        self.compiled
+            .variables()
+            .ids()
+            .to_vec()
+            .into_pyarray_bound(py)
+    }
+
+    /// Constraint IDs in the order of `constraint_values` of `evaluate_dense`
+    #[getter]
+    pub fn constraint_ids<'py>(&self, py: Python<'py>) -> Bound<'py, PyArray1<u64>> {
+        self.compiled
+            .constraint_ids()
+            .collect::<Vec<_>>()
+            .into_pyarray_bound(py)
+    }
+
+    /// Evaluate the state. See `dense_state` of `evaluate_samples` for the state stored in the solution.
+    #[pyo3(signature = (state, *, dense_state = false))]
+    pub fn evaluate(
+        &self,
+        py: Python<'_>,
+        state: StateInput,
+        dense_state: bool,
+    ) -> Result<PySolution> {
+        let state = self.state(state, dense_state)?;
+        let solution = py.allow_threads(|| self.compiled.evaluate_shared(&state))?;
+        Ok(PySolution::new(solution, &self.compiled))
+    }
+
+    /// Evaluate many states in parallel without the GIL
+    ///
+    /// A state given as a NumPy array is stored in the solution as `State.entries` by default.
+    /// If `dense_state` is `True`, it is stored as `State.dense` instead to avoid building the map,
+    /// and then `State.entries` of the serialized solution is empty.
+    /// `Solution.entries` returns the values in either form.
+    #[pyo3(signature = (states, *, dense_state = false))]
+    pub fn evaluate_samples(
+        &self,
+        py: Python<'_>,
+        states: Vec<StateInput>,
+        dense_state: bool,
+    ) -> Result<Vec<PySolution>> {
+        let states = states
+            .into_iter()
+            .map(|state| self.state(state, dense_state))
+            .collect::<Result<Vec<_>>>()?;
+        let solutions = py.allow_threads(|| self.compiled.evaluate_samples_shared(&states))?;
+        Ok(solutions
+            .into_iter()
+            .map(|solution| PySolution::new(solution, &self.compiled))
+            .collect())
+    }
+
+    /// Evaluate the rows of `num_samples x num_variables` matrix as dense states in parallel,
+    /// and return `objectives`, `feasible` and `constraint_values` (`num_samples x num_constraints`) as NumPy arrays
+    ///
+    /// The samples are copied before releasing the GIL, since NumPy arrays may be modified by other Python threads.
+    pub fn evaluate_dense<'py>(
+        &self,
+        py: Python<'py>,
+        samples: PyReadonlyArray2<'py, f64>,
+    ) -> Result<Bound<'py, PyDict>> {
+        let shape = samples.shape();
+        let (num_samples, n) = (shape[0], shape[1]);
+        ensure!(
+            n == self.compiled.variables().len(),
+            "Number of columns ({}) must be the number of decision variables ({})",
+            n,
+            self.compiled.variables().len()
+        );
+        let samples = match samples.as_slice() {
+            Ok(slice) => slice.to_vec(),
+            Err(_) => samples.as_array().iter().cloned().collect(),
+        };
+        let evaluated =
+            py.allow_threads(|| self.compiled.evaluate_dense_samples(&samples, num_samples));
+        let out = PyDict::new_bound(py);
+        out.set_item("objectives", evaluated.objectives.into_pyarray_bound(py))?;
+        out.set_item("feasible", evaluated.feasible.into_pyarray_bound(py))?;
+        out.set_item(
+            "constraint_values",
+            evaluated
+                .constraint_values
+                .into_pyarray_bound(py)
+                .reshape([num_samples, evaluated.num_constraints])?,
+        )?;
+        Ok(out)
+    }
+}
+
+/// Evaluated solution kept in Rust, which is serialized into `ommx.v1.Solution` only when `to_bytes` is called
+///
+/// The decision variables are not copied into each solution, but referred from the compiled instance,
+/// see `ommx::CompiledInstance::evaluate_samples_shared`.
+#[pyclass]
+#[pyo3(module = "ommx._ommx_rust", name = "Solution")]
+pub struct PySolution {
+    solution: v1::Solution,
+    compiled: Arc<CompiledInstance>,
+}
+
+impl PySolution {
+    fn new(solution: v1::Solution, compiled: &Arc<CompiledInstance>) -> Self {
+        Self {
+            solution,
+            compiled: compiled.clone(),
+        }
+    }
+}
+
+#[pymethods]
+impl PySolution {
+    pub fn to_bytes<'py>(&self, py: Python<'py>) -> Bound<'py, PyBytes> {
+        PyBytes::new_bound(py, &self.compiled.encode_shared_solution(&self.solution))
+    }
+
+    /// Decision variables and evaluated constraints as columns, see `ommx::SolutionColumns`
+    pub fn columns<'py>(&self, py: Python<'py>) -> PyResult<Bound<'py, PyDict>> {
+        let columns = py.allow_threads(|| {
+            SolutionColumns::with_decision_variables(
+                &self.solution,
+                self.compiled.decision_variables(),
+                self.compiled.atol(),
+            )
+        });
+        solution_columns_dict(py, columns)
+    }
+
+    #[getter]
+    pub fn objective(&self) -> f64 {
+        self.solution.objective
+    }
+
+    #[getter]
+    pub fn feasible(&self) -> bool {
+        self.solution.feasible
+    }
+
+    /// Values of the decision variables, merged from both `State.entries` and `State.dense`
+    #[getter]
+    pub fn entries(&self) -> HashMap<u64, f64> {
+        self.solution
+            .state
+            .as_ref()
+            .map(|state| state.iter().collect())
+            .unwrap_or_default()
+    }
+
+    /// Evaluated values of the constraints by ID
+    #[getter]
+    pub fn constraint_values(&self) -> HashMap<u64, f64> {
+        self.solution
+            .evaluated_constraints
+            .iter()
+            .map(|c| (c.id, c.evaluated_value))
+            .collect()
+    }
+}
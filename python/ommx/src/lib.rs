@@ -1,12 +1,26 @@
 mod artifact;
+mod blob;
 mod builder;
+mod columns;
+mod compression;
 mod descriptor;
 mod evaluate;
+mod expr;
+mod format;
+mod instance;
+mod matrix;
 
 pub use artifact::*;
+pub use blob::*;
 pub use builder::*;
+pub use columns::*;
+pub use compression::*;
 pub use descriptor::*;
 pub use evaluate::*;
+pub use expr::*;
+pub use format::*;
+pub use instance::*;
+pub use matrix::*;
 
 use pyo3::prelude::*;
 
@@ -19,12 +33,29 @@ fn _ommx_rust(_py: Python, m: &Bound<PyModule>) -> PyResult<()> {
     m.add_class::<ArtifactArchiveBuilder>()?;
     m.add_class::<ArtifactDirBuilder>()?;
     m.add_class::<PyDescriptor>()?;
+    m.add_class::<PyBlob>()?;
+    m.add_class::<PyLinear>()?;
+    m.add_class::<PyQuadratic>()?;
+    m.add_class::<PyPolynomial>()?;
+    m.add_class::<PyInstance>()?;
+    m.add_class::<PySolution>()?;
     m.add_function(wrap_pyfunction!(evaluate_function, m)?)?;
     m.add_function(wrap_pyfunction!(evaluate_linear, m)?)?;
     m.add_function(wrap_pyfunction!(evaluate_quadratic, m)?)?;
     m.add_function(wrap_pyfunction!(evaluate_polynomial, m)?)?;
     m.add_function(wrap_pyfunction!(evaluate_constraint, m)?)?;
     m.add_function(wrap_pyfunction!(evaluate_instance, m)?)?;
+    m.add_function(wrap_pyfunction!(evaluate_instance_samples, m)?)?;
+    m.add_function(wrap_pyfunction!(partial_evaluate_instance, m)?)?;
     m.add_function(wrap_pyfunction!(used_decision_variable_ids, m)?)?;
+    m.add_function(wrap_pyfunction!(encode_instance_zstd, m)?)?;
+    m.add_function(wrap_pyfunction!(decode_instance_zstd, m)?)?;
+    m.add_function(wrap_pyfunction!(linear_constraint_matrix, m)?)?;
+    m.add_function(wrap_pyfunction!(solution_columns, m)?)?;
+    m.add_function(wrap_pyfunction!(write_mps, m)?)?;
+    m.add_function(wrap_pyfunction!(read_mps, m)?)?;
+    m.add_function(wrap_pyfunction!(write_lp, m)?)?;
+    m.add_function(wrap_pyfunction!(read_lp, m)?)?;
+    m.add_function(wrap_pyfunction!(pull_artifacts, m)?)?;
     Ok(())
 }
@@ -0,0 +1,37 @@
+use anyhow::Result;
+use numpy::IntoPyArray;
+use ommx::{v1::Instance, LinearConstraintMatrix};
+use pyo3::{
+    prelude::*,
+    types::{PyBytes, PyDict},
+};
+
+/// Export the linear constraints of the serialized instance in CSR format as NumPy arrays, see `ommx::LinearConstraintMatrix`
+///
+/// The arrays take over the buffers built in Rust without copying. The matrix is built without the GIL.
+#[pyfunction]
+pub fn linear_constraint_matrix<'py>(
+    py: Python<'py>,
+    instance: &Bound<'py, PyBytes>,
+) -> Result<Bound<'py, PyDict>> {
+    let instance = instance.as_bytes();
+    let matrix =
+        py.allow_threads(|| LinearConstraintMatrix::new(&Instance::decode_parallel(instance)?))?;
+    let out = PyDict::new_bound(py);
+    out.set_item("variable_ids", matrix.variable_ids.into_pyarray_bound(py))?;
+    out.set_item("lower", matrix.lower.into_pyarray_bound(py))?;
+    out.set_item("upper", matrix.upper.into_pyarray_bound(py))?;
+    out.set_item("kinds", matrix.kinds.into_pyarray_bound(py))?;
+    out.set_item("objective", matrix.objective.into_pyarray_bound(py))?;
+    out.set_item("objective_constant", matrix.objective_constant)?;
+    out.set_item(
+        "constraint_ids",
+        matrix.constraint_ids.into_pyarray_bound(py),
+    )?;
+    out.set_item("row_offsets", matrix.row_offsets.into_pyarray_bound(py))?;
+    out.set_item("columns", matrix.columns.into_pyarray_bound(py))?;
+    out.set_item("values", matrix.values.into_pyarray_bound(py))?;
+    out.set_item("rhs", matrix.rhs.into_pyarray_bound(py))?;
+    out.set_item("equalities", matrix.equalities.into_pyarray_bound(py))?;
+    Ok(out)
+}
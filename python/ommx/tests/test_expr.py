@@ -0,0 +1,113 @@
+import numpy
+
+from ommx.v1 import Linear, Quadratic, Polynomial, DecisionVariable
+
+
+def test_linear_sum():
+    x = [DecisionVariable.binary(i) for i in range(3)]
+    f = Linear.sum([1, x[1], 2 * x[2], Linear(terms={1: 3}, constant=4)])
+    assert f.equals_to(Linear(terms={1: 4, 2: 2}, constant=5))
+    assert f.equals_to(sum([1, x[1], 2 * x[2], Linear(terms={1: 3}, constant=4)]))
+
+    assert Linear.sum([]).equals_to(Linear(terms={}))
+    assert Linear.sum(x).terms == {0: 1.0, 1: 1.0, 2: 1.0}
+
+
+def test_linear_terms():
+    f = Linear(terms={3: 1, 1: 2, 2: 3}, constant=4)
+    assert list(f.terms.items()) == [(1, 2.0), (2, 3.0), (3, 1.0)]
+    assert f.constant == 4.0
+
+
+def test_linear_in_place():
+    f = Linear(terms={1: 2}, constant=1)
+    g = f
+    g += DecisionVariable.binary(2)
+    assert f.terms == {1: 2.0, 2: 1.0}
+
+    # `+` creates a new object without modifying the operands
+    h = f + 1
+    assert f.constant == 1.0
+    assert h.constant == 2.0
+
+    # Adding itself doubles the terms
+    f += f
+    assert f.equals_to(Linear(terms={1: 4, 2: 2}, constant=2))
+
+
+def test_linear_from_arrays():
+    f = Linear.from_arrays(numpy.array([1, 2, 1]), numpy.array([1.0, 2.0, 3.0]), 5)
+    assert f.equals_to(Linear(terms={1: 4, 2: 2}, constant=5))
+
+    # Array-like inputs are converted
+    g = Linear.from_arrays([2, 1], [2, 4], constant=5)
+    assert g.equals_to(f)
+
+
+def test_linear_raw():
+    f = Linear(terms={2: 3, 1: 2}, constant=1)
+    raw = f.raw
+    assert [(t.id, t.coefficient) for t in raw.terms] == [(1, 2.0), (2, 3.0)]
+    assert raw.constant == 1.0
+
+    # The message is a copy of the terms
+    raw.constant = 10
+    assert f.constant == 1.0
+
+
+def test_quadratic():
+    x1 = DecisionVariable.binary(1)
+    x2 = DecisionVariable.binary(2)
+    q = (x1 + 1) * (x2 + 2)
+    assert isinstance(q, Quadratic)
+    raw = q.raw
+    assert (list(raw.rows), list(raw.columns), list(raw.values)) == ([1], [2], [1.0])
+    assert [(t.id, t.coefficient) for t in raw.linear.terms] == [(1, 2.0), (2, 1.0)]
+    assert raw.linear.constant == 2.0
+
+    # Adding a linear function only changes the linear part
+    q += x1
+    assert list(q.raw.values) == [1.0]
+    assert [(t.id, t.coefficient) for t in q.raw.linear.terms] == [(1, 3.0), (2, 1.0)]
+
+    q += q
+    assert list(q.raw.values) == [2.0]
+    assert q.raw.linear.constant == 4.0
+
+
+def test_quadratic_from_arrays():
+    q = Quadratic.from_arrays(
+        numpy.array([2, 1, 1]), numpy.array([1, 2, 2]), numpy.array([3.0, 1.0, 2.0])
+    )
+    raw = q.raw
+    # Entries of the same `(row, column)` are summed up, and sorted by `(row, column)`
+    assert (list(raw.rows), list(raw.columns), list(raw.values)) == (
+        [1, 2],
+        [2, 1],
+        [3.0, 3.0],
+    )
+    assert not raw.HasField("linear")
+
+    with_linear = Quadratic.from_arrays([1], [1], [1], linear=Linear(terms={3: 1}))
+    assert [(t.id, t.coefficient) for t in with_linear.raw.linear.terms] == [(3, 1.0)]
+
+
+def test_polynomial():
+    x = [DecisionVariable.binary(i) for i in range(4)]
+    p = Polynomial(coefficients=[([2, 1], 1), ([3, 1, 2], 2)])
+    p += x[1] * x[2] + x[3] + 1
+    assert [(list(m.ids), m.coefficient) for m in p.raw.terms] == [
+        ([], 1.0),
+        ([3], 1.0),
+        ([1, 2], 2.0),
+        ([1, 2, 3], 2.0),
+    ]
+
+    # `+` creates a new object
+    q = p + x[0]
+    assert len(p.raw.terms) == 4
+    assert len(q.raw.terms) == 5
+
+    p += p
+    assert [m.coefficient for m in p.raw.terms] == [2.0, 2.0, 4.0, 4.0]
+    assert [m.coefficient for m in (-p).raw.terms] == [-2.0, -2.0, -4.0, -4.0]
@@ -0,0 +1,45 @@
+from pandas.testing import assert_frame_equal
+
+from ommx.v1 import Instance, DecisionVariable, State, _decision_variables
+
+
+def test_decision_variables_frame():
+    x = [DecisionVariable.binary(i) for i in range(2)]
+    y = DecisionVariable.integer(2, lower=-1, upper=3, parameters={"t": "0"})
+    instance = Instance.from_components(
+        decision_variables=[*x, y],
+        objective=x[0] + x[1] + y,
+        constraints=[x[0] + y <= 2],
+        sense=Instance.MINIMIZE,
+    )
+    solution = instance.evaluate(State(entries={0: 1, 1: 0, 2: 1}))
+
+    # Same columns and bounds as the instance, missing bounds are `0` as default of protobuf
+    df = solution.decision_variables
+    assert_frame_equal(
+        df, _decision_variables(solution.raw), check_dtype=False, check_index_type=False
+    )
+    assert df["lower"].tolist() == [0.0, 0.0, -1.0]
+    assert df["upper"].tolist() == [0.0, 0.0, 3.0]
+
+
+def test_constraints_frame():
+    x = [DecisionVariable.binary(i) for i in range(2)]
+    instance = Instance.from_components(
+        decision_variables=x,
+        objective=x[0] + x[1],
+        constraints=[x[0] + x[1] <= 1],
+        sense=Instance.MAXIMIZE,
+    )
+    solution = instance.evaluate(State(entries={0: 1, 1: 1}))
+
+    df = solution.constraints
+    assert [c for c, _ in df.columns] == [
+        "equality",
+        "value",
+        "used_ids",
+        "name",
+        "description",
+    ]
+    assert df["value"].tolist() == [1.0]
+    assert df["used_ids"].tolist() == [{0, 1}]
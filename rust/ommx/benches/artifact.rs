@@ -0,0 +1,122 @@
+//! Benchmark building artifacts into OCI archive and OCI directory, and reading instances from them by digest
+
+use criterion::{criterion_group, criterion_main, BatchSize, BenchmarkId, Criterion, Throughput};
+use ocipkg::{Digest, ImageName};
+use ommx::{
+    artifact::{media_types, Artifact, Builder, InstanceAnnotations},
+    random::random_lp,
+    v1::Instance,
+    Message,
+};
+use rand::SeedableRng;
+use rand_xoshiro::Xoshiro256StarStar;
+use std::path::{Path, PathBuf};
+use uuid::Uuid;
+
+const SIZES: [(usize, usize); 2] = [(100, 100), (1_000, 1_000)];
+
+/// Directory for the artifacts created in this benchmark, removed when dropped
+struct BenchDir(PathBuf);
+
+impl BenchDir {
+    fn new() -> Self {
+        let path = std::env::temp_dir().join(format!("ommx-bench-{}", Uuid::new_v4()));
+        std::fs::create_dir_all(&path).unwrap();
+        Self(path)
+    }
+
+    fn unique_path(&self) -> PathBuf {
+        self.0.join(Uuid::new_v4().to_string())
+    }
+}
+
+impl Drop for BenchDir {
+    fn drop(&mut self) {
+        let _ = std::fs::remove_dir_all(&self.0);
+    }
+}
+
+fn image_name() -> ImageName {
+    ImageName::parse("localhost/ommx/bench:latest").unwrap()
+}
+
+fn instances() -> impl Iterator<Item = (String, Instance)> {
+    SIZES.into_iter().map(|(num_variables, num_constraints)| {
+        let mut rng = Xoshiro256StarStar::seed_from_u64(0);
+        (
+            format!("{num_variables}x{num_constraints}"),
+            random_lp(&mut rng, num_variables, num_constraints),
+        )
+    })
+}
+
+fn build_archive(path: &Path, instance: Instance) -> Artifact<ocipkg::image::OciArchive> {
+    let mut builder = Builder::new_archive(path.to_path_buf(), image_name()).unwrap();
+    builder
+        .add_instance(instance, InstanceAnnotations::default())
+        .unwrap();
+    builder.build().unwrap()
+}
+
+fn build(c: &mut Criterion) {
+    let dir = BenchDir::new();
+    let mut group = c.benchmark_group("build");
+    group.sample_size(10);
+    for (size, instance) in instances() {
+        group.throughput(Throughput::Bytes(instance.encoded_len() as u64));
+        group.bench_with_input(BenchmarkId::new("archive", &size), &size, |b, _| {
+            b.iter_batched(
+                || (dir.unique_path(), instance.clone()),
+                |(path, instance)| build_archive(&path, instance),
+                BatchSize::PerIteration,
+            )
+        });
+        group.bench_with_input(BenchmarkId::new("dir", &size), &size, |b, _| {
+            b.iter_batched(
+                || (dir.unique_path(), instance.clone()),
+                |(path, instance)| {
+                    let mut builder = Builder::new_oci_dir(path, image_name()).unwrap();
+                    builder
+                        .add_instance(instance, InstanceAnnotations::default())
+                        .unwrap();
+                    builder.build().unwrap()
+                },
+                BatchSize::PerIteration,
+            )
+        });
+    }
+    group.finish();
+}
+
+fn get_instance(c: &mut Criterion) {
+    let dir = BenchDir::new();
+    let mut group = c.benchmark_group("get_instance");
+    group.sample_size(20);
+    for (size, instance) in instances() {
+        group.throughput(Throughput::Bytes(instance.encoded_len() as u64));
+        let path = dir.unique_path();
+        let mut artifact = build_archive(&path, instance);
+        let digest = artifact
+            .get_layer_descriptors(&media_types::v1_instance())
+            .unwrap()
+            .first()
+            .map(|desc| Digest::new(desc.digest()).unwrap())
+            .unwrap();
+        group.bench_with_input(BenchmarkId::new("opened", &size), &size, |b, _| {
+            let mut artifact = Artifact::from_oci_archive(&path).unwrap();
+            b.iter(|| artifact.get_instance(&digest).unwrap())
+        });
+        group.bench_with_input(BenchmarkId::new("open", &size), &size, |b, _| {
+            b.iter(|| {
+                Artifact::from_oci_archive(&path)
+                    .unwrap()
+                    .get_instance(&digest)
+                    .unwrap()
+            })
+        });
+    }
+    group.finish();
+}
+
+criterion_group!(benches, build, get_instance);
+criterion_main!(benches);
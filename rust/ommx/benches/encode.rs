@@ -0,0 +1,46 @@
+//! Benchmark prost encode/decode of large instances, uncompressed and with zstd
+
+use criterion::{black_box, criterion_group, criterion_main, BenchmarkId, Criterion, Throughput};
+use ommx::{
+    artifact::{decode_instance_zstd, encode_instance_zstd},
+    random::random_lp,
+    v1::Instance,
+    Message,
+};
+use rand::SeedableRng;
+use rand_xoshiro::Xoshiro256StarStar;
+
+const SIZES: [(usize, usize); 3] = [(100, 100), (1_000, 100), (1_000, 1_000)];
+
+fn encode_decode(c: &mut Criterion) {
+    let mut group = c.benchmark_group("instance");
+    group.sample_size(20);
+    for (num_variables, num_constraints) in SIZES {
+        let mut rng = Xoshiro256StarStar::seed_from_u64(0);
+        let instance = random_lp(&mut rng, num_variables, num_constraints);
+        let blob = instance.encode_to_vec();
+        let size = format!("{num_variables}x{num_constraints}");
+        group.throughput(Throughput::Bytes(blob.len() as u64));
+        group.bench_with_input(BenchmarkId::new("encode", &size), &size, |b, _| {
+            b.iter(|| black_box(&instance).encode_to_vec())
+        });
+        group.bench_with_input(BenchmarkId::new("decode", &size), &size, |b, _| {
+            b.iter(|| Instance::decode(black_box(blob.as_slice())).unwrap())
+        });
+        group.bench_with_input(BenchmarkId::new("decode_parallel", &size), &size, |b, _| {
+            b.iter(|| Instance::decode_parallel(black_box(&blob)).unwrap())
+        });
+
+        let compressed = encode_instance_zstd(&instance, 3).unwrap();
+        group.bench_with_input(BenchmarkId::new("encode_zstd", &size), &size, |b, _| {
+            b.iter(|| encode_instance_zstd(black_box(&instance), 3).unwrap())
+        });
+        group.bench_with_input(BenchmarkId::new("decode_zstd", &size), &size, |b, _| {
+            b.iter(|| decode_instance_zstd(black_box(&compressed)).unwrap())
+        });
+    }
+    group.finish();
+}
+
+criterion_group!(benches, encode_decode);
+criterion_main!(benches);
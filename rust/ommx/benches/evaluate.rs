@@ -0,0 +1,167 @@
+//! Benchmark [Evaluate] of functions and instances, and [CompiledInstance] for comparison
+
+use criterion::{black_box, criterion_group, criterion_main, BenchmarkId, Criterion, Throughput};
+use ommx::{
+    random::{random_lp, random_qubo, random_sparse_mip},
+    v1::{linear::Term, Linear, Monomial, Polynomial, Quadratic, State},
+    CompiledInstance, Evaluate,
+};
+use rand::{Rng, SeedableRng};
+use rand_xoshiro::Xoshiro256StarStar;
+use std::collections::HashMap;
+
+const SIZES: [usize; 3] = [100, 1_000, 10_000];
+
+fn rng() -> Xoshiro256StarStar {
+    Xoshiro256StarStar::seed_from_u64(0)
+}
+
+fn random_state(rng: &mut impl Rng, num_variables: usize) -> State {
+    (0..num_variables as u64)
+        .map(|id| (id, rng.gen_range(-1.0..1.0)))
+        .collect::<HashMap<_, _>>()
+        .into()
+}
+
+fn random_linear(rng: &mut impl Rng, num_terms: usize) -> Linear {
+    Linear {
+        terms: (0..num_terms as u64)
+            .map(|id| Term {
+                id,
+                coefficient: rng.gen_range(-1.0..1.0),
+            })
+            .collect(),
+        constant: rng.gen_range(-1.0..1.0),
+    }
+}
+
+/// Quadratic function of `num_terms` random entries over `num_terms` variables
+fn random_quadratic(rng: &mut impl Rng, num_terms: usize) -> Quadratic {
+    let n = num_terms as u64;
+    Quadratic {
+        rows: (0..num_terms).map(|_| rng.gen_range(0..n)).collect(),
+        columns: (0..num_terms).map(|_| rng.gen_range(0..n)).collect(),
+        values: (0..num_terms).map(|_| rng.gen_range(-1.0..1.0)).collect(),
+        linear: Some(random_linear(rng, num_terms)),
+    }
+}
+
+/// Polynomial of `num_terms` random monomials up to degree 4 over `num_terms` variables
+fn random_polynomial(rng: &mut impl Rng, num_terms: usize) -> Polynomial {
+    let n = num_terms as u64;
+    Polynomial {
+        terms: (0..num_terms)
+            .map(|_| {
+                let degree = rng.gen_range(1..=4);
+                Monomial {
+                    ids: (0..degree).map(|_| rng.gen_range(0..n)).collect(),
+                    coefficient: rng.gen_range(-1.0..1.0),
+                }
+            })
+            .collect(),
+    }
+}
+
+fn bench_function<F: Evaluate>(
+    c: &mut Criterion,
+    name: &str,
+    generate: impl Fn(&mut Xoshiro256StarStar, usize) -> F,
+) {
+    let mut group = c.benchmark_group(name);
+    for size in SIZES {
+        let mut rng = rng();
+        let f = generate(&mut rng, size);
+        let state = random_state(&mut rng, size);
+        group.throughput(Throughput::Elements(size as u64));
+        group.bench_with_input(BenchmarkId::new("evaluate", size), &size, |b, _| {
+            b.iter(|| f.evaluate(black_box(&state)).unwrap())
+        });
+        group.bench_with_input(BenchmarkId::new("evaluate_value", size), &size, |b, _| {
+            b.iter(|| f.evaluate_value(black_box(&state)).unwrap())
+        });
+        let dense = state.clone().into_dense();
+        group.bench_with_input(
+            BenchmarkId::new("evaluate_value_dense", size),
+            &size,
+            |b, _| b.iter(|| f.evaluate_value(black_box(&dense)).unwrap()),
+        );
+    }
+    group.finish();
+}
+
+fn linear(c: &mut Criterion) {
+    bench_function(c, "linear", random_linear);
+}
+
+fn quadratic(c: &mut Criterion) {
+    bench_function(c, "quadratic", random_quadratic);
+}
+
+fn polynomial(c: &mut Criterion) {
+    bench_function(c, "polynomial", random_polynomial);
+}
+
+fn instance(c: &mut Criterion) {
+    let mut group = c.benchmark_group("instance");
+    group.sample_size(20);
+    // Dense LP has `num_variables x num_constraints` terms
+    for (num_variables, num_constraints) in [(100, 10), (1_000, 100), (10_000, 100)] {
+        let mut rng = rng();
+        let instance = random_lp(&mut rng, num_variables, num_constraints);
+        let state = random_state(&mut rng, num_variables);
+        let size = format!("{num_variables}x{num_constraints}");
+        group.throughput(Throughput::Elements(
+            (num_variables * num_constraints) as u64,
+        ));
+        group.bench_with_input(BenchmarkId::new("evaluate", &size), &size, |b, _| {
+            b.iter(|| instance.evaluate(black_box(&state)).unwrap())
+        });
+        let compiled = CompiledInstance::new(&instance).unwrap();
+        group.bench_with_input(BenchmarkId::new("compiled", &size), &size, |b, _| {
+            b.iter(|| compiled.evaluate_value(black_box(&state)).unwrap())
+        });
+    }
+    group.finish();
+}
+
+fn sparse_instance(c: &mut Criterion) {
+    let mut group = c.benchmark_group("sparse_instance");
+    group.sample_size(20);
+    for num_variables in [10_000, 100_000] {
+        let mut rng = rng();
+        let state = random_state(&mut rng, num_variables);
+        // 100 terms in each of 1000 constraints
+        let mip = random_sparse_mip(
+            &mut rng,
+            num_variables,
+            1_000,
+            100.0 / num_variables as f64,
+            0.5,
+        );
+        let qubo = random_qubo(&mut rng, num_variables, 10 * num_variables);
+        for (name, instance) in [("mip", mip), ("qubo", qubo)] {
+            group.bench_with_input(
+                BenchmarkId::new(name, num_variables),
+                &num_variables,
+                |b, _| b.iter(|| instance.evaluate(black_box(&state)).unwrap()),
+            );
+            let compiled = CompiledInstance::new(&instance).unwrap();
+            group.bench_with_input(
+                BenchmarkId::new(format!("{name}_compiled"), num_variables),
+                &num_variables,
+                |b, _| b.iter(|| compiled.evaluate_value(black_box(&state)).unwrap()),
+            );
+        }
+    }
+    group.finish();
+}
+
+criterion_group!(
+    benches,
+    linear,
+    quadratic,
+    polynomial,
+    instance,
+    sparse_instance
+);
+criterion_main!(benches);
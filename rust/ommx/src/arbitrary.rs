@@ -1,14 +1,40 @@
-use crate::random::random_lp;
+use crate::random::{random_lp, random_polynomial, random_qubo, random_sparse_mip};
 use proptest::prelude::*;
 use rand::SeedableRng;
 
+#[cfg(test)]
+use crate::{
+    v1::{self, decision_variable::Kind},
+    UsedDecisionVariableIds,
+};
+#[cfg(test)]
+use std::collections::{BTreeMap, HashMap};
+
+/// Type and size of the instance yielded by `any_with::<v1::Instance>`, see [crate::random] for details
 #[derive(Debug, Clone)]
 pub enum InstanceParameter {
+    /// Dense LP by [random_lp]
     LP {
         num_constraints: usize,
         num_variables: usize,
     },
-    // FIXME: Add more instance types
+    /// Sparse MIP by [random_sparse_mip]
+    SparseMIP {
+        num_constraints: usize,
+        num_variables: usize,
+        /// Ratio of non-zeros in each constraint, in `(0, 1]`
+        density: f64,
+        /// Probability of each variable being integer
+        integer_ratio: f64,
+    },
+    /// QUBO by [random_qubo]
+    QUBO { num_variables: usize, nnz: usize },
+    /// Binary polynomial optimization by [random_polynomial]
+    Polynomial {
+        num_variables: usize,
+        num_terms: usize,
+        max_degree: usize,
+    },
 }
 
 impl Default for InstanceParameter {
@@ -28,11 +54,144 @@ impl Arbitrary for crate::v1::Instance {
         // The instance yielded from strategy must depends only on the parameter deterministically.
         // Thus we should not use `thread_rng` here.
         let mut rng = rand_xoshiro::Xoshiro256StarStar::seed_from_u64(0);
-        match parameter {
+        let instance = match parameter {
             InstanceParameter::LP {
                 num_constraints,
                 num_variables,
-            } => Just(random_lp(&mut rng, num_variables, num_constraints)).boxed(),
-        }
+            } => random_lp(&mut rng, num_variables, num_constraints),
+            InstanceParameter::SparseMIP {
+                num_constraints,
+                num_variables,
+                density,
+                integer_ratio,
+            } => random_sparse_mip(
+                &mut rng,
+                num_variables,
+                num_constraints,
+                density,
+                integer_ratio,
+            ),
+            InstanceParameter::QUBO { num_variables, nnz } => {
+                random_qubo(&mut rng, num_variables, nnz)
+            }
+            InstanceParameter::Polynomial {
+                num_variables,
+                num_terms,
+                max_degree,
+            } => random_polynomial(&mut rng, num_variables, num_terms, max_degree),
+        };
+        Just(instance).boxed()
+    }
+}
+
+impl Arbitrary for InstanceParameter {
+    type Parameters = ();
+    type Strategy = BoxedStrategy<Self>;
+
+    /// Small sizes of every type of the instance
+    fn arbitrary_with(_: ()) -> Self::Strategy {
+        let lp = (0..8_usize, 1..8_usize).prop_map(|(num_constraints, num_variables)| {
+            InstanceParameter::LP {
+                num_constraints,
+                num_variables,
+            }
+        });
+        let sparse_mip = (0..8_usize, 1..10_usize, 1..=10_u32, 0.0..=1.0).prop_map(
+            |(num_constraints, num_variables, density, integer_ratio)| {
+                InstanceParameter::SparseMIP {
+                    num_constraints,
+                    num_variables,
+                    density: density as f64 / 10.0,
+                    integer_ratio,
+                }
+            },
+        );
+        let qubo = (1..10_usize)
+            .prop_flat_map(|n| (Just(n), 0..=n * (n + 1) / 2))
+            .prop_map(|(num_variables, nnz)| InstanceParameter::QUBO { num_variables, nnz });
+        let polynomial = (1..8_usize)
+            .prop_flat_map(|n| (Just(n), 0..10_usize, 1..=n))
+            .prop_map(
+                |(num_variables, num_terms, max_degree)| InstanceParameter::Polynomial {
+                    num_variables,
+                    num_terms,
+                    max_degree,
+                },
+            );
+        prop_oneof![lp, sparse_mip, qubo, polynomial].boxed()
+    }
+}
+
+/// Small sparse MIP instances of various sizes, which are linear and feasible at the origin
+#[cfg(test)]
+pub(crate) fn arbitrary_sparse_mip() -> BoxedStrategy<v1::Instance> {
+    (0..10_usize, 1..10_usize, 1..=4_u32, 0.0..=1.0)
+        .prop_flat_map(|(num_constraints, num_variables, density, integer_ratio)| {
+            v1::Instance::arbitrary_with(InstanceParameter::SparseMIP {
+                num_constraints,
+                num_variables,
+                density: density as f64 / 4.0,
+                integer_ratio,
+            })
+        })
+        .boxed()
+}
+
+/// State of all decision variables in the instance, whose values are within their bounds and integral for integer variables.
+/// Unbounded values are taken from `[-10, 10]`.
+#[cfg(test)]
+pub(crate) fn arbitrary_state(instance: &v1::Instance) -> BoxedStrategy<v1::State> {
+    let mut bounds: BTreeMap<u64, (i32, f64, f64)> = instance
+        .decision_variables
+        .iter()
+        .map(|dv| {
+            let (lower, upper) = match &dv.bound {
+                Some(bound) => (bound.lower, bound.upper),
+                None if dv.kind == Kind::Binary as i32 => (0.0, 1.0),
+                None => (f64::NEG_INFINITY, f64::INFINITY),
+            };
+            (dv.id, (dv.kind, lower, upper))
+        })
+        .collect();
+    // Decision variables used without definition, e.g. in the instances by [random_lp]
+    for id in UsedDecisionVariableIds::new(instance)
+        .expect("Invalid instance")
+        .all
+    {
+        bounds
+            .entry(id)
+            .or_insert((Kind::Continuous as i32, f64::NEG_INFINITY, f64::INFINITY));
     }
+    let values: Vec<BoxedStrategy<(u64, f64)>> = bounds
+        .into_iter()
+        .map(|(id, (kind, lower, upper))| {
+            let lower = if lower.is_finite() {
+                lower
+            } else {
+                upper.min(0.0) - 10.0
+            };
+            let upper = if upper.is_finite() {
+                upper
+            } else {
+                lower.max(0.0) + 10.0
+            };
+            let value = if matches!(
+                Kind::try_from(kind),
+                Ok(Kind::Integer) | Ok(Kind::Binary) | Ok(Kind::SemiInteger)
+            ) && lower.ceil() <= upper.floor()
+            {
+                (lower.ceil() as i64..=upper.floor() as i64)
+                    .prop_map(|v| v as f64)
+                    .boxed()
+            } else if lower < upper {
+                (lower..=upper).boxed()
+            } else {
+                Just(lower).boxed()
+            };
+            (Just(id), value).boxed()
+        })
+        .collect();
+    values
+        .prop_map(|entries| entries.into_iter().collect::<HashMap<_, _>>().into())
+        .boxed()
 }
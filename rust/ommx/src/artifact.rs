@@ -2,21 +2,36 @@
 //!
 
 mod annotations;
+#[cfg(feature = "async")]
+mod async_remote;
 mod builder;
+mod cache;
+mod compression;
 mod config;
+mod index;
 pub mod media_types;
+mod mmap;
+mod shard;
+mod store;
+mod transfer;
 pub use annotations::*;
+#[cfg(feature = "async")]
+pub use async_remote::*;
 pub use builder::*;
+pub use compression::*;
 pub use config::*;
+pub use index::*;
+pub use mmap::*;
+pub use shard::*;
+pub use store::*;
+pub use transfer::*;
 
 use crate::v1;
 use anyhow::{bail, ensure, Context, Result};
+use cache::ManifestCache;
 use ocipkg::{
     distribution::MediaType,
-    image::{
-        Image, OciArchive, OciArchiveBuilder, OciArtifact, OciDir, OciDirBuilder, Remote,
-        RemoteBuilder,
-    },
+    image::{Image, OciArchive, OciArchiveBuilder, OciArtifact, OciDir, OciDirBuilder, Remote},
     oci_spec::image::{Descriptor, ImageManifest},
     Digest, ImageName,
 };
@@ -44,6 +59,10 @@ fn gather_oci_dirs(dir: &Path) -> Result<Vec<PathBuf>> {
     for entry in std::fs::read_dir(dir)? {
         let entry = entry?;
         let path = entry.path();
+        // Skip hidden directories, e.g. the blob store, since image names never contain them
+        if entry.file_name().to_string_lossy().starts_with('.') {
+            continue;
+        }
         if path.is_dir() {
             if path.join("oci-layout").exists() {
                 images.push(path);
@@ -70,21 +89,30 @@ fn auth_from_env() -> Result<(String, String, String)> {
     bail!("No authentication information found in environment variables");
 }
 
+/// Images in the local registry, listed from [LocalIndex] without walking the directory
 pub fn get_images() -> Result<Vec<ImageName>> {
-    let root = data_dir()?;
-    let dirs = gather_oci_dirs(&root)?;
-    dirs.into_iter()
-        .map(|dir| {
-            let relative = dir
-                .strip_prefix(&root)
-                .context("Failed to get relative path")?;
-            ImageName::from_path(relative)
-        })
+    LocalIndex::load()?
+        .entries()
+        .map(|entry| ImageName::parse(&entry.image_name))
         .collect()
 }
 
+/// Media types of the layers storing [v1::Instance], including the header of the sharded instance
+fn instance_media_types() -> [MediaType; 3] {
+    [
+        media_types::v1_instance(),
+        media_types::v1_instance_zstd(),
+        media_types::v1_instance_header(),
+    ]
+}
+
 /// OMMX Artifact, an OCI Artifact of type [`application/org.ommx.v1.artifact`][media_types::v1_artifact]
-pub struct Artifact<Base: Image>(OciArtifact<Base>);
+///
+/// Artifacts opened by [Artifact::from_oci_archive] or [Artifact::from_oci_dir] read layer blobs through memory maps, see [BlobMap].
+///
+/// The manifest and config are read only once and kept in the artifact,
+/// so that [Artifact::get_manifest] and the methods looking up layers, e.g. [Artifact::get_instance], do not read them again.
+pub struct Artifact<Base: Image>(OciArtifact<Base>, Option<BlobMap>, ManifestCache);
 
 impl<Base: Image> Deref for Artifact<Base> {
     type Target = OciArtifact<Base>;
@@ -100,22 +128,21 @@ impl<Base: Image> DerefMut for Artifact<Base> {
 }
 
 impl Artifact<OciArchive> {
+    #[tracing::instrument(skip_all, fields(path = %path.display()))]
     pub fn from_oci_archive(path: &Path) -> Result<Self> {
         let artifact = OciArtifact::from_oci_archive(path)?;
-        Self::new(artifact)
+        Ok(Self(
+            artifact,
+            Some(BlobMap::from_oci_archive(path)?),
+            ManifestCache::default(),
+        ))
     }
 
     pub fn push(&mut self) -> Result<Artifact<Remote>> {
-        let name = self.get_name()?;
-        log::info!("Pushing: {}", name);
-        let mut remote = RemoteBuilder::new(name)?;
-        if let Ok((domain, username, password)) = auth_from_env() {
-            remote.add_basic_auth(&domain, &username, &password);
-        }
-        let out = ocipkg::image::copy(self.0.deref_mut(), remote)?;
-        Ok(Artifact(OciArtifact::new(out)))
+        self.push_with(&TransferOptions::default())
     }
 
+    #[tracing::instrument(skip_all)]
     pub fn load(&mut self) -> Result<()> {
         let image_name = self.get_name()?;
         let path = image_dir(&image_name)?;
@@ -124,28 +151,33 @@ impl Artifact<OciArchive> {
             return Ok(());
         }
         log::info!("Loading: {}", image_name);
-        ocipkg::image::copy(self.0.deref_mut(), OciDirBuilder::new(path, image_name)?)?;
+        ocipkg::image::copy(
+            self.0.deref_mut(),
+            OciDirBuilder::new(path.clone(), image_name.clone())?,
+        )?;
+        BlobStore::local()?.deduplicate(&path)?;
+        let manifest = self.raw_manifest()?.clone();
+        LocalIndex::record(&image_name, &manifest)?;
         Ok(())
     }
 }
 
 impl Artifact<OciDir> {
+    #[tracing::instrument(skip_all, fields(path = %path.display()))]
     pub fn from_oci_dir(path: &Path) -> Result<Self> {
         let artifact = OciArtifact::from_oci_dir(path)?;
-        Self::new(artifact)
+        Ok(Self(
+            artifact,
+            Some(BlobMap::from_oci_dir(path)?),
+            ManifestCache::default(),
+        ))
     }
 
     pub fn push(&mut self) -> Result<Artifact<Remote>> {
-        let name = self.get_name()?;
-        log::info!("Pushing: {}", name);
-        let mut remote = RemoteBuilder::new(name)?;
-        if let Ok((domain, username, password)) = auth_from_env() {
-            remote.add_basic_auth(&domain, &username, &password);
-        }
-        let out = ocipkg::image::copy(self.0.deref_mut(), remote)?;
-        Ok(Artifact(OciArtifact::new(out)))
+        self.push_with(&TransferOptions::default())
     }
 
+    #[tracing::instrument(skip_all)]
     pub fn save(&mut self, output: &Path) -> Result<()> {
         if output.exists() {
             bail!("Output file already exists: {}", output.display());
@@ -163,32 +195,32 @@ impl Artifact<OciDir> {
 impl Artifact<Remote> {
     pub fn from_remote(image_name: ImageName) -> Result<Self> {
         let artifact = OciArtifact::from_remote(image_name)?;
-        Self::new(artifact)
+        Ok(Self(artifact, None, ManifestCache::default()))
     }
 
     pub fn pull(&mut self) -> Result<Artifact<OciDir>> {
-        let image_name = self.get_name()?;
-        let path = image_dir(&image_name)?;
-        if path.exists() {
-            log::trace!("Already exists in locally: {}", path.display());
-            return Ok(Artifact(OciArtifact::from_oci_dir(&path)?));
-        }
-        log::info!("Pulling: {}", image_name);
-        if let Ok((domain, username, password)) = auth_from_env() {
-            self.0.add_basic_auth(&domain, &username, &password);
-        }
-        let out = ocipkg::image::copy(self.0.deref_mut(), OciDirBuilder::new(path, image_name)?)?;
-        Ok(Artifact(OciArtifact::new(out)))
+        self.pull_with(&TransferOptions::default())
     }
 }
 
 impl<Base: Image> Artifact<Base> {
     pub fn new(artifact: OciArtifact<Base>) -> Result<Self> {
-        Ok(Self(artifact))
+        Ok(Self(artifact, None, ManifestCache::default()))
     }
 
-    pub fn get_manifest(&mut self) -> Result<ImageManifest> {
-        let manifest = self.0.get_manifest()?;
+    /// Manifest without checking the artifact type, read from the base image only at the first call
+    fn raw_manifest(&mut self) -> Result<&ImageManifest> {
+        if self.2.manifest.is_none() {
+            let _span = tracing::info_span!("get_manifest").entered();
+            let manifest = self.0.get_manifest()?;
+            self.2.manifest = Some(manifest);
+        }
+        Ok(self.2.manifest.as_ref().unwrap())
+    }
+
+    /// Reference to the cached manifest, which avoids the copy of [Artifact::get_manifest]
+    pub fn manifest(&mut self) -> Result<&ImageManifest> {
+        let manifest = self.raw_manifest()?;
         let ty = manifest
             .artifact_type()
             .as_ref()
@@ -201,80 +233,132 @@ impl<Base: Image> Artifact<Base> {
         Ok(manifest)
     }
 
+    pub fn get_manifest(&mut self) -> Result<ImageManifest> {
+        Ok(self.manifest()?.clone())
+    }
+
     pub fn get_config(&mut self) -> Result<Config> {
+        if let Some(config) = &self.2.config {
+            return Ok(config.clone());
+        }
         let (_desc, blob) = self.0.get_config()?;
-        let config = serde_json::from_slice(&blob)?;
+        let config: Config = serde_json::from_slice(&blob)?;
+        self.2.config = Some(config.clone());
         Ok(config)
     }
 
     pub fn get_layer_descriptors(&mut self, media_type: &MediaType) -> Result<Vec<Descriptor>> {
-        let manifest = self.get_manifest()?;
+        self.layer_descriptors(std::slice::from_ref(media_type))
+    }
+
+    /// Descriptors of the layers of any of the given media types, in the order of the manifest
+    fn layer_descriptors(&mut self, media_types: &[MediaType]) -> Result<Vec<Descriptor>> {
+        let manifest = self.manifest()?;
         Ok(manifest
             .layers()
             .iter()
-            .filter(|desc| desc.media_type() == media_type)
+            .filter(|desc| media_types.contains(desc.media_type()))
             .cloned()
             .collect())
     }
 
-    pub fn get_solution(&mut self, digest: &Digest) -> Result<(v1::State, SolutionAnnotations)> {
-        for (desc, blob) in self.0.get_layers()? {
-            if desc.media_type() != &media_types::v1_solution()
-                || desc.digest() != &digest.to_string()
-            {
-                continue;
-            }
-            let solution = v1::State::decode(blob.as_slice())?;
-            let annotations = if let Some(annotations) = desc.annotations() {
-                annotations.clone().into()
-            } else {
-                SolutionAnnotations::default()
-            };
-            return Ok((solution, annotations));
+    /// Descriptor of the layer of any of the given media types and the digest, looked up from the manifest
+    fn find_layer_descriptor(
+        &mut self,
+        media_types: &[MediaType],
+        digest: &Digest,
+    ) -> Result<Option<Descriptor>> {
+        let digest = digest.to_string();
+        Ok(self
+            .layer_descriptors(media_types)?
+            .into_iter()
+            .find(|desc| desc.digest() == &digest))
+    }
+
+    /// Read only the blob of the given digest. This does not copy the blob if it is memory-mapped.
+    #[tracing::instrument(skip_all, fields(digest = %digest, bytes))]
+    pub fn get_layer_blob(&mut self, digest: &Digest) -> Result<Blob> {
+        let blob: Blob = match &self.1 {
+            Some(blobs) => blobs.get_blob(digest)?,
+            None => self.0.get_blob(digest)?.into(),
+        };
+        tracing::Span::current().record("bytes", blob.len());
+        Ok(blob)
+    }
+
+    fn get_descriptor_blob(&mut self, desc: &Descriptor) -> Result<Blob> {
+        self.get_layer_blob(&Digest::new(desc.digest())?)
+    }
+
+    /// Decode the instance layer, decompressing it if the media type is [media_types::v1_instance_zstd],
+    /// or merging its shards if [media_types::v1_instance_header]
+    #[tracing::instrument(skip_all, fields(media_type = %desc.media_type(), bytes = desc.size()))]
+    fn decode_instance_layer(&mut self, desc: &Descriptor) -> Result<v1::Instance> {
+        if desc.media_type() == &media_types::v1_instance_header() {
+            return self.decode_sharded_instance(desc);
+        }
+        let blob = self.get_descriptor_blob(desc)?;
+        if desc.media_type() == &media_types::v1_instance_zstd() {
+            decode_instance_zstd(&blob)
+        } else {
+            v1::Instance::decode_parallel(&blob)
         }
+    }
+
+    pub fn get_solution(&mut self, digest: &Digest) -> Result<(v1::State, SolutionAnnotations)> {
         // TODO: Seek from other artifacts
-        bail!("Solution of digest {} not found", digest)
+        let desc = self
+            .find_layer_descriptor(&[media_types::v1_solution()], digest)?
+            .with_context(|| format!("Solution of digest {} not found", digest))?;
+        let solution = v1::State::decode(&*self.get_descriptor_blob(&desc)?)?;
+        let annotations = if let Some(annotations) = desc.annotations() {
+            annotations.clone().into()
+        } else {
+            SolutionAnnotations::default()
+        };
+        Ok((solution, annotations))
     }
 
     pub fn get_instance(&mut self, digest: &Digest) -> Result<(v1::Instance, InstanceAnnotations)> {
-        for (desc, blob) in self.0.get_layers()? {
-            if desc.media_type() != &media_types::v1_instance()
-                || desc.digest() != &digest.to_string()
-            {
-                continue;
-            }
-            let instance = v1::Instance::decode(blob.as_slice())?;
-            let annotations = if let Some(annotations) = desc.annotations() {
-                annotations.clone().into()
-            } else {
-                InstanceAnnotations::default()
-            };
-            return Ok((instance, annotations));
-        }
-        bail!("Instance of digest {} not found", digest)
+        let desc = self
+            .find_layer_descriptor(&instance_media_types(), digest)?
+            .with_context(|| format!("Instance of digest {} not found", digest))?;
+        let instance = self.decode_instance_layer(&desc)?;
+        let annotations = if let Some(annotations) = desc.annotations() {
+            annotations.clone().into()
+        } else {
+            InstanceAnnotations::default()
+        };
+        Ok((instance, annotations))
+    }
+
+    /// Lazy iterator over the solution layers, which reads and decodes each blob on demand
+    pub fn solutions(
+        &mut self,
+    ) -> Result<impl Iterator<Item = Result<(Descriptor, v1::State)>> + '_> {
+        let descriptors = self.get_layer_descriptors(&media_types::v1_solution())?;
+        Ok(descriptors.into_iter().map(move |desc| {
+            let solution = v1::State::decode(&*self.get_descriptor_blob(&desc)?)?;
+            Ok((desc, solution))
+        }))
+    }
+
+    /// Lazy iterator over the instance layers, which reads and decodes each blob on demand
+    pub fn instances(
+        &mut self,
+    ) -> Result<impl Iterator<Item = Result<(Descriptor, v1::Instance)>> + '_> {
+        let descriptors = self.layer_descriptors(&instance_media_types())?;
+        Ok(descriptors.into_iter().map(move |desc| {
+            let instance = self.decode_instance_layer(&desc)?;
+            Ok((desc, instance))
+        }))
     }
 
     pub fn get_solutions(&mut self) -> Result<Vec<(Descriptor, v1::State)>> {
-        let mut out = Vec::new();
-        for (desc, blob) in self.0.get_layers()? {
-            if desc.media_type() != &media_types::v1_solution() {
-                continue;
-            }
-            let solution = v1::State::decode(blob.as_slice())?;
-            out.push((desc, solution));
-        }
-        Ok(out)
+        self.solutions()?.collect()
     }
 
     pub fn get_instances(&mut self) -> Result<Vec<(Descriptor, v1::Instance)>> {
-        let mut out = Vec::new();
-        for (desc, blob) in self.0.get_layers()? {
-            if desc.media_type() != &media_types::v1_instance() {
-                continue;
-            }
-            let instance = v1::Instance::decode(blob.as_slice())?;
-            out.push((desc, instance));
-        }
-        Ok(out)
+        self.instances()?.collect()
     }
 }
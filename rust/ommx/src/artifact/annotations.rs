@@ -39,6 +39,22 @@ impl InstanceAnnotations {
         Ok(DateTime::parse_from_rfc3339(created)?.with_timezone(&Local))
     }
 
+    /// Set `org.ommx.v1.instance.shards`, the number of shards of [`application/org.ommx.v1.instance.header`][crate::artifact::media_types::v1_instance_header]
+    pub fn set_shards(&mut self, shards: usize) {
+        self.0.insert(
+            "org.ommx.v1.instance.shards".to_string(),
+            shards.to_string(),
+        );
+    }
+
+    /// Get `org.ommx.v1.instance.shards`
+    pub fn shards(&self) -> Result<usize> {
+        let shards = self.0.get("org.ommx.v1.instance.shards").context(
+            "Annotation does not have the entry with the key `org.ommx.v1.instance.shards`",
+        )?;
+        Ok(shards.parse()?)
+    }
+
     /// Set other annotations. The key may not start with `org.ommx.v1.`, but must a valid reverse domain name.
     pub fn set_other(&mut self, key: String, value: String) {
         // TODO check key
@@ -46,6 +62,48 @@ impl InstanceAnnotations {
     }
 }
 
+/// Annotations for [`application/org.ommx.v1.instance.shard`][crate::artifact::media_types::v1_instance_shard]
+#[derive(Debug, Default, Clone, PartialEq, From, Deref, Into)]
+pub struct InstanceShardAnnotations(HashMap<String, String>);
+
+impl InstanceShardAnnotations {
+    pub fn from_descriptor(desc: &Descriptor) -> Self {
+        Self(desc.annotations().as_ref().cloned().unwrap_or_default())
+    }
+
+    /// Set `org.ommx.v1.instance.shard.header`, the digest of the header layer
+    pub fn set_header(&mut self, digest: &Digest) {
+        self.0.insert(
+            "org.ommx.v1.instance.shard.header".to_string(),
+            digest.to_string(),
+        );
+    }
+
+    /// Get `org.ommx.v1.instance.shard.header`
+    pub fn header(&self) -> Result<Digest> {
+        let digest = self.0.get("org.ommx.v1.instance.shard.header").context(
+            "Annotation does not have the entry with the key `org.ommx.v1.instance.shard.header`",
+        )?;
+        Digest::new(digest)
+    }
+
+    /// Set `org.ommx.v1.instance.shard.index`, the position of this shard starting from `0`
+    pub fn set_index(&mut self, index: usize) {
+        self.0.insert(
+            "org.ommx.v1.instance.shard.index".to_string(),
+            index.to_string(),
+        );
+    }
+
+    /// Get `org.ommx.v1.instance.shard.index`
+    pub fn index(&self) -> Result<usize> {
+        let index = self.0.get("org.ommx.v1.instance.shard.index").context(
+            "Annotation does not have the entry with the key `org.ommx.v1.instance.shard.index`",
+        )?;
+        Ok(index.parse()?)
+    }
+}
+
 /// Annotations for [`application/org.ommx.v1.solution`][crate::artifact::media_types::v1_solution]
 #[derive(Debug, Default, Clone, PartialEq, From, Deref, Into)]
 pub struct SolutionAnnotations(HashMap<String, String>);
@@ -0,0 +1,139 @@
+//! Async API of [Artifact<Remote>] on tokio, enabled by the `async` feature
+//!
+//! [ocipkg] provides only a blocking registry client, so each operation runs on the blocking thread pool of tokio
+//! via [tokio::task::spawn_blocking], and the async tasks never block the runtime.
+
+use super::{image_dir, Artifact, TransferOptions};
+use anyhow::{Context, Result};
+use ocipkg::{
+    image::{Image, OciDir, Remote},
+    oci_spec::image::ImageManifest,
+    ImageName,
+};
+use std::{
+    collections::HashSet,
+    sync::{Arc, Mutex},
+};
+use tokio::{sync::Semaphore, task::JoinSet};
+
+async fn blocking<T: Send + 'static>(f: impl FnOnce() -> Result<T> + Send + 'static) -> Result<T> {
+    tokio::task::spawn_blocking(f)
+        .await
+        .context("Blocking task of artifact operation is aborted")?
+}
+
+/// Async counterpart of [Artifact<Remote>]
+///
+/// Clones share the same connection to the registry, and their operations are serialized.
+#[derive(Clone)]
+pub struct AsyncArtifact(Arc<Mutex<Artifact<Remote>>>);
+
+impl AsyncArtifact {
+    pub async fn from_remote(image_name: ImageName) -> Result<Self> {
+        let artifact = blocking(move || Artifact::from_remote(image_name)).await?;
+        Ok(Self(Arc::new(Mutex::new(artifact))))
+    }
+
+    /// Push the local artifact, see [Artifact::push_with]
+    pub async fn push<Base: Image + Send + 'static>(
+        mut artifact: Artifact<Base>,
+        jobs: usize,
+    ) -> Result<Self> {
+        let remote = blocking(move || {
+            artifact.push_with(&TransferOptions {
+                jobs,
+                ..Default::default()
+            })
+        })
+        .await?;
+        Ok(Self(Arc::new(Mutex::new(remote))))
+    }
+
+    fn run<T: Send + 'static>(
+        &self,
+        f: impl FnOnce(&mut Artifact<Remote>) -> Result<T> + Send + 'static,
+    ) -> impl std::future::Future<Output = Result<T>> {
+        let inner = self.0.clone();
+        blocking(move || {
+            let mut artifact = inner
+                .lock()
+                .map_err(|_| anyhow::anyhow!("Artifact is poisoned by a panicked operation"))?;
+            f(&mut *artifact)
+        })
+    }
+
+    pub async fn get_manifest(&self) -> Result<ImageManifest> {
+        self.run(|artifact| artifact.get_manifest()).await
+    }
+
+    /// Pull into the local registry, see [Artifact::pull_with]
+    pub async fn pull(&self, jobs: usize) -> Result<Artifact<OciDir>> {
+        self.run(move |artifact| {
+            artifact.pull_with(&TransferOptions {
+                jobs,
+                ..Default::default()
+            })
+        })
+        .await
+    }
+}
+
+/// Pull the images concurrently into the local registry, at most `concurrency` images at once.
+/// Each pull downloads `jobs` blobs concurrently as [Artifact::pull_with].
+///
+/// Duplicated names are pulled only once, and the result is in the order of `image_names` including the duplicates.
+/// The first error is returned if any of the pulls fails.
+///
+/// ```no_run
+/// use ocipkg::ImageName;
+///
+/// # fn main() -> anyhow::Result<()> {
+/// let runtime = tokio::runtime::Builder::new_current_thread().enable_all().build()?;
+/// let image_names = ["random_lp_instance:testing", "random_lp_instance:4303c7f"]
+///     .iter()
+///     .map(|tag| ImageName::parse(&format!("ghcr.io/jij-inc/ommx/{tag}")))
+///     .collect::<Result<Vec<_>, _>>()?;
+/// let artifacts = runtime.block_on(ommx::artifact::pull_all(image_names, 8, 4))?;
+/// assert_eq!(artifacts.len(), 2);
+/// # Ok(()) }
+/// ```
+pub async fn pull_all(
+    image_names: impl IntoIterator<Item = ImageName>,
+    concurrency: usize,
+    jobs: usize,
+) -> Result<Vec<Artifact<OciDir>>> {
+    let image_names: Vec<ImageName> = image_names.into_iter().collect();
+    let semaphore = Arc::new(Semaphore::new(concurrency.max(1)));
+    let mut tasks = JoinSet::new();
+    let mut pulled = HashSet::new();
+    for (index, image_name) in image_names.iter().enumerate() {
+        // Pulls of the same image would wait for each other anyway, see [Artifact::pull_with]
+        if !pulled.insert(image_name.to_string()) {
+            continue;
+        }
+        let semaphore = semaphore.clone();
+        let image_name = image_name.clone();
+        tasks.spawn(async move {
+            let _permit = semaphore.acquire_owned().await?;
+            let artifact = AsyncArtifact::from_remote(image_name)
+                .await?
+                .pull(jobs)
+                .await?;
+            anyhow::Ok((index, artifact))
+        });
+    }
+    let mut artifacts: Vec<Option<Artifact<OciDir>>> = image_names.iter().map(|_| None).collect();
+    while let Some(result) = tasks.join_next().await {
+        let (index, artifact) = result.context("Pull task is aborted")??;
+        artifacts[index] = Some(artifact);
+    }
+    // Open the duplicates from the local registry
+    image_names
+        .iter()
+        .zip(artifacts)
+        .map(|(image_name, artifact)| match artifact {
+            Some(artifact) => Ok(artifact),
+            None => Artifact::from_oci_dir(&image_dir(image_name)?),
+        })
+        .collect()
+}
@@ -1,13 +1,18 @@
 use crate::{
-    artifact::{data_dir, media_types, Artifact, Config, InstanceAnnotations, SolutionAnnotations},
+    artifact::{
+        data_dir, encode_instance_zstd, media_types, split_instance, Artifact, BlobStore, Config,
+        InstanceAnnotations, InstanceShardAnnotations, LocalIndex, SolutionAnnotations,
+    },
     v1,
 };
 use anyhow::Result;
+use ocipkg::Digest;
 use ocipkg::{
-    image::{ImageBuilder, OciArchiveBuilder, OciArtifactBuilder, OciDirBuilder},
+    image::{Image, ImageBuilder, OciArchiveBuilder, OciArtifactBuilder, OciDirBuilder},
     ImageName,
 };
 use prost::Message;
+use rayon::prelude::*;
 use std::{
     collections::HashMap,
     ops::{Deref, DerefMut},
@@ -17,36 +22,44 @@ use url::Url;
 use uuid::Uuid;
 
 /// Build [Artifact]
-pub struct Builder<Base: ImageBuilder>(OciArtifactBuilder<Base>);
+pub struct Builder<Base: ImageBuilder> {
+    builder: OciArtifactBuilder<Base>,
+    /// zstd compression level of instance layers, see [Builder::set_compression_level]
+    compression_level: Option<i32>,
+    /// Directory of the image in the local registry, whose blobs are deduplicated by [BlobStore] after build
+    local_dir: Option<PathBuf>,
+}
 
 impl<Base: ImageBuilder> Deref for Builder<Base> {
     type Target = OciArtifactBuilder<Base>;
     fn deref(&self) -> &Self::Target {
-        &self.0
+        &self.builder
     }
 }
 
 impl<Base: ImageBuilder> DerefMut for Builder<Base> {
     fn deref_mut(&mut self) -> &mut Self::Target {
-        &mut self.0
+        &mut self.builder
     }
 }
 
 impl Builder<OciArchiveBuilder> {
     pub fn new_archive_unnamed(path: PathBuf) -> Result<Self> {
         let archive = OciArchiveBuilder::new_unnamed(path)?;
-        Ok(Self(OciArtifactBuilder::new(
-            archive,
-            media_types::v1_artifact(),
-        )?))
+        Ok(Self {
+            builder: OciArtifactBuilder::new(archive, media_types::v1_artifact())?,
+            compression_level: None,
+            local_dir: None,
+        })
     }
 
     pub fn new_archive(path: PathBuf, image_name: ImageName) -> Result<Self> {
         let archive = OciArchiveBuilder::new(path, image_name)?;
-        Ok(Self(OciArtifactBuilder::new(
-            archive,
-            media_types::v1_artifact(),
-        )?))
+        Ok(Self {
+            builder: OciArtifactBuilder::new(archive, media_types::v1_artifact())?,
+            compression_level: None,
+            local_dir: None,
+        })
     }
 
     /// Create a new artifact builder for a temporary file. This is insecure and should only be used in tests.
@@ -62,11 +75,23 @@ impl Builder<OciArchiveBuilder> {
 impl Builder<OciDirBuilder> {
     pub fn new(image_name: ImageName) -> Result<Self> {
         let dir = data_dir()?.join(image_name.as_path());
-        let layout = OciDirBuilder::new(dir, image_name)?;
-        Ok(Self(OciArtifactBuilder::new(
-            layout,
-            media_types::v1_artifact(),
-        )?))
+        let layout = OciDirBuilder::new(dir.clone(), image_name)?;
+        Ok(Self {
+            builder: OciArtifactBuilder::new(layout, media_types::v1_artifact())?,
+            compression_level: None,
+            local_dir: Some(dir),
+        })
+    }
+
+    /// Create a new artifact builder for an OCI directory at `path` outside the local registry.
+    /// Unlike [Builder::new], blobs are not deduplicated into [BlobStore], and the image is not recorded in [LocalIndex].
+    pub fn new_oci_dir(path: PathBuf, image_name: ImageName) -> Result<Self> {
+        let layout = OciDirBuilder::new(path, image_name)?;
+        Ok(Self {
+            builder: OciArtifactBuilder::new(layout, media_types::v1_artifact())?,
+            compression_level: None,
+            local_dir: None,
+        })
     }
 
     /// Create a new artifact builder for a GitHub container registry image
@@ -88,36 +113,93 @@ impl Builder<OciDirBuilder> {
 }
 
 impl<Base: ImageBuilder> Builder<Base> {
+    /// Compress instance layers added after this call by zstd of the given level,
+    /// and store them as [`application/org.ommx.v1.instance+zstd`][media_types::v1_instance_zstd].
+    /// `None`, the default, stores them uncompressed as [`application/org.ommx.v1.instance`][media_types::v1_instance].
+    pub fn set_compression_level(&mut self, level: Option<i32>) {
+        self.compression_level = level;
+    }
+
+    #[tracing::instrument(skip_all, fields(bytes))]
     pub fn add_instance(
         &mut self,
         instance: v1::Instance,
         annotations: InstanceAnnotations,
     ) -> Result<()> {
+        if let Some(level) = self.compression_level {
+            let blob = encode_instance_zstd(&instance, level)?;
+            tracing::Span::current().record("bytes", blob.len());
+            self.builder
+                .add_layer(media_types::v1_instance_zstd(), &blob, annotations.into())?;
+            return Ok(());
+        }
         let blob = instance.encode_to_vec();
-        self.0
+        tracing::Span::current().record("bytes", blob.len());
+        self.builder
             .add_layer(media_types::v1_instance(), &blob, annotations.into())?;
         Ok(())
     }
 
+    /// Add the instance as a header layer [`application/org.ommx.v1.instance.header`][media_types::v1_instance_header]
+    /// and shard layers [`application/org.ommx.v1.instance.shard`][media_types::v1_instance_shard], see [split_instance].
+    ///
+    /// Shards are encoded in parallel, and can be decoded in parallel by [Artifact::get_sharded_instance]
+    /// or one by one by [Artifact::instance_shards]. Returns the digest of the header.
+    pub fn add_sharded_instance(
+        &mut self,
+        instance: v1::Instance,
+        mut annotations: InstanceAnnotations,
+        shard_size: usize,
+    ) -> Result<Digest> {
+        let (header, shards) = split_instance(instance, shard_size);
+        annotations.set_shards(shards.len());
+        let header = self.builder.add_layer(
+            media_types::v1_instance_header(),
+            &header.encode_to_vec(),
+            annotations.into(),
+        )?;
+        let header = Digest::new(header.digest())?;
+        let blobs: Vec<Vec<u8>> = shards
+            .par_iter()
+            .map(|shard| shard.encode_to_vec())
+            .collect();
+        for (index, blob) in blobs.iter().enumerate() {
+            let mut annotations = InstanceShardAnnotations::default();
+            annotations.set_header(&header);
+            annotations.set_index(index);
+            self.builder
+                .add_layer(media_types::v1_instance_shard(), blob, annotations.into())?;
+        }
+        Ok(header)
+    }
+
+    /// Add the state as [`application/org.ommx.v1.solution`][media_types::v1_solution].
+    /// Use [v1::State::into_dense] before this to store the state of contiguous IDs in the smaller dense form.
     pub fn add_solution(
         &mut self,
         solution: v1::State,
         annotations: SolutionAnnotations,
     ) -> Result<()> {
         let blob = solution.encode_to_vec();
-        self.0
+        self.builder
             .add_layer(media_types::v1_solution(), &blob, annotations.into())?;
         Ok(())
     }
 
     pub fn add_config(&mut self, config: Config) -> Result<()> {
         let blob = serde_json::to_string_pretty(&config)?;
-        self.0
+        self.builder
             .add_config(media_types::v1_config(), blob.as_bytes(), HashMap::new())?;
         Ok(())
     }
 
+    #[tracing::instrument(skip_all)]
     pub fn build(self) -> Result<Artifact<Base::Image>> {
-        Artifact::new(self.0.build()?)
+        let mut artifact = Artifact::new(self.builder.build()?)?;
+        if let Some(dir) = &self.local_dir {
+            BlobStore::local()?.deduplicate(dir)?;
+            LocalIndex::record(&artifact.get_name()?, &artifact.get_manifest()?)?;
+        }
+        Ok(artifact)
     }
 }
@@ -0,0 +1,13 @@
+use super::Config;
+use ocipkg::oci_spec::image::ImageManifest;
+
+/// Manifest and config parsed at the first access, kept in [super::Artifact]
+///
+/// This is not stored on disk even for a remote image referred by digest.
+/// [ocipkg] returns only the parsed manifest, whose serialization may differ from the bytes the digest is computed from,
+/// and thus a manifest read from disk could not be verified against the digest.
+#[derive(Debug, Default)]
+pub(super) struct ManifestCache {
+    pub manifest: Option<ImageManifest>,
+    pub config: Option<Config>,
+}
@@ -0,0 +1,88 @@
+use crate::v1;
+use anyhow::Result;
+use prost::Message;
+use std::io::{Read, Write};
+
+/// Compress the bytes by zstd of the given level
+///
+/// The size of the input is recorded in the frame header, so that [decompress_zstd] allocates the output at once.
+#[tracing::instrument(skip_all, fields(level, bytes = bytes.len()))]
+pub fn compress_zstd(bytes: &[u8], level: i32) -> Result<Vec<u8>> {
+    let mut encoder = zstd::stream::Encoder::new(Vec::new(), level)?;
+    encoder.set_pledged_src_size(Some(bytes.len() as u64))?;
+    encoder.write_all(bytes)?;
+    Ok(encoder.finish()?)
+}
+
+/// Upper bound of the ratio of the output size to the blob size allocated in advance by [decompress_zstd]
+const MAX_PREALLOCATION_RATIO: u64 = 32;
+
+/// Decompress the zstd stream
+///
+/// The blob is read by the streaming decoder, e.g. directly from the memory-mapped [super::Blob].
+/// The output is allocated in advance by the content size in the frame header,
+/// capped by [MAX_PREALLOCATION_RATIO] times the blob size since the header of a remote blob is not trusted.
+#[tracing::instrument(skip_all, fields(bytes = blob.len()))]
+pub fn decompress_zstd(blob: &[u8]) -> Result<Vec<u8>> {
+    let capacity = zstd::zstd_safe::get_frame_content_size(blob)
+        .ok()
+        .flatten()
+        .unwrap_or_default()
+        .min(blob.len() as u64 * MAX_PREALLOCATION_RATIO);
+    let mut buf = Vec::with_capacity(capacity as usize);
+    zstd::stream::Decoder::new(blob)?.read_to_end(&mut buf)?;
+    Ok(buf)
+}
+
+/// Encode the instance and compress it by zstd of the given level
+///
+/// The instance is encoded into a buffer before compression instead of being streamed into the encoder,
+/// since [prost] encodes only into a [prost::bytes::BufMut], not into [std::io::Write].
+pub fn encode_instance_zstd(instance: &v1::Instance, level: i32) -> Result<Vec<u8>> {
+    compress_zstd(&instance.encode_to_vec(), level)
+}
+
+/// Decompress the zstd stream and decode it as an instance
+///
+/// The whole message is decompressed before decoding
+/// since [prost] decodes from a contiguous buffer, and [v1::Instance::decode_parallel] splits it.
+pub fn decode_instance_zstd(blob: &[u8]) -> Result<v1::Instance> {
+    v1::Instance::decode_parallel(&decompress_zstd(blob)?)
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use crate::InstanceParameter;
+    use proptest::prelude::*;
+
+    proptest! {
+        #[test]
+        fn instance_round_trip(
+            instance in any::<InstanceParameter>().prop_flat_map(any_with::<v1::Instance>),
+            level in 1..=19,
+        ) {
+            let blob = encode_instance_zstd(&instance, level).unwrap();
+            prop_assert_eq!(decode_instance_zstd(&blob).unwrap(), instance);
+        }
+
+        #[test]
+        fn bytes_round_trip(bytes in proptest::collection::vec(any::<u8>(), 0..4096)) {
+            prop_assert_eq!(decompress_zstd(&compress_zstd(&bytes, 3).unwrap()).unwrap(), bytes);
+        }
+    }
+
+    #[test]
+    fn untrusted_content_size() {
+        // Frame header claiming 2^60 bytes of content, followed by an empty last block
+        let mut blob = vec![0x28, 0xb5, 0x2f, 0xfd, 0xe0];
+        blob.extend_from_slice(&(1_u64 << 60).to_le_bytes());
+        blob.extend_from_slice(&[0x01, 0x00, 0x00]);
+        assert!(matches!(
+            zstd::zstd_safe::get_frame_content_size(&blob),
+            Ok(Some(size)) if size == 1 << 60
+        ));
+        // The broken frame is an error instead of aborting by the allocation
+        assert!(decompress_zstd(&blob).is_err());
+    }
+}
@@ -0,0 +1,270 @@
+use super::{data_dir, gather_oci_dirs};
+use anyhow::{Context, Result};
+use ocipkg::{
+    image::{Image, OciArtifact},
+    oci_spec::image::{Descriptor, ImageManifest},
+    ImageName,
+};
+use serde::{Deserialize, Serialize};
+use std::{
+    collections::BTreeMap,
+    fs,
+    io::{Read, Seek, SeekFrom, Write},
+    path::{Path, PathBuf},
+};
+use uuid::Uuid;
+
+/// Image in the local registry recorded in [LocalIndex]
+#[derive(Debug, Clone, PartialEq, Serialize, Deserialize)]
+pub struct IndexEntry {
+    pub image_name: String,
+    /// Layers of the manifest including their annotations
+    pub layers: Vec<Descriptor>,
+}
+
+impl IndexEntry {
+    pub fn new(image_name: &ImageName, manifest: &ImageManifest) -> Self {
+        Self {
+            image_name: image_name.to_string(),
+            layers: manifest.layers().clone(),
+        }
+    }
+
+    /// Whether some layer has the annotation of the given key and value
+    pub fn has_annotation(&self, key: &str, value: &str) -> bool {
+        self.layers.iter().any(|layer| {
+            layer
+                .annotations()
+                .as_ref()
+                .and_then(|annotations| annotations.get(key))
+                .map_or(false, |v| v == value)
+        })
+    }
+}
+
+/// Index of the images in the local registry, stored as `{data_dir}/.index.jsonl`
+///
+/// Each line is an [IndexEntry] in JSON appended when an image is stored into the local registry by
+/// [Builder::new][super::Builder::new], [Artifact::pull][super::Artifact::pull] or [Artifact::load][super::Artifact::load].
+/// If an image appears in several lines, the last one is used.
+/// Images whose directory has been removed from the local registry are skipped when loading.
+/// The index is created by walking the local registry only when it does not exist, see [LocalIndex::rebuild].
+#[derive(Debug, Clone, PartialEq, Default)]
+pub struct LocalIndex {
+    entries: BTreeMap<String, IndexEntry>,
+}
+
+impl LocalIndex {
+    pub fn path() -> Result<PathBuf> {
+        Ok(data_dir()?.join(".index.jsonl"))
+    }
+
+    /// Load the index, or rebuild it if it does not exist
+    ///
+    /// The last line is ignored if it is broken, since it is left by an append interrupted by another process.
+    pub fn load() -> Result<Self> {
+        Self::load_in(&data_dir()?)
+    }
+
+    /// Walk the local registry to re-create the index
+    pub fn rebuild() -> Result<Self> {
+        Self::rebuild_in(&data_dir()?)
+    }
+
+    /// Append the image to the index
+    pub fn record(image_name: &ImageName, manifest: &ImageManifest) -> Result<()> {
+        Self::record_in(&data_dir()?, &IndexEntry::new(image_name, manifest))
+    }
+
+    fn load_in(root: &Path) -> Result<Self> {
+        let path = root.join(".index.jsonl");
+        if !path.exists() {
+            return Self::rebuild_in(root);
+        }
+        // Read as bytes since a torn line may end in the middle of a UTF-8 character
+        let buf = fs::read(&path)?;
+        let lines: Vec<&[u8]> = buf
+            .split(|b| *b == b'\n')
+            .filter(|line| !line.trim_ascii().is_empty())
+            .collect();
+        let mut entries = BTreeMap::new();
+        for (i, line) in lines.iter().enumerate() {
+            let entry: IndexEntry = match serde_json::from_slice(line) {
+                Ok(entry) => entry,
+                Err(e) if i + 1 == lines.len() => {
+                    log::warn!("Ignore the torn last line of {}: {}", path.display(), e);
+                    continue;
+                }
+                Err(e) => {
+                    return Err(e).with_context(|| format!("Broken index: {}", path.display()))
+                }
+            };
+            entries.insert(entry.image_name.clone(), entry);
+        }
+        entries.retain(|name, _| {
+            ImageName::parse(name).map_or(false, |name| root.join(name.as_path()).is_dir())
+        });
+        Ok(Self { entries })
+    }
+
+    /// Lock shared by the writers of the index across threads and processes
+    ///
+    /// A separate file is locked instead of the index itself, since [LocalIndex::rebuild] replaces the index file.
+    fn lock(root: &Path) -> Result<fs::File> {
+        fs::create_dir_all(root)?;
+        let lock = fs::OpenOptions::new()
+            .create(true)
+            .truncate(false)
+            .write(true)
+            .open(root.join(".index.lock"))?;
+        lock.lock()?;
+        Ok(lock)
+    }
+
+    fn rebuild_in(root: &Path) -> Result<Self> {
+        let _lock = Self::lock(root)?;
+        Self::rebuild_locked(root)
+    }
+
+    fn rebuild_locked(root: &Path) -> Result<Self> {
+        let mut entries = BTreeMap::new();
+        for dir in gather_oci_dirs(root)? {
+            let relative = dir
+                .strip_prefix(root)
+                .context("Failed to get relative path")?;
+            let image_name = ImageName::from_path(relative)?;
+            let manifest = OciArtifact::from_oci_dir(&dir)?.get_manifest()?;
+            let entry = IndexEntry::new(&image_name, &manifest);
+            entries.insert(entry.image_name.clone(), entry);
+        }
+        let mut out = String::new();
+        for entry in entries.values() {
+            out += &serde_json::to_string(entry)?;
+            out.push('\n');
+        }
+        // Replace the index at once to avoid leaving a partial index.
+        // The temporary file is unique in case the lock is not effective, e.g. on some network file systems.
+        let path = root.join(".index.jsonl");
+        let tmp = root.join(format!(".index.jsonl.{}.tmp", Uuid::new_v4()));
+        fs::write(&tmp, out)?;
+        fs::rename(&tmp, &path)?;
+        Ok(Self { entries })
+    }
+
+    fn record_in(root: &Path, entry: &IndexEntry) -> Result<()> {
+        let _lock = Self::lock(root)?;
+        let path = root.join(".index.jsonl");
+        if !path.exists() {
+            // The index is created by a walk including this image
+            Self::rebuild_locked(root)?;
+            return Ok(());
+        }
+        let mut file = fs::OpenOptions::new().read(true).append(true).open(&path)?;
+        // Truncate the torn last line left by an interrupted append, not to break this entry too.
+        // Appends of other writers are not in progress since they hold the lock.
+        let len = file.metadata()?.len();
+        if len > 0 {
+            let mut last = [0u8];
+            file.seek(SeekFrom::Start(len - 1))?;
+            file.read_exact(&mut last)?;
+            if last[0] != b'\n' {
+                let mut buf = Vec::new();
+                file.seek(SeekFrom::Start(0))?;
+                file.read_to_end(&mut buf)?;
+                let keep = buf.iter().rposition(|b| *b == b'\n').map_or(0, |i| i + 1);
+                file.set_len(keep as u64)?;
+            }
+        }
+        let mut line = serde_json::to_string(entry)?;
+        line.push('\n');
+        file.write_all(line.as_bytes())?;
+        Ok(())
+    }
+
+    pub fn entries(&self) -> impl Iterator<Item = &IndexEntry> {
+        self.entries.values()
+    }
+
+    pub fn get(&self, image_name: &ImageName) -> Option<&IndexEntry> {
+        self.entries.get(&image_name.to_string())
+    }
+
+    /// Images whose name starts with `prefix`, e.g. `ghcr.io/jij-inc/`
+    pub fn find_by_prefix<'a>(&'a self, prefix: &'a str) -> impl Iterator<Item = &'a IndexEntry> {
+        self.entries
+            .range(prefix.to_string()..)
+            .take_while(move |(name, _)| name.starts_with(prefix))
+            .map(|(_, entry)| entry)
+    }
+
+    /// Images having a layer with the annotation, e.g. `org.ommx.v1.instance.title`
+    pub fn find_by_annotation<'a>(
+        &'a self,
+        key: &'a str,
+        value: &'a str,
+    ) -> impl Iterator<Item = &'a IndexEntry> {
+        self.entries
+            .values()
+            .filter(move |entry| entry.has_annotation(key, value))
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    fn entry(root: &Path, name: &str) -> IndexEntry {
+        let image_name = ImageName::parse(name).unwrap();
+        // Entries are kept only if the image directories exist
+        fs::create_dir_all(root.join(image_name.as_path())).unwrap();
+        IndexEntry {
+            image_name: image_name.to_string(),
+            layers: Vec::new(),
+        }
+    }
+
+    fn names(index: &LocalIndex) -> Vec<&str> {
+        index.entries().map(|e| e.image_name.as_str()).collect()
+    }
+
+    #[test]
+    fn torn_last_line() {
+        let root = std::env::temp_dir().join(format!("ommx-index-{}", Uuid::new_v4()));
+        fs::create_dir_all(&root).unwrap();
+        let path = root.join(".index.jsonl");
+        fs::write(&path, "").unwrap();
+        let a = entry(&root, "ghcr.io/jij-inc/ommx/a:v1");
+        let b = entry(&root, "ghcr.io/jij-inc/ommx/b:v1");
+
+        LocalIndex::record_in(&root, &a).unwrap();
+        // Append interrupted in the middle of a line
+        let mut file = fs::OpenOptions::new().append(true).open(&path).unwrap();
+        file.write_all(br#"{"image_name":"ghcr.io/jij-"#).unwrap();
+        assert_eq!(
+            names(&LocalIndex::load_in(&root).unwrap()),
+            [a.image_name.as_str()]
+        );
+
+        // The torn line is truncated before appending
+        LocalIndex::record_in(&root, &b).unwrap();
+        assert_eq!(fs::read_to_string(&path).unwrap().lines().count(), 2);
+        assert_eq!(
+            names(&LocalIndex::load_in(&root).unwrap()),
+            [a.image_name.as_str(), b.image_name.as_str()]
+        );
+
+        // Removed images are skipped
+        fs::remove_dir_all(root.join(ImageName::parse(&a.image_name).unwrap().as_path())).unwrap();
+        assert_eq!(
+            names(&LocalIndex::load_in(&root).unwrap()),
+            [b.image_name.as_str()]
+        );
+
+        // Broken lines other than the last one are errors
+        let content = fs::read_to_string(&path).unwrap();
+        fs::write(&path, format!("{{\n{content}")).unwrap();
+        assert!(LocalIndex::load_in(&root).is_err());
+
+        fs::remove_dir_all(&root).unwrap();
+    }
+}
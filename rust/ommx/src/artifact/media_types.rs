@@ -19,3 +19,26 @@ pub fn v1_instance() -> MediaType {
 pub fn v1_solution() -> MediaType {
     MediaType::Other("application/org.ommx.v1.solution".to_string())
 }
+
+/// Media type of the layer storing [crate::v1::Instance] compressed by zstd, `application/org.ommx.v1.instance+zstd`
+///
+/// This layer has the same annotations as [v1_instance].
+pub fn v1_instance_zstd() -> MediaType {
+    MediaType::Other("application/org.ommx.v1.instance+zstd".to_string())
+}
+
+/// Media type of the header layer of a sharded [crate::v1::Instance], `application/org.ommx.v1.instance.header`
+///
+/// The header is an [crate::v1::Instance] without constraints and decision variables,
+/// which are stored in the [v1_instance_shard] layers. This layer has the same annotations as [v1_instance].
+pub fn v1_instance_header() -> MediaType {
+    MediaType::Other("application/org.ommx.v1.instance.header".to_string())
+}
+
+/// Media type of the shard layer of a sharded [crate::v1::Instance] with [crate::artifact::InstanceShardAnnotations], `application/org.ommx.v1.instance.shard`
+///
+/// A shard is an [crate::v1::Instance] storing only a part of constraints and decision variables.
+/// Since repeated fields of protobuf messages are concatenated by merging, the header merged with all shards in order is the original instance.
+pub fn v1_instance_shard() -> MediaType {
+    MediaType::Other("application/org.ommx.v1.instance.shard".to_string())
+}
@@ -0,0 +1,203 @@
+use anyhow::{Context, Result};
+use memmap2::Mmap;
+use ocipkg::Digest;
+use std::{
+    collections::HashMap,
+    fs::File,
+    ops::{Deref, Range},
+    path::{Component, Path, PathBuf},
+    sync::Arc,
+};
+
+/// Blob read from an artifact, which is memory-mapped if possible
+///
+/// This dereferences to `[u8]`, and thus can be decoded directly by [prost::Message::decode]
+/// without copying the blob into a [Vec].
+#[derive(Debug, Clone)]
+pub enum Blob {
+    Owned(Vec<u8>),
+    Mapped {
+        mmap: Arc<Mmap>,
+        range: Range<usize>,
+    },
+}
+
+impl Deref for Blob {
+    type Target = [u8];
+    fn deref(&self) -> &[u8] {
+        match self {
+            Blob::Owned(blob) => blob,
+            Blob::Mapped { mmap, range } => &mmap[range.clone()],
+        }
+    }
+}
+
+impl AsRef<[u8]> for Blob {
+    fn as_ref(&self) -> &[u8] {
+        self
+    }
+}
+
+impl From<Vec<u8>> for Blob {
+    fn from(blob: Vec<u8>) -> Self {
+        Blob::Owned(blob)
+    }
+}
+
+/// Memory maps of blobs in an OCI archive or an OCI directory
+///
+/// The files must not be modified while they are mapped, as the usual restriction of memory-mapped files.
+#[derive(Debug)]
+pub enum BlobMap {
+    /// Whole archive is mapped, and each blob is a range of it since tar stores files without compression
+    Archive {
+        mmap: Arc<Mmap>,
+        /// Digest to the range in the archive
+        index: HashMap<String, Range<usize>>,
+    },
+    /// Each blob file is mapped on demand
+    Dir { root: PathBuf },
+}
+
+fn open_mmap(path: &Path) -> Result<Mmap> {
+    let file = File::open(path).with_context(|| format!("Failed to open {}", path.display()))?;
+    // SAFETY: The file is opened as read-only, and assumed not to be modified while mapped
+    let mmap =
+        unsafe { Mmap::map(&file) }.with_context(|| format!("Failed to map {}", path.display()))?;
+    Ok(mmap)
+}
+
+/// Digest `{algorithm}:{encoded}` from the path `blobs/{algorithm}/{encoded}`
+fn digest_from_blob_path(path: &Path) -> Option<String> {
+    let components: Vec<&str> = path
+        .components()
+        .filter_map(|c| match c {
+            Component::Normal(name) => name.to_str(),
+            _ => None,
+        })
+        .collect();
+    match components.as_slice() {
+        ["blobs", algorithm, encoded] => Some(format!("{algorithm}:{encoded}")),
+        _ => None,
+    }
+}
+
+impl BlobMap {
+    /// Map an OCI archive and index the blobs in it
+    pub fn from_oci_archive(path: &Path) -> Result<Self> {
+        let mmap = open_mmap(path)?;
+        let mut index = HashMap::new();
+        let mut archive = tar::Archive::new(&mmap[..]);
+        for entry in archive.entries()? {
+            let entry = entry?;
+            if let Some(digest) = digest_from_blob_path(&entry.path()?) {
+                let start = entry.raw_file_position() as usize;
+                let end = start + entry.size() as usize;
+                index.insert(digest, start..end);
+            }
+        }
+        Ok(BlobMap::Archive {
+            mmap: Arc::new(mmap),
+            index,
+        })
+    }
+
+    pub fn from_oci_dir(path: &Path) -> Result<Self> {
+        Ok(BlobMap::Dir {
+            root: path.to_path_buf(),
+        })
+    }
+
+    pub fn get_blob(&self, digest: &Digest) -> Result<Blob> {
+        let digest = digest.to_string();
+        match self {
+            BlobMap::Archive { mmap, index } => {
+                let range = index
+                    .get(&digest)
+                    .with_context(|| format!("Blob of digest {} not found", digest))?;
+                Ok(Blob::Mapped {
+                    mmap: mmap.clone(),
+                    range: range.clone(),
+                })
+            }
+            BlobMap::Dir { root } => {
+                let (algorithm, encoded) = digest
+                    .split_once(':')
+                    .with_context(|| format!("Invalid digest: {}", digest))?;
+                let mmap = open_mmap(&root.join("blobs").join(algorithm).join(encoded))?;
+                let range = 0..mmap.len();
+                Ok(Blob::Mapped {
+                    mmap: Arc::new(mmap),
+                    range,
+                })
+            }
+        }
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    const ENCODED: &str = "6b86b273ff34fce19d6b804eff5a3f5747ada4eaa22f1d49c01e52ddb7875b4b";
+
+    #[test]
+    fn digest_from_path() {
+        let digest = |path: &str| digest_from_blob_path(Path::new(path));
+        assert_eq!(
+            digest(&format!("blobs/sha256/{ENCODED}")),
+            Some(format!("sha256:{ENCODED}"))
+        );
+        // tar entries may start with `./`
+        assert_eq!(
+            digest(&format!("./blobs/sha256/{ENCODED}")),
+            Some(format!("sha256:{ENCODED}"))
+        );
+        assert_eq!(digest("blobs/sha256"), None);
+        assert_eq!(digest("index.json"), None);
+        assert_eq!(digest(&format!("other/sha256/{ENCODED}")), None);
+    }
+
+    #[test]
+    fn archive_and_dir() {
+        let root = std::env::temp_dir().join(format!("ommx-mmap-{}", uuid::Uuid::new_v4()));
+        std::fs::create_dir_all(root.join("dir/blobs/sha256")).unwrap();
+        let blob = b"blob content".to_vec();
+        let digest = Digest::new(&format!("sha256:{ENCODED}")).unwrap();
+
+        let archive = root.join("artifact.ommx");
+        let mut builder = tar::Builder::new(File::create(&archive).unwrap());
+        for (path, data) in [
+            ("oci-layout".to_string(), &b"{}"[..]),
+            (format!("blobs/sha256/{ENCODED}"), &blob[..]),
+        ] {
+            let mut header = tar::Header::new_gnu();
+            header.set_size(data.len() as u64);
+            header.set_mode(0o644);
+            header.set_cksum();
+            builder.append_data(&mut header, path, data).unwrap();
+        }
+        builder.finish().unwrap();
+        drop(builder);
+
+        let map = BlobMap::from_oci_archive(&archive).unwrap();
+        match &map {
+            BlobMap::Archive { index, .. } => assert_eq!(index.len(), 1),
+            BlobMap::Dir { .. } => unreachable!(),
+        }
+        assert_eq!(&*map.get_blob(&digest).unwrap(), &blob[..]);
+
+        std::fs::write(root.join(format!("dir/blobs/sha256/{ENCODED}")), &blob).unwrap();
+        let map = BlobMap::from_oci_dir(&root.join("dir")).unwrap();
+        assert_eq!(&*map.get_blob(&digest).unwrap(), &blob[..]);
+
+        let missing = Digest::new(&format!("sha256:{}", "0".repeat(64))).unwrap();
+        assert!(map.get_blob(&missing).is_err());
+        assert!(BlobMap::from_oci_archive(&archive)
+            .unwrap()
+            .get_blob(&missing)
+            .is_err());
+
+        std::fs::remove_dir_all(&root).unwrap();
+    }
+}
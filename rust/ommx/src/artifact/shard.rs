@@ -0,0 +1,202 @@
+use super::{media_types, Artifact, Blob, InstanceAnnotations, InstanceShardAnnotations};
+use crate::v1;
+use anyhow::{ensure, Context, Result};
+use ocipkg::{image::Image, oci_spec::image::Descriptor, Digest};
+use prost::Message;
+use rayon::prelude::*;
+
+/// Split the instance into the header and shards of [`application/org.ommx.v1.instance.shard`][media_types::v1_instance_shard]
+///
+/// Each shard has at most `shard_size` constraints, and decision variables are split into the same number of shards.
+/// The header keeps the other fields, i.e. description, objective and sense.
+pub fn split_instance(
+    mut instance: v1::Instance,
+    shard_size: usize,
+) -> (v1::Instance, Vec<v1::Instance>) {
+    let shard_size = shard_size.max(1);
+    let constraints = std::mem::take(&mut instance.constraints);
+    let decision_variables = std::mem::take(&mut instance.decision_variables);
+    let num_shards = constraints.len().div_ceil(shard_size).max(1);
+    let dv_size = decision_variables.len().div_ceil(num_shards).max(1);
+
+    // Move the elements into the shards instead of cloning them
+    let mut constraints = constraints.into_iter();
+    let mut decision_variables = decision_variables.into_iter();
+    let shards = (0..num_shards)
+        .map(|_| v1::Instance {
+            constraints: constraints.by_ref().take(shard_size).collect(),
+            decision_variables: decision_variables.by_ref().take(dv_size).collect(),
+            ..Default::default()
+        })
+        .collect();
+    (instance, shards)
+}
+
+/// Merge the header and shards in order into the original instance
+pub fn merge_instance_shards(
+    mut header: v1::Instance,
+    shards: impl IntoIterator<Item = v1::Instance>,
+) -> v1::Instance {
+    for mut shard in shards {
+        header.constraints.append(&mut shard.constraints);
+        header
+            .decision_variables
+            .append(&mut shard.decision_variables);
+    }
+    header
+}
+
+impl<Base: Image> Artifact<Base> {
+    /// Descriptors of the shards of the header, sorted by [InstanceShardAnnotations::index]
+    fn shard_descriptors(&mut self, header: &Descriptor) -> Result<Vec<Descriptor>> {
+        let num_shards = InstanceAnnotations::from_descriptor(header).shards()?;
+        let mut shards = Vec::with_capacity(num_shards);
+        for desc in self.get_layer_descriptors(&media_types::v1_instance_shard())? {
+            let annotations = InstanceShardAnnotations::from_descriptor(&desc);
+            if annotations.header()?.to_string() == *header.digest() {
+                shards.push((annotations.index()?, desc));
+            }
+        }
+        shards.sort_by_key(|(index, _)| *index);
+        ensure!(
+            shards.iter().map(|(index, _)| *index).eq(0..num_shards),
+            "Shards of instance {} are broken: expected {} shards",
+            header.digest(),
+            num_shards
+        );
+        Ok(shards.into_iter().map(|(_, desc)| desc).collect())
+    }
+
+    fn find_instance_header(&mut self, header: &Digest) -> Result<Descriptor> {
+        self.find_layer_descriptor(&[media_types::v1_instance_header()], header)?
+            .with_context(|| format!("Instance header of digest {} not found", header))
+    }
+
+    /// Decode the header and its shards into the original instance
+    ///
+    /// Shards are read sequentially, which does not copy them when memory-mapped, and decoded in parallel.
+    pub(super) fn decode_sharded_instance(&mut self, header: &Descriptor) -> Result<v1::Instance> {
+        let blobs = self
+            .shard_descriptors(header)?
+            .iter()
+            .map(|desc| self.get_layer_blob(&Digest::new(desc.digest())?))
+            .collect::<Result<Vec<Blob>>>()?;
+        let shards = blobs
+            .par_iter()
+            .map(|blob| Ok(v1::Instance::decode(&**blob)?))
+            .collect::<Result<Vec<_>>>()?;
+        let header = v1::Instance::decode(&*self.get_layer_blob(&Digest::new(header.digest())?)?)?;
+        Ok(merge_instance_shards(header, shards))
+    }
+
+    /// Get the instance stored as [`application/org.ommx.v1.instance.header`][media_types::v1_instance_header] and its shards
+    ///
+    /// [Artifact::get_instance] also accepts the digest of the header.
+    pub fn get_sharded_instance(
+        &mut self,
+        header: &Digest,
+    ) -> Result<(v1::Instance, InstanceAnnotations)> {
+        let desc = self.find_instance_header(header)?;
+        let instance = self.decode_sharded_instance(&desc)?;
+        Ok((instance, InstanceAnnotations::from_descriptor(&desc)))
+    }
+
+    /// Get only the header of the sharded instance, i.e. without constraints and decision variables
+    pub fn get_instance_header(
+        &mut self,
+        header: &Digest,
+    ) -> Result<(v1::Instance, InstanceAnnotations)> {
+        let desc = self.find_instance_header(header)?;
+        let instance = v1::Instance::decode(&*self.get_layer_blob(header)?)?;
+        Ok((instance, InstanceAnnotations::from_descriptor(&desc)))
+    }
+
+    /// Get the `index`-th shard of the sharded instance without reading the others
+    pub fn get_instance_shard(&mut self, header: &Digest, index: usize) -> Result<v1::Instance> {
+        let desc = self.find_instance_header(header)?;
+        let shard = self
+            .shard_descriptors(&desc)?
+            .into_iter()
+            .nth(index)
+            .with_context(|| format!("Shard {} of instance {} not found", index, header))?;
+        Ok(v1::Instance::decode(
+            &*self.get_layer_blob(&Digest::new(shard.digest())?)?,
+        )?)
+    }
+
+    /// Lazy iterator over the shards of the sharded instance in order, which reads and decodes each shard on demand
+    ///
+    /// This never holds the whole instance, e.g. for evaluating the constraints shard by shard.
+    pub fn instance_shards(
+        &mut self,
+        header: &Digest,
+    ) -> Result<impl Iterator<Item = Result<v1::Instance>> + '_> {
+        let desc = self.find_instance_header(header)?;
+        let shards = self.shard_descriptors(&desc)?;
+        Ok(shards.into_iter().map(move |desc| {
+            let blob = self.get_layer_blob(&Digest::new(desc.digest())?)?;
+            Ok(v1::Instance::decode(&*blob)?)
+        }))
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use crate::{random::random_sparse_mip, InstanceParameter};
+    use proptest::prelude::*;
+    use rand::SeedableRng;
+
+    proptest! {
+        #[test]
+        fn split_merge_round_trip(
+            instance in any::<InstanceParameter>().prop_flat_map(any_with::<v1::Instance>),
+            shard_size in 0..12_usize,
+        ) {
+            let (header, shards) = split_instance(instance.clone(), shard_size);
+            prop_assert!(header.constraints.is_empty() && header.decision_variables.is_empty());
+            prop_assert_eq!(
+                shards.len(),
+                instance.constraints.len().div_ceil(shard_size.max(1)).max(1)
+            );
+            for shard in &shards {
+                prop_assert!(shard.constraints.len() <= shard_size.max(1));
+                prop_assert!(shard.objective.is_none());
+            }
+            prop_assert_eq!(merge_instance_shards(header, shards), instance);
+        }
+    }
+
+    #[test]
+    fn split_edge_cases() {
+        let mut rng = rand_xoshiro::Xoshiro256StarStar::seed_from_u64(0);
+
+        // More decision variables than constraints, and a shard size larger than the number of constraints
+        let instance = random_sparse_mip(&mut rng, 10, 3, 0.5, 0.5);
+        let (header, shards) = split_instance(instance.clone(), 5);
+        assert_eq!(shards.len(), 1);
+        assert_eq!(shards[0].constraints.len(), 3);
+        assert_eq!(shards[0].decision_variables.len(), 10);
+        assert_eq!(merge_instance_shards(header, shards), instance);
+
+        // Decision variables are spread over the shards of constraints
+        let (header, shards) = split_instance(instance.clone(), 1);
+        assert_eq!(shards.len(), 3);
+        assert_eq!(
+            shards
+                .iter()
+                .map(|s| s.decision_variables.len())
+                .collect::<Vec<_>>(),
+            [4, 4, 2]
+        );
+        assert_eq!(merge_instance_shards(header, shards), instance);
+
+        // No constraints, still with a shard for the decision variables
+        let instance = random_sparse_mip(&mut rng, 4, 0, 0.5, 0.5);
+        let (header, shards) = split_instance(instance.clone(), 2);
+        assert_eq!(shards.len(), 1);
+        assert!(shards[0].constraints.is_empty());
+        assert_eq!(shards[0].decision_variables.len(), 4);
+        assert_eq!(merge_instance_shards(header, shards), instance);
+    }
+}
@@ -0,0 +1,130 @@
+use super::{data_dir, gather_oci_dirs};
+use anyhow::{Context, Result};
+use ocipkg::Digest;
+use std::{
+    collections::BTreeSet,
+    fs,
+    path::{Path, PathBuf},
+};
+
+/// Content-addressed blob store shared by the images in the local registry
+///
+/// Blobs are stored in `{root}/{algorithm}/{encoded}`,
+/// and each image directory in the local registry holds hard links to them instead of its own copies.
+/// A blob is removed by [BlobStore::gc] when no image refers to it.
+#[derive(Debug, Clone, PartialEq)]
+pub struct BlobStore {
+    root: PathBuf,
+}
+
+/// Result of [BlobStore::gc]
+#[derive(Debug, Clone, PartialEq, Default)]
+pub struct GcReport {
+    pub removed_blobs: usize,
+    pub removed_bytes: u64,
+}
+
+/// Digests and paths of blob files `{algorithm}/{encoded}` in the `blobs` directory of OCI directory or [BlobStore]
+fn list_blobs(blobs: &Path) -> Result<Vec<(String, PathBuf)>> {
+    let mut out = Vec::new();
+    if !blobs.is_dir() {
+        return Ok(out);
+    }
+    for algorithm in fs::read_dir(blobs)? {
+        let algorithm = algorithm?;
+        if !algorithm.file_type()?.is_dir() {
+            continue;
+        }
+        for blob in fs::read_dir(algorithm.path())? {
+            let blob = blob?;
+            if !blob.file_type()?.is_file() {
+                continue;
+            }
+            let digest = format!(
+                "{}:{}",
+                algorithm.file_name().to_string_lossy(),
+                blob.file_name().to_string_lossy()
+            );
+            out.push((digest, blob.path()));
+        }
+    }
+    Ok(out)
+}
+
+impl BlobStore {
+    pub fn new(root: PathBuf) -> Self {
+        Self { root }
+    }
+
+    /// Store of the local registry, `{data_dir}/.blobs`
+    ///
+    /// The directory starts with `.` to be ignored in [get_images][super::get_images],
+    /// since image names never have such a path component.
+    pub fn local() -> Result<Self> {
+        Ok(Self::new(data_dir()?.join(".blobs")))
+    }
+
+    pub fn root(&self) -> &Path {
+        &self.root
+    }
+
+    fn path_of_digest(&self, digest: &str) -> Result<PathBuf> {
+        let (algorithm, encoded) = digest
+            .split_once(':')
+            .with_context(|| format!("Invalid digest: {}", digest))?;
+        Ok(self.root.join(algorithm).join(encoded))
+    }
+
+    pub fn path(&self, digest: &Digest) -> Result<PathBuf> {
+        self.path_of_digest(&digest.to_string())
+    }
+
+    pub fn contains(&self, digest: &Digest) -> bool {
+        self.path(digest).map(|p| p.is_file()).unwrap_or(false)
+    }
+
+    /// Replace the blobs in the OCI directory by hard links to this store, adding blobs missing in the store.
+    ///
+    /// Blobs which cannot be linked, e.g. when the store is on another file system, are left as they are.
+    pub fn deduplicate(&self, oci_dir: &Path) -> Result<()> {
+        for (digest, path) in list_blobs(&oci_dir.join("blobs"))? {
+            let stored = self.path_of_digest(&digest)?;
+            let result = if stored.is_file() {
+                // Link via a temporary file to replace the blob atomically
+                let tmp = path.with_extension("link");
+                fs::hard_link(&stored, &tmp).and_then(|_| fs::rename(&tmp, &path))
+            } else {
+                fs::create_dir_all(stored.parent().context("Invalid store path")?)?;
+                fs::hard_link(&path, &stored)
+            };
+            if let Err(e) = result {
+                log::warn!("Failed to link blob {} into the store: {}", digest, e);
+            }
+        }
+        Ok(())
+    }
+
+    /// Remove blobs which are not referred from any image in the local registry
+    pub fn gc(&self) -> Result<GcReport> {
+        let mut referred = BTreeSet::new();
+        let data_dir = data_dir()?;
+        if !data_dir.is_dir() {
+            return Ok(GcReport::default());
+        }
+        for dir in gather_oci_dirs(&data_dir)? {
+            for (digest, _) in list_blobs(&dir.join("blobs"))? {
+                referred.insert(digest);
+            }
+        }
+        let mut report = GcReport::default();
+        for (digest, path) in list_blobs(&self.root)? {
+            if referred.contains(&digest) {
+                continue;
+            }
+            report.removed_bytes += fs::metadata(&path)?.len();
+            report.removed_blobs += 1;
+            fs::remove_file(&path)?;
+        }
+        Ok(report)
+    }
+}
@@ -0,0 +1,303 @@
+use super::{auth_from_env, image_dir, Artifact, BlobStore, LocalIndex};
+use anyhow::{ensure, Context, Result};
+use ocipkg::{
+    image::{Image, ImageBuilder, OciArtifact, OciDir, OciDirBuilder, Remote, RemoteBuilder},
+    oci_spec::image::{Descriptor, ImageManifest},
+    Digest, ImageName,
+};
+use rayon::prelude::*;
+use std::{
+    ops::DerefMut,
+    path::{Path, PathBuf},
+    sync::atomic::{AtomicUsize, Ordering},
+};
+
+/// Progress of [Artifact::push_with] and [Artifact::pull_with], reported for each blob
+#[derive(Debug, Clone, PartialEq)]
+pub struct TransferProgress {
+    pub digest: String,
+    pub size: u64,
+    /// `true` if the blob is not downloaded since it is found in the [BlobStore] or in the staging directory of the previous, interrupted pull
+    pub skipped: bool,
+    /// Number of blobs transferred or skipped, including this one
+    pub completed: usize,
+    pub total: usize,
+}
+
+/// Options of [Artifact::push_with] and [Artifact::pull_with]
+#[derive(Clone, Copy)]
+pub struct TransferOptions<'a> {
+    /// Number of blobs transferred concurrently
+    pub jobs: usize,
+    pub progress: Option<&'a (dyn Fn(&TransferProgress) + Sync)>,
+}
+
+impl Default for TransferOptions<'_> {
+    fn default() -> Self {
+        Self {
+            jobs: 4,
+            progress: None,
+        }
+    }
+}
+
+/// Layers and config of the manifest, deduplicated by digest
+fn blob_descriptors(manifest: &ImageManifest) -> Vec<Descriptor> {
+    let mut out: Vec<Descriptor> = Vec::new();
+    for desc in manifest.layers().iter().chain([manifest.config()]) {
+        if out.iter().all(|d| d.digest() != desc.digest()) {
+            out.push(desc.clone());
+        }
+    }
+    out
+}
+
+fn thread_pool(jobs: usize) -> Result<rayon::ThreadPool> {
+    Ok(rayon::ThreadPoolBuilder::new()
+        .num_threads(jobs.max(1))
+        .build()?)
+}
+
+/// Reports [TransferProgress] from worker threads
+struct Reporter<'a> {
+    options: &'a TransferOptions<'a>,
+    completed: AtomicUsize,
+    total: usize,
+}
+
+impl<'a> Reporter<'a> {
+    fn new(options: &'a TransferOptions<'a>, total: usize) -> Self {
+        Self {
+            options,
+            completed: AtomicUsize::new(0),
+            total,
+        }
+    }
+
+    fn report(&self, desc: &Descriptor, skipped: bool) {
+        let completed = self.completed.fetch_add(1, Ordering::Relaxed) + 1;
+        if let Some(progress) = self.options.progress {
+            progress(&TransferProgress {
+                digest: desc.digest().to_string(),
+                size: desc.size() as u64,
+                skipped,
+                completed,
+                total: self.total,
+            });
+        }
+    }
+}
+
+fn remote_builder(name: &ImageName) -> Result<RemoteBuilder> {
+    let mut remote = RemoteBuilder::new(name.clone())?;
+    if let Ok((domain, username, password)) = auth_from_env() {
+        remote.add_basic_auth(&domain, &username, &password);
+    }
+    Ok(remote)
+}
+
+fn remote(name: &ImageName) -> Result<OciArtifact<Remote>> {
+    let mut remote = OciArtifact::from_remote(name.clone())?;
+    if let Ok((domain, username, password)) = auth_from_env() {
+        remote.add_basic_auth(&domain, &username, &password);
+    }
+    Ok(remote)
+}
+
+/// Directory to assemble the OCI directory during [Artifact::pull_with], which is kept if the pull is interrupted
+fn staging_dir(path: &Path) -> PathBuf {
+    let mut name = path.file_name().unwrap_or_default().to_os_string();
+    name.push(".partial");
+    path.with_file_name(name)
+}
+
+/// File locked during [Artifact::pull_with] to serialize the pulls of the same image across threads and processes
+///
+/// The file is kept after the pull, since removing it races with another pull waiting for the lock.
+fn lock_path(path: &Path) -> PathBuf {
+    let mut name = path.file_name().unwrap_or_default().to_os_string();
+    name.push(".lock");
+    path.with_file_name(name)
+}
+
+/// Path of the blob in the OCI directory layout, `{root}/blobs/{algorithm}/{encoded}`
+fn blob_path(root: &Path, digest: &Digest) -> PathBuf {
+    let digest = digest.to_string();
+    root.join("blobs").join(digest.replace(':', "/"))
+}
+
+/// Whether the blob has been staged by the previous pull
+///
+/// Blobs are verified before being renamed into the staging directory,
+/// so that the size is enough to detect a broken file without hashing it again.
+fn is_staged(path: &Path, desc: &Descriptor) -> bool {
+    std::fs::metadata(path)
+        .map(|m| m.is_file() && m.len() == desc.size() as u64)
+        .unwrap_or(false)
+}
+
+/// Hard link the blob in [BlobStore] into the staging directory, or copy it if it cannot be linked
+fn link_staged(stored: &Path, target: &Path) -> Result<()> {
+    std::fs::create_dir_all(target.parent().context("Invalid staging path")?)?;
+    if std::fs::hard_link(stored, target).is_err() {
+        let tmp = target.with_extension("tmp");
+        std::fs::copy(stored, &tmp)?;
+        std::fs::rename(&tmp, target)?;
+    }
+    Ok(())
+}
+
+/// Write `oci-layout`, `index.json` and the manifest blob into the staging directory
+///
+/// They are built by [OciDirBuilder] in a sub-directory and moved into `staging`,
+/// since [OciDirBuilder] requires a new directory.
+fn finish_staging(staging: &Path, image_name: &ImageName, manifest: ImageManifest) -> Result<()> {
+    let skeleton = staging.join(".skeleton");
+    if skeleton.exists() {
+        std::fs::remove_dir_all(&skeleton)?;
+    }
+    OciDirBuilder::new(skeleton.clone(), image_name.clone())?.build(manifest)?;
+    for path in walk_files(&skeleton)? {
+        let target = staging.join(path.strip_prefix(&skeleton)?);
+        std::fs::create_dir_all(target.parent().context("Invalid staging path")?)?;
+        std::fs::rename(&path, &target)?;
+    }
+    std::fs::remove_dir_all(&skeleton)?;
+    Ok(())
+}
+
+/// Files under `dir` recursively
+fn walk_files(dir: &Path) -> Result<Vec<PathBuf>> {
+    let mut out = Vec::new();
+    for entry in std::fs::read_dir(dir)? {
+        let entry = entry?;
+        if entry.file_type()?.is_dir() {
+            out.append(&mut walk_files(&entry.path())?);
+        } else {
+            out.push(entry.path());
+        }
+    }
+    Ok(out)
+}
+
+impl<Base: Image> Artifact<Base> {
+    /// Push blobs concurrently, and then the manifest.
+    ///
+    /// Blobs are read through the memory map shared by the workers, each of which has its own connection to the registry.
+    /// Falls back to [ocipkg::image::copy] if the blobs are not memory-mapped.
+    #[tracing::instrument(skip_all, fields(jobs = options.jobs))]
+    pub fn push_with(&mut self, options: &TransferOptions) -> Result<Artifact<Remote>> {
+        let name = self.0.get_name()?;
+        log::info!("Pushing: {}", name);
+        if self.1.is_none() {
+            let out = ocipkg::image::copy(self.0.deref_mut(), remote_builder(&name)?)?;
+            return Artifact::new(OciArtifact::new(out));
+        }
+        let manifest = self.raw_manifest()?.clone();
+        let blobs = self.1.as_ref().unwrap();
+        let descriptors = blob_descriptors(&manifest);
+        let reporter = Reporter::new(options, descriptors.len());
+        thread_pool(options.jobs)?.install(|| {
+            descriptors.par_iter().try_for_each_init(
+                || remote_builder(&name),
+                |remote, desc| -> Result<()> {
+                    let _span =
+                        tracing::info_span!("push_blob", digest = %desc.digest(), bytes = desc.size())
+                            .entered();
+                    let remote = remote.as_mut().map_err(|e| anyhow::anyhow!("{e:#}"))?;
+                    let blob = blobs.get_blob(&Digest::new(desc.digest())?)?;
+                    remote.add_blob(&blob)?;
+                    reporter.report(desc, false);
+                    Ok(())
+                },
+            )
+        })?;
+        let out = remote_builder(&name)?.build(manifest)?;
+        Artifact::new(OciArtifact::new(out))
+    }
+}
+
+impl Artifact<Remote> {
+    /// Download blobs concurrently into the local registry
+    ///
+    /// The OCI directory is assembled in a staging directory next to [image_dir],
+    /// and renamed to [image_dir] at once when all blobs are ready,
+    /// so that an interrupted pull never leaves an incomplete image in the local registry.
+    /// The staging directory is kept when the pull is interrupted,
+    /// and the next pull skips the blobs which are already downloaded.
+    /// Blobs already in the shared [BlobStore] are linked instead of being downloaded.
+    ///
+    /// Concurrent pulls of the same image wait for the first one through a lock file next to [image_dir],
+    /// and then open the pulled image instead of sharing the staging directory.
+    #[tracing::instrument(skip_all, fields(jobs = options.jobs))]
+    pub fn pull_with(&mut self, options: &TransferOptions) -> Result<Artifact<OciDir>> {
+        let image_name = self.get_name()?;
+        let path = image_dir(&image_name)?;
+        if path.exists() {
+            log::trace!("Already exists in locally: {}", path.display());
+            return Artifact::from_oci_dir(&path);
+        }
+        std::fs::create_dir_all(path.parent().context("Invalid image directory")?)?;
+        let lock = std::fs::OpenOptions::new()
+            .create(true)
+            .truncate(false)
+            .write(true)
+            .open(lock_path(&path))?;
+        lock.lock()?;
+        if path.exists() {
+            log::trace!("Pulled by another process: {}", path.display());
+            return Artifact::from_oci_dir(&path);
+        }
+        log::info!("Pulling: {}", image_name);
+        if let Ok((domain, username, password)) = auth_from_env() {
+            self.0.add_basic_auth(&domain, &username, &password);
+        }
+        let manifest = self.raw_manifest()?.clone();
+        let descriptors = blob_descriptors(&manifest);
+        let staging = staging_dir(&path);
+        let store = BlobStore::local()?;
+        let reporter = Reporter::new(options, descriptors.len());
+        thread_pool(options.jobs)?.install(|| {
+            descriptors.par_iter().try_for_each_init(
+                || remote(&image_name),
+                |remote, desc| -> Result<()> {
+                    let digest = Digest::new(desc.digest())?;
+                    let target = blob_path(&staging, &digest);
+                    if is_staged(&target, desc) {
+                        reporter.report(desc, true);
+                        return Ok(());
+                    }
+                    if store.contains(&digest) {
+                        link_staged(&store.path(&digest)?, &target)?;
+                        reporter.report(desc, true);
+                        return Ok(());
+                    }
+                    let _span =
+                        tracing::info_span!("pull_blob", digest = %digest, bytes = desc.size())
+                            .entered();
+                    let remote = remote.as_mut().map_err(|e| anyhow::anyhow!("{e:#}"))?;
+                    let blob = remote.get_blob(&digest)?;
+                    ensure!(
+                        Digest::from_buf_sha256(&blob) == digest,
+                        "Digest mismatch of downloaded blob: {}",
+                        digest
+                    );
+                    let parent = target.parent().context("Invalid staging path")?;
+                    std::fs::create_dir_all(parent)?;
+                    // Write to a temporary file and rename it to avoid leaving a broken blob
+                    let tmp = target.with_extension("tmp");
+                    std::fs::write(&tmp, &blob)?;
+                    std::fs::rename(&tmp, &target)?;
+                    reporter.report(desc, false);
+                    Ok(())
+                },
+            )
+        })?;
+
+        finish_staging(&staging, &image_name, manifest.clone())?;
+        std::fs::rename(&staging, &path)?;
+        store.deduplicate(&path)?;
+        LocalIndex::record(&image_name, &manifest)?;
+        Artifact::from_oci_dir(&path)
+    }
+}
@@ -1,9 +1,15 @@
-use anyhow::{bail, Result};
-use clap::Parser;
+use anyhow::{bail, Context, Result};
+use clap::{Parser, Subcommand};
 use colored::Colorize;
-use ocipkg::{oci_spec::image::ImageManifest, ImageName};
-use ommx::artifact::{image_dir, Artifact};
+use ocipkg::{image::Image, oci_spec::image::ImageManifest, Digest, ImageName};
+use ommx::{
+    artifact::{image_dir, Artifact, BlobStore, LocalIndex, TransferOptions, TransferProgress},
+    format::{lp, mps},
+    profile::Profiler,
+    v1::Instance,
+};
 use std::path::{Path, PathBuf};
+use tracing_subscriber::layer::SubscriberExt;
 
 mod built_info {
     include!(concat!(env!("OUT_DIR"), "/built.rs"));
@@ -11,6 +17,16 @@ mod built_info {
 
 #[derive(Parser)]
 #[command(version, about, long_about = None)]
+struct Cli {
+    /// Print the timing breakdown of the operations to stderr after the command
+    #[clap(long, global = true)]
+    profile: bool,
+
+    #[command(subcommand)]
+    command: Command,
+}
+
+#[derive(Subcommand)]
 enum Command {
     /// Show the version
     Version,
@@ -33,16 +49,33 @@ enum Command {
         image_name_or_path: String,
     },
 
+    /// Write the instance in the image to MPS or CPLEX LP file, chosen by the extension of the output
+    Export {
+        /// Container image name or the path of OCI archive
+        image_name_or_path: String,
+        /// Output file name, `*.mps` or `*.lp`
+        output: PathBuf,
+        /// Digest of the instance layer. The first instance in the image is written if not given.
+        #[clap(long)]
+        digest: Option<String>,
+    },
+
     /// Push the image to remote registry
     Push {
         /// Path of OCI archive or the container image name stored in local registry
         image_name_or_path: String,
+        /// Number of blobs uploaded concurrently
+        #[clap(short, long, default_value_t = 4)]
+        jobs: usize,
     },
 
     /// Pull the image from remote registry
     Pull {
         /// Container image name in remote registry
         image_name: String,
+        /// Number of blobs downloaded concurrently
+        #[clap(short, long, default_value_t = 4)]
+        jobs: usize,
     },
 
     /// Load OCI archive into the local registry
@@ -60,13 +93,26 @@ enum Command {
     },
 
     /// List the images in the local registry
-    List,
+    List {
+        /// Show only the images whose name starts with the prefix, e.g. `ghcr.io/jij-inc/`
+        #[clap(long)]
+        prefix: Option<String>,
+        /// Show only the images having a layer with the annotation `KEY=VALUE`, e.g. `org.ommx.v1.instance.title=random_lp`
+        #[clap(long)]
+        annotation: Option<String>,
+        /// Re-create the index by walking the local registry
+        #[clap(long)]
+        reindex: bool,
+    },
 
     /// Get the directory where the image is stored
     ImageDirectory {
         /// Container image name
         image_name: String,
     },
+
+    /// Remove blobs in the shared blob store which are not referred from any image in the local registry
+    Gc,
 }
 
 enum ImageNameOrPath {
@@ -110,6 +156,47 @@ impl ImageNameOrPath {
         };
         Ok(manifest)
     }
+
+    fn get_instance(&self, digest: Option<&Digest>) -> Result<Instance> {
+        match self {
+            ImageNameOrPath::OciDir(path) => get_instance(Artifact::from_oci_dir(path)?, digest),
+            ImageNameOrPath::OciArchive(path) => {
+                get_instance(Artifact::from_oci_archive(path)?, digest)
+            }
+            ImageNameOrPath::Local(name) => {
+                get_instance(Artifact::from_oci_dir(&image_dir(name)?)?, digest)
+            }
+            ImageNameOrPath::Remote(name) => {
+                get_instance(Artifact::from_remote(name.clone())?, digest)
+            }
+        }
+    }
+}
+
+fn get_instance<Base: Image>(
+    mut artifact: Artifact<Base>,
+    digest: Option<&Digest>,
+) -> Result<Instance> {
+    if let Some(digest) = digest {
+        return Ok(artifact.get_instance(digest)?.0);
+    }
+    let (_, instance) = artifact
+        .instances()?
+        .next()
+        .context("No instance found in the image")??;
+    Ok(instance)
+}
+
+fn show_progress(progress: &TransferProgress) {
+    let status = if progress.skipped {
+        "Skipped".yellow().bold()
+    } else {
+        "Transferred".green().bold()
+    };
+    println!(
+        "{:>12} [{}/{}] {} ({} bytes)",
+        status, progress.completed, progress.total, progress.digest, progress.size
+    );
 }
 
 fn main() -> Result<()> {
@@ -118,8 +205,19 @@ fn main() -> Result<()> {
         .parse_default_env()
         .init();
 
-    let command = Command::parse();
-    match &command {
+    let cli = Cli::parse();
+    if !cli.profile {
+        return run(&cli.command);
+    }
+    let profiler = Profiler::default();
+    tracing::subscriber::set_global_default(tracing_subscriber::registry().with(profiler.clone()))?;
+    let result = run(&cli.command);
+    eprint!("{}", profiler);
+    result
+}
+
+fn run(command: &Command) -> Result<()> {
+    match command {
         Command::Version => {
             println!(
                 "{:>12} {}",
@@ -158,29 +256,56 @@ fn main() -> Result<()> {
             println!("{}", serde_json::to_string_pretty(&manifest)?);
         }
 
-        Command::Push { image_name_or_path } => match ImageNameOrPath::parse(image_name_or_path)? {
-            ImageNameOrPath::OciDir(path) => {
-                let mut artifact = Artifact::from_oci_dir(&path)?;
-                artifact.push()?;
-            }
-            ImageNameOrPath::OciArchive(path) => {
-                let mut artifact = Artifact::from_oci_archive(&path)?;
-                artifact.push()?;
-            }
-            ImageNameOrPath::Local(name) => {
-                let image_dir = image_dir(&name)?;
-                let mut artifact = Artifact::from_oci_dir(&image_dir)?;
-                artifact.push()?;
+        Command::Export {
+            image_name_or_path,
+            output,
+            digest,
+        } => {
+            let digest = digest.as_deref().map(Digest::new).transpose()?;
+            let instance =
+                ImageNameOrPath::parse(image_name_or_path)?.get_instance(digest.as_ref())?;
+            match output.extension().and_then(|ext| ext.to_str()) {
+                Some("mps") => mps::write_file(&instance, output)?,
+                Some("lp") => lp::write_file(&instance, output)?,
+                _ => bail!("Output must be *.mps or *.lp: {}", output.display()),
             }
-            ImageNameOrPath::Remote(name) => {
-                bail!("Image not found in local: {}", name)
+        }
+
+        Command::Push {
+            image_name_or_path,
+            jobs,
+        } => {
+            let options = TransferOptions {
+                jobs: *jobs,
+                progress: Some(&show_progress),
+            };
+            match ImageNameOrPath::parse(image_name_or_path)? {
+                ImageNameOrPath::OciDir(path) => {
+                    let mut artifact = Artifact::from_oci_dir(&path)?;
+                    artifact.push_with(&options)?;
+                }
+                ImageNameOrPath::OciArchive(path) => {
+                    let mut artifact = Artifact::from_oci_archive(&path)?;
+                    artifact.push_with(&options)?;
+                }
+                ImageNameOrPath::Local(name) => {
+                    let image_dir = image_dir(&name)?;
+                    let mut artifact = Artifact::from_oci_dir(&image_dir)?;
+                    artifact.push_with(&options)?;
+                }
+                ImageNameOrPath::Remote(name) => {
+                    bail!("Image not found in local: {}", name)
+                }
             }
-        },
+        }
 
-        Command::Pull { image_name } => {
+        Command::Pull { image_name, jobs } => {
             let name = ImageName::parse(image_name)?;
             let mut artifact = Artifact::from_remote(name)?;
-            artifact.pull()?;
+            artifact.pull_with(&TransferOptions {
+                jobs: *jobs,
+                progress: Some(&show_progress),
+            })?;
         }
 
         Command::Save { image_name, output } => {
@@ -201,9 +326,41 @@ fn main() -> Result<()> {
             println!("{}", path.display());
         }
 
-        Command::List => {
-            for image_name in ommx::artifact::get_images()? {
-                println!("{}", image_name);
+        Command::Gc => {
+            let report = BlobStore::local()?.gc()?;
+            println!(
+                "{:>12} {} blobs ({} bytes)",
+                "Removed".green().bold(),
+                report.removed_blobs,
+                report.removed_bytes
+            );
+        }
+
+        Command::List {
+            prefix,
+            annotation,
+            reindex,
+        } => {
+            let index = if *reindex {
+                LocalIndex::rebuild()?
+            } else {
+                LocalIndex::load()?
+            };
+            let annotation = match annotation {
+                Some(annotation) => Some(
+                    annotation
+                        .split_once('=')
+                        .context("Annotation must be in the form of KEY=VALUE")?,
+                ),
+                None => None,
+            };
+            for entry in index.find_by_prefix(prefix.as_deref().unwrap_or("")) {
+                if let Some((key, value)) = annotation {
+                    if !entry.has_annotation(key, value) {
+                        continue;
+                    }
+                }
+                println!("{}", entry.image_name);
             }
         }
     }
@@ -0,0 +1,170 @@
+//! Canonical forms of functions
+//!
+//! Builders of functions may emit duplicated IDs, explicit zeros, or both `(i, j)` and `(j, i)` entries of [Quadratic],
+//! which inflate the number of terms to be serialized and evaluated.
+//! `canonicalize` methods rewrite the functions in-place into the canonical form:
+//!
+//! - Terms are sorted by IDs, and terms of the same IDs are merged into one.
+//! - Terms whose absolute value of coefficient is smaller than or equal to `atol` are removed.
+//! - [Quadratic] is folded into upper triangular form, i.e. `rows[k] <= columns[k]`.
+//! - IDs in each [Monomial][crate::v1::Monomial] of [Polynomial] are sorted, and monomials are sorted by degree, then IDs.
+
+use crate::v1::{
+    function::Function as FunctionEnum, ColumnarLinear, Function, Instance, Linear, Polynomial,
+    Quadratic,
+};
+
+impl Linear {
+    /// Canonicalize in-place, see the [module document][self]
+    ///
+    /// ```rust
+    /// use ommx::v1::Linear;
+    ///
+    /// let mut linear = Linear::new([(2, 1.0), (1, 2.0), (2, 3.0), (3, 0.0)].into_iter(), 1.0);
+    /// linear.canonicalize(0.0);
+    /// assert_eq!(linear, Linear::new([(1, 2.0), (2, 4.0)].into_iter(), 1.0));
+    /// ```
+    pub fn canonicalize(&mut self, atol: f64) {
+        self.terms.sort_unstable_by_key(|term| term.id);
+        // `dedup_by` calls with `(later, earlier)` and removes `later` if it returns `true`
+        self.terms.dedup_by(|later, earlier| {
+            if later.id == earlier.id {
+                earlier.coefficient += later.coefficient;
+                true
+            } else {
+                false
+            }
+        });
+        self.terms.retain(|term| term.coefficient.abs() > atol);
+    }
+}
+
+impl ColumnarLinear {
+    /// Canonicalize in-place, see the [module document][self]
+    ///
+    /// ```rust
+    /// use ommx::v1::ColumnarLinear;
+    ///
+    /// let mut linear = ColumnarLinear::new([(2, 1.0), (1, 2.0), (2, 3.0), (3, 0.0)].into_iter(), 1.0);
+    /// linear.canonicalize(0.0);
+    /// assert_eq!(linear.ids, vec![1, 2]);
+    /// assert_eq!(linear.coefficients, vec![2.0, 4.0]);
+    /// ```
+    pub fn canonicalize(&mut self, atol: f64) {
+        let mut terms: Vec<(u64, f64)> = self.terms().collect();
+        terms.sort_unstable_by_key(|(id, _)| *id);
+        terms.dedup_by(|later, earlier| {
+            if later.0 == earlier.0 {
+                earlier.1 += later.1;
+                true
+            } else {
+                false
+            }
+        });
+        terms.retain(|(_, c)| c.abs() > atol);
+
+        // Reuse the allocations of the original vectors
+        self.ids.clear();
+        self.coefficients.clear();
+        for (id, c) in terms {
+            self.ids.push(id);
+            self.coefficients.push(c);
+        }
+    }
+}
+
+impl Quadratic {
+    /// Canonicalize in-place, see the [module document][self]
+    ///
+    /// ```rust
+    /// use ommx::v1::Quadratic;
+    ///
+    /// // x1*x2 + 2 x2*x1 + 0 x1*x1
+    /// let mut quad = Quadratic {
+    ///     rows: vec![1, 2, 1],
+    ///     columns: vec![2, 1, 1],
+    ///     values: vec![1.0, 2.0, 0.0],
+    ///     linear: None,
+    /// };
+    /// quad.canonicalize(0.0);
+    /// assert_eq!(quad.rows, vec![1]);
+    /// assert_eq!(quad.columns, vec![2]);
+    /// assert_eq!(quad.values, vec![3.0]);
+    /// ```
+    pub fn canonicalize(&mut self, atol: f64) {
+        let mut entries: Vec<(u64, u64, f64)> =
+            itertools::multizip((self.rows.iter(), self.columns.iter(), self.values.iter()))
+                .map(|(i, j, v)| if i <= j { (*i, *j, *v) } else { (*j, *i, *v) })
+                .collect();
+        entries.sort_unstable_by_key(|(i, j, _)| (*i, *j));
+        entries.dedup_by(|later, earlier| {
+            if (later.0, later.1) == (earlier.0, earlier.1) {
+                earlier.2 += later.2;
+                true
+            } else {
+                false
+            }
+        });
+        entries.retain(|(_, _, v)| v.abs() > atol);
+
+        // Reuse the allocations of the original vectors
+        self.rows.clear();
+        self.columns.clear();
+        self.values.clear();
+        for (i, j, v) in entries {
+            self.rows.push(i);
+            self.columns.push(j);
+            self.values.push(v);
+        }
+        if let Some(linear) = self.linear.as_mut() {
+            linear.canonicalize(atol);
+        }
+    }
+}
+
+impl Polynomial {
+    /// Canonicalize in-place, see the [module document][self]
+    pub fn canonicalize(&mut self, atol: f64) {
+        for term in &mut self.terms {
+            term.ids.sort_unstable();
+        }
+        self.terms
+            .sort_unstable_by(|a, b| (a.ids.len(), &a.ids).cmp(&(b.ids.len(), &b.ids)));
+        self.terms.dedup_by(|later, earlier| {
+            if later.ids == earlier.ids {
+                earlier.coefficient += later.coefficient;
+                true
+            } else {
+                false
+            }
+        });
+        self.terms.retain(|term| term.coefficient.abs() > atol);
+    }
+}
+
+impl Function {
+    /// Canonicalize in-place, see the [module document][self]
+    pub fn canonicalize(&mut self, atol: f64) {
+        match &mut self.function {
+            Some(FunctionEnum::Linear(linear)) => linear.canonicalize(atol),
+            Some(FunctionEnum::Quadratic(quadratic)) => quadratic.canonicalize(atol),
+            Some(FunctionEnum::Polynomial(poly)) => poly.canonicalize(atol),
+            Some(FunctionEnum::ColumnarLinear(linear)) => linear.canonicalize(atol),
+            Some(FunctionEnum::Constant(_)) | None => {}
+        }
+    }
+}
+
+impl Instance {
+    /// Canonicalize the objective and all constraints in-place, see the [module document][self]
+    pub fn canonicalize(&mut self, atol: f64) {
+        if let Some(objective) = self.objective.as_mut() {
+            objective.canonicalize(atol);
+        }
+        for constraint in &mut self.constraints {
+            if let Some(function) = constraint.function.as_mut() {
+                function.canonicalize(atol);
+            }
+        }
+    }
+}
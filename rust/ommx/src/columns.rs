@@ -0,0 +1,136 @@
+//! Columnar export of [Solution] for data frames
+//!
+//! Building a data frame from [Solution] message by message is slow for large instances.
+//! [SolutionColumns] collects the fields of the decision variables and evaluated constraints into columns at once.
+//! The numeric columns can be passed to data frame libraries without copying.
+//!
+//! ```rust
+//! use ommx::{Evaluate, SolutionColumns, DEFAULT_FEASIBILITY_ATOL, random::random_lp, v1::State};
+//! use rand::SeedableRng;
+//!
+//! let mut rng = rand_xoshiro::Xoshiro256StarStar::seed_from_u64(0);
+//! let instance = random_lp(&mut rng, 3, 2);
+//! let solution = instance.evaluate_value(&State::dense(0, vec![1.0, 2.0, 3.0])).unwrap();
+//!
+//! let columns = SolutionColumns::new(&solution, DEFAULT_FEASIBILITY_ATOL);
+//! assert_eq!(columns.variable_ids, vec![0, 1, 2]);
+//! assert_eq!(columns.values, vec![1.0, 2.0, 3.0]);
+//! assert_eq!(columns.constraint_ids.len(), 2);
+//! assert_eq!(
+//!     columns.constraint_feasible.iter().all(|f| *f),
+//!     solution.feasible
+//! );
+//! ```
+
+use crate::{
+    evaluate::is_violated,
+    v1::{DecisionVariable, Equality, Solution},
+};
+use std::collections::HashMap;
+
+/// Decision variables and evaluated constraints of [Solution] as columns, see the [module document][self]
+#[derive(Debug, Clone, PartialEq, Default)]
+pub struct SolutionColumns {
+    /// ID of each decision variable in the order of [Solution::decision_variables]
+    pub variable_ids: Vec<u64>,
+    /// [Kind][crate::v1::decision_variable::Kind] of each decision variable as its protobuf value
+    pub kinds: Vec<i32>,
+    /// Lower bound of each decision variable. `0` if the bound is not set, as the default of protobuf.
+    pub lower: Vec<f64>,
+    /// Upper bound of each decision variable. `0` if the bound is not set, as the default of protobuf.
+    pub upper: Vec<f64>,
+    /// Value of each decision variable in [Solution::state], `NaN` if not contained
+    pub values: Vec<f64>,
+    /// Name of each decision variable, empty if not set
+    pub names: Vec<String>,
+    pub subscripts: Vec<Vec<i64>>,
+    /// Description of each decision variable, empty if not set
+    pub descriptions: Vec<String>,
+    pub parameters: Vec<HashMap<String, String>>,
+    /// ID of each constraint in the order of [Solution::evaluated_constraints]
+    pub constraint_ids: Vec<u64>,
+    /// [Equality] of each constraint as its protobuf value
+    pub equalities: Vec<i32>,
+    /// Evaluated value of each constraint function
+    pub constraint_values: Vec<f64>,
+    /// Whether each constraint is satisfied within the absolute tolerance
+    pub constraint_feasible: Vec<bool>,
+    pub used_decision_variable_ids: Vec<Vec<u64>>,
+    /// Name of each constraint, empty if not set
+    pub constraint_names: Vec<String>,
+    /// Description of each constraint, empty if not set
+    pub constraint_descriptions: Vec<String>,
+    pub constraint_parameters: Vec<HashMap<String, String>>,
+}
+
+impl SolutionColumns {
+    pub fn new(solution: &Solution, atol: f64) -> Self {
+        Self::with_decision_variables(solution, &solution.decision_variables, atol)
+    }
+
+    /// Use `decision_variables` instead of [Solution::decision_variables],
+    /// e.g. [CompiledInstance::decision_variables][crate::CompiledInstance::decision_variables] shared by the solutions
+    /// of [CompiledInstance::evaluate_samples_shared][crate::CompiledInstance::evaluate_samples_shared]
+    pub fn with_decision_variables(
+        solution: &Solution,
+        decision_variables: &[DecisionVariable],
+        atol: f64,
+    ) -> Self {
+        let n = decision_variables.len();
+        let m = solution.evaluated_constraints.len();
+        let mut out = Self {
+            variable_ids: Vec::with_capacity(n),
+            kinds: Vec::with_capacity(n),
+            lower: Vec::with_capacity(n),
+            upper: Vec::with_capacity(n),
+            values: Vec::with_capacity(n),
+            names: Vec::with_capacity(n),
+            subscripts: Vec::with_capacity(n),
+            descriptions: Vec::with_capacity(n),
+            parameters: Vec::with_capacity(n),
+            constraint_ids: Vec::with_capacity(m),
+            equalities: Vec::with_capacity(m),
+            constraint_values: Vec::with_capacity(m),
+            constraint_feasible: Vec::with_capacity(m),
+            used_decision_variable_ids: Vec::with_capacity(m),
+            constraint_names: Vec::with_capacity(m),
+            constraint_descriptions: Vec::with_capacity(m),
+            constraint_parameters: Vec::with_capacity(m),
+        };
+        for dv in decision_variables {
+            let bound = dv.bound.clone().unwrap_or_default();
+            out.variable_ids.push(dv.id);
+            out.kinds.push(dv.kind);
+            out.lower.push(bound.lower);
+            out.upper.push(bound.upper);
+            out.values.push(
+                solution
+                    .state
+                    .as_ref()
+                    .and_then(|state| state.get(dv.id))
+                    .unwrap_or(f64::NAN),
+            );
+            out.names.push(dv.name.clone().unwrap_or_default());
+            out.subscripts.push(dv.subscripts.clone());
+            out.descriptions
+                .push(dv.description.clone().unwrap_or_default());
+            out.parameters.push(dv.parameters.clone());
+        }
+        for c in &solution.evaluated_constraints {
+            let equality = Equality::try_from(c.equality).unwrap_or_default();
+            out.constraint_ids.push(c.id);
+            out.equalities.push(c.equality);
+            out.constraint_values.push(c.evaluated_value);
+            out.constraint_feasible
+                .push(!is_violated(equality, c.evaluated_value, atol));
+            out.used_decision_variable_ids
+                .push(c.used_decision_variable_ids.clone());
+            out.constraint_names
+                .push(c.name.clone().unwrap_or_default());
+            out.constraint_descriptions
+                .push(c.description.clone().unwrap_or_default());
+            out.constraint_parameters.push(c.parameters.clone());
+        }
+        out
+    }
+}
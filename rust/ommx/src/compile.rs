@@ -0,0 +1,587 @@
+//! Index-based representation of [Instance] for fast repeated evaluation
+//!
+//! [`Instance::evaluate`][Evaluate::evaluate] looks up [State::entries] for every term
+//! and collects used decision variable IDs into a [BTreeSet] for every call.
+//! This is fine for evaluating a few solutions, but dominates the cost when a heuristic solver evaluates many candidate states.
+//! [CompiledInstance] remaps decision variable IDs once into dense indices `0..n`,
+//! stores the objective and constraints in flat CSR-like arrays, and evaluates them against a dense state `&[f64]`
+//! without allocation.
+//! The result is exactly the same as [`Instance::evaluate`][Evaluate::evaluate] since the terms are summed up in the same order.
+//! [CompiledInstance::evaluate_dense_samples] sums up quadratic terms by SIMD kernels instead,
+//! and its result may differ by rounding errors.
+//!
+//! ```rust
+//! use ommx::{Evaluate, CompiledInstance, random::random_lp};
+//! use maplit::hashmap;
+//! use rand::SeedableRng;
+//!
+//! let mut rng = rand_xoshiro::Xoshiro256StarStar::seed_from_u64(0);
+//! let instance = random_lp(&mut rng, 3, 2);
+//! let compiled = CompiledInstance::new(&instance).unwrap();
+//!
+//! // Same result as `Instance::evaluate`
+//! let state = hashmap! { 0 => 1.0, 1 => 2.0, 2 => 3.0 }.into();
+//! let (expected, _) = instance.evaluate(&state).unwrap();
+//! let (solution, _) = compiled.evaluate(&state).unwrap();
+//! assert_eq!(solution, expected);
+//!
+//! // Evaluate with a dense state without allocation
+//! let x = compiled.dense_state(&state).unwrap();
+//! let mut values = vec![0.0; compiled.num_constraints()];
+//! compiled.evaluate_constraints_into(&x, &mut values);
+//! assert_eq!(compiled.evaluate_objective(&x), expected.objective);
+//! ```
+
+use crate::{
+    evaluate::{is_violated, DEFAULT_FEASIBILITY_ATOL},
+    v1::{
+        function::Function as FunctionEnum, DecisionVariable, Equality, EvaluatedConstraint,
+        Function, Instance, Optimality, Relaxation, Solution, State,
+    },
+    Evaluate,
+};
+use anyhow::{bail, ensure, Context, Result};
+use prost::Message;
+use std::collections::{BTreeSet, HashMap};
+
+mod batch;
+mod feasibility;
+mod incremental;
+mod kernel;
+pub use batch::*;
+pub use feasibility::*;
+pub use incremental::*;
+
+/// Bijection between decision variable IDs and dense indices `0..n`, ordered by ID
+#[derive(Debug, Clone, PartialEq, Default)]
+pub struct VariableIndex {
+    ids: Vec<u64>,
+    indices: HashMap<u64, usize>,
+}
+
+impl VariableIndex {
+    pub fn new(ids: impl IntoIterator<Item = u64>) -> Self {
+        let ids: Vec<u64> = ids
+            .into_iter()
+            .collect::<BTreeSet<_>>()
+            .into_iter()
+            .collect();
+        let indices = ids.iter().enumerate().map(|(i, id)| (*id, i)).collect();
+        Self { ids, indices }
+    }
+
+    pub fn len(&self) -> usize {
+        self.ids.len()
+    }
+
+    pub fn is_empty(&self) -> bool {
+        self.ids.is_empty()
+    }
+
+    /// Decision variable IDs in the order of dense indices
+    pub fn ids(&self) -> &[u64] {
+        &self.ids
+    }
+
+    pub fn index_of(&self, id: u64) -> Option<usize> {
+        self.indices.get(&id).copied()
+    }
+
+    pub fn id_of(&self, index: usize) -> u64 {
+        self.ids[index]
+    }
+
+    pub(crate) fn get(&self, id: u64) -> Result<usize> {
+        self.index_of(id)
+            .with_context(|| format!("Variable id ({id}) is not registered"))
+    }
+}
+
+/// [Function] whose decision variable IDs are replaced by dense indices of [VariableIndex]
+///
+/// [CompiledFunction::evaluate] sums up the terms in the same order as [Function::evaluate][Evaluate::evaluate],
+/// and thus returns exactly the same value.
+/// [CompiledFunction::evaluate_simd] sums up the quadratic terms by SIMD kernels, and its result may differ by rounding errors.
+#[derive(Debug, Clone, PartialEq, Default)]
+pub struct CompiledFunction {
+    constant: f64,
+    linear_indices: Vec<usize>,
+    linear_coefficients: Vec<f64>,
+    quadratic_rows: Vec<usize>,
+    quadratic_columns: Vec<usize>,
+    quadratic_values: Vec<f64>,
+    /// The `k`-th monomial is the product of `monomial_indices[monomial_offsets[k]..monomial_offsets[k + 1]]`
+    monomial_offsets: Vec<usize>,
+    monomial_indices: Vec<usize>,
+    monomial_coefficients: Vec<f64>,
+    /// Every dense index in this function is smaller than this
+    dimension: usize,
+}
+
+impl CompiledFunction {
+    pub fn new(function: &Function, index: &VariableIndex) -> Result<Self> {
+        let mut out = Self {
+            monomial_offsets: vec![0],
+            ..Default::default()
+        };
+        match &function.function {
+            Some(FunctionEnum::Constant(c)) => out.constant = *c,
+            Some(FunctionEnum::Linear(linear)) => {
+                out.constant = linear.constant;
+                for term in &linear.terms {
+                    out.linear_indices.push(index.get(term.id)?);
+                    out.linear_coefficients.push(term.coefficient);
+                }
+            }
+            Some(FunctionEnum::ColumnarLinear(linear)) => {
+                ensure!(
+                    linear.ids.len() == linear.coefficients.len(),
+                    "Lengths of ids and coefficients are different in ColumnarLinear"
+                );
+                out.constant = linear.constant;
+                for id in &linear.ids {
+                    out.linear_indices.push(index.get(*id)?);
+                }
+                out.linear_coefficients
+                    .extend_from_slice(&linear.coefficients);
+            }
+            Some(FunctionEnum::Quadratic(quadratic)) => {
+                if let Some(linear) = &quadratic.linear {
+                    out.constant = linear.constant;
+                    for term in &linear.terms {
+                        out.linear_indices.push(index.get(term.id)?);
+                        out.linear_coefficients.push(term.coefficient);
+                    }
+                }
+                for (i, j, value) in itertools::multizip((
+                    quadratic.rows.iter(),
+                    quadratic.columns.iter(),
+                    quadratic.values.iter(),
+                )) {
+                    out.quadratic_rows.push(index.get(*i)?);
+                    out.quadratic_columns.push(index.get(*j)?);
+                    out.quadratic_values.push(*value);
+                }
+            }
+            Some(FunctionEnum::Polynomial(poly)) => {
+                for term in &poly.terms {
+                    for id in &term.ids {
+                        out.monomial_indices.push(index.get(*id)?);
+                    }
+                    out.monomial_offsets.push(out.monomial_indices.len());
+                    out.monomial_coefficients.push(term.coefficient);
+                }
+            }
+            None => bail!("Function is not set"),
+        }
+        out.dimension = out
+            .linear_indices
+            .iter()
+            .chain(&out.quadratic_rows)
+            .chain(&out.quadratic_columns)
+            .chain(&out.monomial_indices)
+            .max()
+            .map_or(0, |i| i + 1);
+        Ok(out)
+    }
+
+    /// Evaluate with a dense state `x` indexed by [VariableIndex]
+    pub fn evaluate(&self, x: &[f64]) -> f64 {
+        let mut sum = self.constant;
+        for (i, c) in self.linear_indices.iter().zip(&self.linear_coefficients) {
+            sum += c * x[*i];
+        }
+        // Accumulated into `sum` one by one as `Quadratic::evaluate` does
+        for (i, j, value) in itertools::multizip((
+            self.quadratic_rows.iter(),
+            self.quadratic_columns.iter(),
+            self.quadratic_values.iter(),
+        )) {
+            sum += value * x[*i] * x[*j];
+        }
+        self.add_monomials(x, sum)
+    }
+
+    /// Same as [CompiledFunction::evaluate], but the quadratic terms are summed up by SIMD kernels
+    pub fn evaluate_simd(&self, x: &[f64]) -> f64 {
+        let mut sum = self.constant;
+        for (i, c) in self.linear_indices.iter().zip(&self.linear_coefficients) {
+            sum += c * x[*i];
+        }
+        // Checked here since the SIMD kernels do not check bounds
+        assert!(x.len() >= self.dimension);
+        sum += kernel::quadratic_sum(
+            &self.quadratic_rows,
+            &self.quadratic_columns,
+            &self.quadratic_values,
+            x,
+        );
+        self.add_monomials(x, sum)
+    }
+
+    fn add_monomials(&self, x: &[f64], mut sum: f64) -> f64 {
+        for (k, coefficient) in self.monomial_coefficients.iter().enumerate() {
+            let mut v = *coefficient;
+            for i in self.monomial(k) {
+                v *= x[*i];
+            }
+            sum += v;
+        }
+        sum
+    }
+
+    /// Evaluate many dense states at once into `out` of length `num_samples`
+    ///
+    /// `xs` is a `num_variables x num_samples` matrix in row-major order,
+    /// i.e. `xs[i * num_samples + s]` is the value of the `i`-th variable in the `s`-th sample.
+    pub fn evaluate_batch(&self, xs: &[f64], out: &mut [f64]) {
+        let num_samples = out.len();
+        assert!(xs.len() >= self.dimension * num_samples);
+        let row = |i: usize| &xs[i * num_samples..(i + 1) * num_samples];
+        out.fill(self.constant);
+        for (i, c) in self.linear_indices.iter().zip(&self.linear_coefficients) {
+            for (o, x) in out.iter_mut().zip(row(*i)) {
+                *o += c * x;
+            }
+        }
+        kernel::quadratic_sum_batch(
+            &self.quadratic_rows,
+            &self.quadratic_columns,
+            &self.quadratic_values,
+            xs,
+            out,
+        );
+        let mut v = vec![0.0; num_samples];
+        for (k, coefficient) in self.monomial_coefficients.iter().enumerate() {
+            v.fill(*coefficient);
+            for i in self.monomial(k) {
+                for (p, x) in v.iter_mut().zip(row(*i)) {
+                    *p *= x;
+                }
+            }
+            for (o, p) in out.iter_mut().zip(&v) {
+                *o += p;
+            }
+        }
+    }
+
+    /// Dense indices of the `k`-th monomial
+    fn monomial(&self, k: usize) -> &[usize] {
+        &self.monomial_indices[self.monomial_offsets[k]..self.monomial_offsets[k + 1]]
+    }
+
+    /// Dense indices used in this function, sorted and deduplicated
+    pub fn used_indices(&self) -> Vec<usize> {
+        self.linear_indices
+            .iter()
+            .chain(&self.quadratic_rows)
+            .chain(&self.quadratic_columns)
+            .chain(&self.monomial_indices)
+            .cloned()
+            .collect::<BTreeSet<_>>()
+            .into_iter()
+            .collect()
+    }
+}
+
+#[derive(Debug, Clone, PartialEq)]
+struct CompiledConstraint {
+    id: u64,
+    equality: Equality,
+    function: CompiledFunction,
+    used_decision_variable_ids: Vec<u64>,
+    parameters: HashMap<String, String>,
+    name: Option<String>,
+    description: Option<String>,
+}
+
+/// [Instance] compiled into dense-index form, see the [module document][self] for detail
+#[derive(Debug, Clone, PartialEq)]
+pub struct CompiledInstance {
+    variables: VariableIndex,
+    /// Whether the variable of each dense index is used in the objective or constraints,
+    /// i.e. must be contained in the [State]
+    used: Vec<bool>,
+    objective: CompiledFunction,
+    constraints: Vec<CompiledConstraint>,
+    decision_variables: Vec<DecisionVariable>,
+    used_ids: BTreeSet<u64>,
+    /// Absolute tolerance of constraint violation
+    atol: f64,
+}
+
+impl CompiledInstance {
+    #[tracing::instrument(skip_all, fields(constraints = instance.constraints.len(), nnz))]
+    pub fn new(instance: &Instance) -> Result<Self> {
+        let objective = instance
+            .objective
+            .as_ref()
+            .context("Objective is not set")?;
+        // Decision variables used in the functions are also registered
+        // even if they are not listed in `decision_variables`
+        let mut used_ids = objective.used_decision_variable_ids();
+        for c in &instance.constraints {
+            if let Some(f) = &c.function {
+                used_ids.extend(f.used_decision_variable_ids());
+            }
+        }
+        let variables = VariableIndex::new(
+            instance
+                .decision_variables
+                .iter()
+                .map(|v| v.id)
+                .chain(used_ids.iter().cloned()),
+        );
+        let mut used = vec![false; variables.len()];
+        for id in &used_ids {
+            used[variables.get(*id)?] = true;
+        }
+
+        let objective = CompiledFunction::new(objective, &variables)?;
+        let mut constraints = Vec::with_capacity(instance.constraints.len());
+        for c in &instance.constraints {
+            let equality = match Equality::try_from(c.equality) {
+                Ok(Equality::EqualToZero) => Equality::EqualToZero,
+                Ok(Equality::LessThanOrEqualToZero) => Equality::LessThanOrEqualToZero,
+                _ => bail!("Unsupported equality: {:?}", c.equality),
+            };
+            let function = c.function.as_ref().context("Function is not set")?;
+            constraints.push(CompiledConstraint {
+                id: c.id,
+                equality,
+                function: CompiledFunction::new(function, &variables)?,
+                used_decision_variable_ids: function
+                    .used_decision_variable_ids()
+                    .into_iter()
+                    .collect(),
+                parameters: c.parameters.clone(),
+                name: c.name.clone(),
+                description: c.description.clone(),
+            });
+        }
+        let span = tracing::Span::current();
+        if !span.is_disabled() {
+            let nnz: usize = constraints
+                .iter()
+                .map(|c| c.used_decision_variable_ids.len())
+                .sum();
+            span.record("nnz", nnz);
+        }
+        Ok(Self {
+            variables,
+            used,
+            objective,
+            constraints,
+            decision_variables: instance.decision_variables.clone(),
+            used_ids,
+            atol: DEFAULT_FEASIBILITY_ATOL,
+        })
+    }
+
+    /// Set the absolute tolerance of constraint violation, [DEFAULT_FEASIBILITY_ATOL] by default
+    pub fn with_atol(mut self, atol: f64) -> Self {
+        self.atol = atol;
+        self
+    }
+
+    pub fn atol(&self) -> f64 {
+        self.atol
+    }
+
+    pub fn variables(&self) -> &VariableIndex {
+        &self.variables
+    }
+
+    pub fn num_constraints(&self) -> usize {
+        self.constraints.len()
+    }
+
+    /// IDs of constraints in the order of their dense indices
+    pub fn constraint_ids(&self) -> impl Iterator<Item = u64> + '_ {
+        self.constraints.iter().map(|c| c.id)
+    }
+
+    /// Decision variable IDs used in the objective or constraints
+    pub fn used_decision_variable_ids(&self) -> &BTreeSet<u64> {
+        &self.used_ids
+    }
+
+    /// Convert [State] into a dense state. Unused decision variables missing in the state are filled by `NaN`.
+    pub fn dense_state(&self, state: &State) -> Result<Vec<f64>> {
+        let mut x = vec![f64::NAN; self.variables.len()];
+        self.dense_state_into(state, &mut x)?;
+        Ok(x)
+    }
+
+    /// Write [State] into a pre-allocated dense state of length [VariableIndex::len]
+    pub fn dense_state_into(&self, state: &State, x: &mut [f64]) -> Result<()> {
+        assert_eq!(x.len(), self.variables.len());
+        for (i, id) in self.variables.ids().iter().enumerate() {
+            match state.get(*id) {
+                Some(value) => x[i] = value,
+                None if self.used[i] => {
+                    bail!("Variable id ({id}) is not found in the solution")
+                }
+                None => x[i] = f64::NAN,
+            }
+        }
+        Ok(())
+    }
+
+    pub fn evaluate_objective(&self, x: &[f64]) -> f64 {
+        self.objective.evaluate(x)
+    }
+
+    /// Evaluate the objective for many dense states, see [CompiledFunction::evaluate_batch] for the layout of `xs`
+    pub fn evaluate_objective_batch(&self, xs: &[f64], out: &mut [f64]) {
+        self.objective.evaluate_batch(xs, out)
+    }
+
+    /// Evaluate the constraint of the given dense index for many dense states, see [CompiledFunction::evaluate_batch] for the layout of `xs`
+    pub fn evaluate_constraint_batch(&self, k: usize, xs: &[f64], out: &mut [f64]) {
+        self.constraints[k].function.evaluate_batch(xs, out)
+    }
+
+    /// Evaluate the constraint of the given dense index
+    pub fn evaluate_constraint(&self, k: usize, x: &[f64]) -> f64 {
+        self.constraints[k].function.evaluate(x)
+    }
+
+    /// Evaluate all constraints into `out` of length [CompiledInstance::num_constraints]
+    pub fn evaluate_constraints_into(&self, x: &[f64], out: &mut [f64]) {
+        assert_eq!(out.len(), self.constraints.len());
+        for (c, value) in self.constraints.iter().zip(out.iter_mut()) {
+            *value = c.function.evaluate(x);
+        }
+    }
+
+    /// Whether the value of the constraint of the given dense index violates it beyond [CompiledInstance::atol]
+    pub fn is_violated(&self, k: usize, value: f64) -> bool {
+        is_violated(self.constraints[k].equality, value, self.atol)
+    }
+
+    /// Dense index of the first violated constraint, without evaluating the remaining constraints
+    ///
+    /// See [FeasibilityChecker] for checking many states with reordering constraints by violation frequency.
+    pub fn find_violated_constraint(&self, x: &[f64]) -> Option<usize> {
+        (0..self.constraints.len()).find(|k| self.is_violated(*k, self.evaluate_constraint(*k, x)))
+    }
+
+    /// Check feasibility with early exit, see [CompiledInstance::find_violated_constraint]
+    pub fn is_feasible(&self, x: &[f64]) -> bool {
+        self.find_violated_constraint(x).is_none()
+    }
+
+    /// Decision variables of the compiled instance, which are copied into each [Solution] by [Evaluate::evaluate]
+    pub fn decision_variables(&self) -> &[DecisionVariable] {
+        &self.decision_variables
+    }
+
+    /// Serialize the solution returned by [CompiledInstance::evaluate_samples_shared] as `ommx.v1.Solution` with [CompiledInstance::decision_variables],
+    /// without cloning them into the solution.
+    ///
+    /// This relies on the protobuf encoding where a message is the concatenation of its fields,
+    /// and entries of a repeated field appended after the other fields are parsed the same as the fields in order.
+    pub fn encode_shared_solution(&self, solution: &Solution) -> Vec<u8> {
+        /// Field number of `decision_variables` in `ommx.v1.Solution`
+        const DECISION_VARIABLES_TAG: u32 = 3;
+        let mut buf = solution.encode_to_vec();
+        if solution.decision_variables.is_empty() {
+            prost::encoding::message::encode_repeated(
+                DECISION_VARIABLES_TAG,
+                &self.decision_variables,
+                &mut buf,
+            );
+        }
+        buf
+    }
+
+    /// Same as [Evaluate::evaluate_value], but `decision_variables` of the solution is left empty,
+    /// see [CompiledInstance::evaluate_samples_shared]
+    pub fn evaluate_shared(&self, state: &State) -> Result<Solution> {
+        let x = self.dense_state(state)?;
+        Ok(self.to_shared_solution(state, &x))
+    }
+
+    fn to_solution(&self, state: &State, x: &[f64]) -> Solution {
+        Solution {
+            decision_variables: self.decision_variables.clone(),
+            ..self.to_shared_solution(state, x)
+        }
+    }
+
+    /// [Solution] without `decision_variables`, see [CompiledInstance::evaluate_samples_shared]
+    fn to_shared_solution(&self, state: &State, x: &[f64]) -> Solution {
+        let mut feasible = true;
+        let evaluated_constraints = self
+            .constraints
+            .iter()
+            .map(|c| {
+                let evaluated_value = c.function.evaluate(x);
+                if is_violated(c.equality, evaluated_value, self.atol) {
+                    feasible = false;
+                }
+                EvaluatedConstraint {
+                    id: c.id,
+                    equality: c.equality as i32,
+                    evaluated_value,
+                    used_decision_variable_ids: c.used_decision_variable_ids.clone(),
+                    name: c.name.clone(),
+                    parameters: c.parameters.clone(),
+                    description: c.description.clone(),
+                    dual_variable: None,
+                }
+            })
+            .collect();
+        Solution {
+            decision_variables: Vec::new(),
+            state: Some(state.clone()),
+            evaluated_constraints,
+            feasible,
+            objective: self.objective.evaluate(x),
+            optimality: Optimality::Unspecified.into(),
+            relaxation: Relaxation::Unspecified.into(),
+        }
+    }
+}
+
+impl Evaluate for CompiledInstance {
+    type Output = Solution;
+
+    fn evaluate(&self, state: &State) -> Result<(Self::Output, BTreeSet<u64>)> {
+        Ok((self.evaluate_value(state)?, self.used_ids.clone()))
+    }
+
+    /// `used_decision_variable_ids` of each constraint is filled from the cache computed in [CompiledInstance::new]
+    fn evaluate_value(&self, state: &State) -> Result<Self::Output> {
+        let x = self.dense_state(state)?;
+        Ok(self.to_solution(state, &x))
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use crate::{arbitrary::arbitrary_state, InstanceParameter};
+    use proptest::prelude::*;
+
+    fn instance_and_state() -> impl Strategy<Value = (Instance, State)> {
+        any::<InstanceParameter>()
+            .prop_flat_map(any_with::<Instance>)
+            .prop_flat_map(|instance| {
+                let state = arbitrary_state(&instance);
+                (Just(instance), state)
+            })
+    }
+
+    proptest! {
+        #[test]
+        fn evaluate_matches_instance((instance, state) in instance_and_state()) {
+            let compiled = CompiledInstance::new(&instance).unwrap();
+            let (expected, used_ids) = instance.evaluate(&state).unwrap();
+            let (solution, compiled_used_ids) = compiled.evaluate(&state).unwrap();
+            prop_assert_eq!(solution, expected);
+            prop_assert_eq!(compiled_used_ids, used_ids);
+        }
+    }
+}
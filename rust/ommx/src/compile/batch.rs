@@ -0,0 +1,100 @@
+use super::CompiledInstance;
+use crate::v1::{Solution, State};
+use anyhow::Result;
+use rayon::prelude::*;
+
+/// Columnar result of [CompiledInstance::evaluate_dense_samples]
+#[derive(Debug, Clone, PartialEq, Default)]
+pub struct EvaluatedSamples {
+    /// Objective value of each sample
+    pub objectives: Vec<f64>,
+    /// Feasibility of each sample
+    pub feasible: Vec<bool>,
+    /// Values of constraints in row-major order, i.e. `num_samples x num_constraints` matrix
+    pub constraint_values: Vec<f64>,
+    pub num_constraints: usize,
+}
+
+impl EvaluatedSamples {
+    pub fn num_samples(&self) -> usize {
+        self.objectives.len()
+    }
+
+    /// Values of constraints for the `sample`-th sample, in the order of [CompiledInstance::constraint_ids]
+    pub fn constraint_values(&self, sample: usize) -> &[f64] {
+        &self.constraint_values[sample * self.num_constraints..(sample + 1) * self.num_constraints]
+    }
+}
+
+impl CompiledInstance {
+    /// Evaluate many states in parallel
+    ///
+    /// Each solution is exactly the same as [Evaluate::evaluate_value][crate::Evaluate::evaluate_value] of [CompiledInstance] for the state.
+    #[tracing::instrument(skip_all, fields(samples = states.len()))]
+    pub fn evaluate_samples(&self, states: &[State]) -> Result<Vec<Solution>> {
+        states
+            .par_iter()
+            .map(|state| {
+                let x = self.dense_state(state)?;
+                Ok(self.to_solution(state, &x))
+            })
+            .collect()
+    }
+
+    /// Same as [CompiledInstance::evaluate_samples], but `decision_variables` of the solutions are left empty
+    /// instead of cloning [CompiledInstance::decision_variables] into each of them.
+    ///
+    /// Use [CompiledInstance::encode_shared_solution] to serialize the solutions with the decision variables,
+    /// or [SolutionColumns::with_decision_variables][crate::SolutionColumns::with_decision_variables] to take them as columns.
+    #[tracing::instrument(skip_all, fields(samples = states.len()))]
+    pub fn evaluate_samples_shared(&self, states: &[State]) -> Result<Vec<Solution>> {
+        states
+            .par_iter()
+            .map(|state| self.evaluate_shared(state))
+            .collect()
+    }
+
+    /// Evaluate dense states in parallel without constructing [Solution]s
+    ///
+    /// `samples` is a `num_samples x num_variables` matrix in row-major order,
+    /// where each row is a dense state indexed by [CompiledInstance::variables].
+    ///
+    /// The quadratic terms are summed up by SIMD kernels for throughput, see [CompiledFunction::evaluate_simd][super::CompiledFunction::evaluate_simd].
+    /// The values may differ from [CompiledInstance::evaluate_samples] by rounding errors,
+    /// and thus the feasibility of a sample on the boundary of [CompiledInstance::atol] may differ as well.
+    #[tracing::instrument(skip_all, fields(samples = num_samples, bytes = samples.len() * 8))]
+    pub fn evaluate_dense_samples(&self, samples: &[f64], num_samples: usize) -> EvaluatedSamples {
+        let n = self.variables.len();
+        let m = self.constraints.len();
+        assert_eq!(samples.len(), num_samples * n);
+        let rows: Vec<(f64, bool, Vec<f64>)> = (0..num_samples)
+            .into_par_iter()
+            .map(|s| {
+                let x = &samples[s * n..(s + 1) * n];
+                let values: Vec<f64> = self
+                    .constraints
+                    .iter()
+                    .map(|c| c.function.evaluate_simd(x))
+                    .collect();
+                let feasible = values
+                    .iter()
+                    .enumerate()
+                    .all(|(k, v)| !self.is_violated(k, *v));
+                (self.objective.evaluate_simd(x), feasible, values)
+            })
+            .collect();
+
+        let mut out = EvaluatedSamples {
+            objectives: Vec::with_capacity(num_samples),
+            feasible: Vec::with_capacity(num_samples),
+            constraint_values: Vec::with_capacity(num_samples * m),
+            num_constraints: m,
+        };
+        for (objective, feasible, values) in rows {
+            out.objectives.push(objective);
+            out.feasible.push(feasible);
+            out.constraint_values.extend(values);
+        }
+        out
+    }
+}
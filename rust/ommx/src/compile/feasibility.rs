@@ -0,0 +1,72 @@
+use super::CompiledInstance;
+
+/// Feasibility checker with early exit, which learns the order of constraints to check
+///
+/// When most of the states are infeasible, checking the constraints which are frequently violated first
+/// finds the violation with evaluating less constraints.
+/// This checker counts the violations of each constraint,
+/// and keeps the constraints sorted by the count in descending order.
+///
+/// ```rust
+/// use ommx::{CompiledInstance, FeasibilityChecker, random::random_lp};
+/// use rand::SeedableRng;
+///
+/// let mut rng = rand_xoshiro::Xoshiro256StarStar::seed_from_u64(0);
+/// let instance = random_lp(&mut rng, 3, 2);
+/// let compiled = CompiledInstance::new(&instance).unwrap();
+///
+/// let mut checker = FeasibilityChecker::new(&compiled);
+/// for x in [[0.0, 0.0, 0.0], [1.0, 2.0, 3.0], [-1.0, 0.5, 2.0]] {
+///     let k = checker.find_violated_constraint(&x);
+///     assert_eq!(k.is_none(), compiled.is_feasible(&x));
+/// }
+/// ```
+#[derive(Debug, Clone)]
+pub struct FeasibilityChecker<'a> {
+    compiled: &'a CompiledInstance,
+    /// Dense indices of constraints in the order to be checked
+    order: Vec<usize>,
+    /// Number of violations of each constraint, indexed by the position in `order`
+    violations: Vec<u64>,
+}
+
+impl<'a> FeasibilityChecker<'a> {
+    pub fn new(compiled: &'a CompiledInstance) -> Self {
+        let m = compiled.num_constraints();
+        Self {
+            compiled,
+            order: (0..m).collect(),
+            violations: vec![0; m],
+        }
+    }
+
+    /// Dense index of a violated constraint, or `None` if `x` is feasible
+    ///
+    /// Since the order of constraints to check changes, this may return a different constraint
+    /// from [CompiledInstance::find_violated_constraint] when several constraints are violated.
+    pub fn find_violated_constraint(&mut self, x: &[f64]) -> Option<usize> {
+        let position = self.order.iter().position(|k| {
+            self.compiled
+                .is_violated(*k, self.compiled.evaluate_constraint(*k, x))
+        })?;
+        let k = self.order[position];
+        self.violations[position] += 1;
+        // Bubble up to keep `violations` sorted in descending order
+        let mut p = position;
+        while p > 0 && self.violations[p - 1] < self.violations[p] {
+            self.order.swap(p - 1, p);
+            self.violations.swap(p - 1, p);
+            p -= 1;
+        }
+        Some(k)
+    }
+
+    pub fn is_feasible(&mut self, x: &[f64]) -> bool {
+        self.find_violated_constraint(x).is_none()
+    }
+
+    /// Dense indices of constraints in the current order to be checked
+    pub fn order(&self) -> &[usize] {
+        &self.order
+    }
+}
@@ -0,0 +1,388 @@
+use super::{CompiledFunction, CompiledInstance};
+use crate::v1::State;
+use anyhow::{Context, Result};
+
+/// Function affected by a change of a decision variable
+#[derive(Debug, Clone, Copy, PartialEq, Eq, PartialOrd, Ord)]
+enum Target {
+    Objective,
+    Constraint(usize),
+}
+
+#[derive(Debug, Clone, Copy, PartialEq)]
+enum Term {
+    /// `coefficient * x[i]`
+    Linear(f64),
+    /// `value * x[i] * x[other]`, where `other` may be `i` itself
+    Quadratic { other: usize, value: f64 },
+    /// The monomial of the given index in [CompiledFunction] containing `x[i]`
+    Monomial(usize),
+}
+
+#[derive(Debug, Clone, Copy, PartialEq)]
+struct Entry {
+    target: Target,
+    term: Term,
+}
+
+/// Change of the objective value and the number of violated constraints by a move
+#[derive(Debug, Clone, Copy, PartialEq)]
+pub struct MoveDelta {
+    pub delta_objective: f64,
+    /// Positive if the move violates more constraints
+    pub delta_violated: isize,
+}
+
+/// Evaluator keeping the current objective and constraint values to update them in `O(degree)` when a decision variable changes
+///
+/// This is designed for local search solvers evaluating states which differ by one or two decision variables from the previous one.
+/// Since the values are updated by differences, rounding errors accumulate over many moves.
+/// Call [IncrementalEvaluator::recompute] periodically if it matters.
+///
+/// ```rust
+/// use ommx::{CompiledInstance, IncrementalEvaluator, random::random_lp};
+/// use rand::SeedableRng;
+///
+/// let mut rng = rand_xoshiro::Xoshiro256StarStar::seed_from_u64(0);
+/// let instance = random_lp(&mut rng, 3, 2);
+/// let compiled = CompiledInstance::new(&instance).unwrap();
+///
+/// let mut evaluator = IncrementalEvaluator::new(&compiled, vec![0.0; 3]);
+/// let m = evaluator.evaluate_move(1, 1.0);
+/// let before = evaluator.objective();
+/// evaluator.set(1, 1.0);
+/// assert!((evaluator.objective() - (before + m.delta_objective)).abs() < 1e-12);
+/// assert!((evaluator.objective() - compiled.evaluate_objective(&[0.0, 1.0, 0.0])).abs() < 1e-12);
+/// ```
+#[derive(Debug, Clone)]
+pub struct IncrementalEvaluator<'a> {
+    compiled: &'a CompiledInstance,
+    /// Entries of the `i`-th decision variable are `entries[offsets[i]..offsets[i + 1]]`, sorted by target
+    offsets: Vec<usize>,
+    entries: Vec<Entry>,
+    x: Vec<f64>,
+    objective: f64,
+    constraint_values: Vec<f64>,
+    num_violated: usize,
+}
+
+fn push_entries(adjacency: &mut Vec<(usize, Entry)>, target: Target, f: &CompiledFunction) {
+    for (i, c) in f.linear_indices.iter().zip(&f.linear_coefficients) {
+        adjacency.push((
+            *i,
+            Entry {
+                target,
+                term: Term::Linear(*c),
+            },
+        ));
+    }
+    for (i, j, value) in itertools::multizip((
+        f.quadratic_rows.iter(),
+        f.quadratic_columns.iter(),
+        f.quadratic_values.iter(),
+    )) {
+        adjacency.push((
+            *i,
+            Entry {
+                target,
+                term: Term::Quadratic {
+                    other: *j,
+                    value: *value,
+                },
+            },
+        ));
+        if i != j {
+            adjacency.push((
+                *j,
+                Entry {
+                    target,
+                    term: Term::Quadratic {
+                        other: *i,
+                        value: *value,
+                    },
+                },
+            ));
+        }
+    }
+    for k in 0..f.monomial_coefficients.len() {
+        let mut indices = f.monomial(k).to_vec();
+        indices.sort_unstable();
+        indices.dedup();
+        for i in indices {
+            adjacency.push((
+                i,
+                Entry {
+                    target,
+                    term: Term::Monomial(k),
+                },
+            ));
+        }
+    }
+}
+
+impl<'a> IncrementalEvaluator<'a> {
+    /// Create evaluator starting from the dense state `x`
+    pub fn new(compiled: &'a CompiledInstance, x: Vec<f64>) -> Self {
+        assert_eq!(x.len(), compiled.variables.len());
+        let mut adjacency = Vec::new();
+        push_entries(&mut adjacency, Target::Objective, &compiled.objective);
+        for (k, c) in compiled.constraints.iter().enumerate() {
+            push_entries(&mut adjacency, Target::Constraint(k), &c.function);
+        }
+        adjacency.sort_by_key(|(i, entry)| (*i, entry.target));
+
+        let mut offsets = vec![0; x.len() + 1];
+        for (i, _) in &adjacency {
+            offsets[i + 1] += 1;
+        }
+        for i in 0..x.len() {
+            offsets[i + 1] += offsets[i];
+        }
+        let entries = adjacency.into_iter().map(|(_, entry)| entry).collect();
+
+        let mut out = Self {
+            compiled,
+            offsets,
+            entries,
+            x,
+            objective: 0.0,
+            constraint_values: vec![0.0; compiled.constraints.len()],
+            num_violated: 0,
+        };
+        out.recompute();
+        out
+    }
+
+    pub fn from_state(compiled: &'a CompiledInstance, state: &State) -> Result<Self> {
+        Ok(Self::new(compiled, compiled.dense_state(state)?))
+    }
+
+    /// Evaluate all functions from scratch to discard accumulated rounding errors
+    pub fn recompute(&mut self) {
+        self.objective = self.compiled.evaluate_objective(&self.x);
+        self.compiled
+            .evaluate_constraints_into(&self.x, &mut self.constraint_values);
+        self.num_violated = self
+            .constraint_values
+            .iter()
+            .enumerate()
+            .filter(|(k, v)| self.compiled.is_violated(*k, **v))
+            .count();
+    }
+
+    /// Current dense state
+    pub fn state(&self) -> &[f64] {
+        &self.x
+    }
+
+    pub fn objective(&self) -> f64 {
+        self.objective
+    }
+
+    /// Current values of constraints in the order of [CompiledInstance::constraint_ids]
+    pub fn constraint_values(&self) -> &[f64] {
+        &self.constraint_values
+    }
+
+    pub fn num_violated(&self) -> usize {
+        self.num_violated
+    }
+
+    pub fn is_feasible(&self) -> bool {
+        self.num_violated == 0
+    }
+
+    fn function(&self, target: Target) -> &CompiledFunction {
+        match target {
+            Target::Objective => &self.compiled.objective,
+            Target::Constraint(k) => &self.compiled.constraints[k].function,
+        }
+    }
+
+    fn term_delta(&self, entry: &Entry, index: usize, old: f64, new: f64) -> f64 {
+        match entry.term {
+            Term::Linear(coefficient) => coefficient * (new - old),
+            Term::Quadratic { other, value } if other == index => value * (new * new - old * old),
+            Term::Quadratic { other, value } => value * (new - old) * self.x[other],
+            Term::Monomial(k) => {
+                let f = self.function(entry.target);
+                let mut before = f.monomial_coefficients[k];
+                let mut after = before;
+                for i in f.monomial(k) {
+                    if *i == index {
+                        before *= old;
+                        after *= new;
+                    } else {
+                        before *= self.x[*i];
+                        after *= self.x[*i];
+                    }
+                }
+                after - before
+            }
+        }
+    }
+
+    /// Changes of the objective and each affected constraint, grouped by target
+    fn deltas(&self, index: usize, value: f64) -> impl Iterator<Item = (Target, f64)> + '_ {
+        let old = self.x[index];
+        let entries = &self.entries[self.offsets[index]..self.offsets[index + 1]];
+        let mut position = 0;
+        std::iter::from_fn(move || {
+            let target = entries.get(position)?.target;
+            let mut delta = 0.0;
+            while let Some(entry) = entries.get(position).filter(|e| e.target == target) {
+                delta += self.term_delta(entry, index, old, value);
+                position += 1;
+            }
+            Some((target, delta))
+        })
+    }
+
+    /// Change of the objective value if `x[index]` is set to `value`
+    pub fn delta_objective(&self, index: usize, value: f64) -> f64 {
+        self.deltas(index, value)
+            .take_while(|(target, _)| *target == Target::Objective)
+            .map(|(_, delta)| delta)
+            .sum()
+    }
+
+    /// Evaluate the move setting `x[index]` to `value` without applying it
+    pub fn evaluate_move(&self, index: usize, value: f64) -> MoveDelta {
+        let mut out = MoveDelta {
+            delta_objective: 0.0,
+            delta_violated: 0,
+        };
+        for (target, delta) in self.deltas(index, value) {
+            match target {
+                Target::Objective => out.delta_objective += delta,
+                Target::Constraint(k) => {
+                    let before = self.constraint_values[k];
+                    let was = self.compiled.is_violated(k, before);
+                    let will = self.compiled.is_violated(k, before + delta);
+                    out.delta_violated += will as isize - was as isize;
+                }
+            }
+        }
+        out
+    }
+
+    /// Set `x[index]` to `value` and update the objective and constraint values
+    pub fn set(&mut self, index: usize, value: f64) {
+        // Apply the deltas group by group in place instead of collecting them
+        // since this is called for every accepted move of local search
+        let old = self.x[index];
+        let end = self.offsets[index + 1];
+        let mut position = self.offsets[index];
+        while position < end {
+            let target = self.entries[position].target;
+            let mut delta = 0.0;
+            while position < end && self.entries[position].target == target {
+                let entry = self.entries[position];
+                delta += self.term_delta(&entry, index, old, value);
+                position += 1;
+            }
+            match target {
+                Target::Objective => self.objective += delta,
+                Target::Constraint(k) => {
+                    let was = self.compiled.is_violated(k, self.constraint_values[k]);
+                    self.constraint_values[k] += delta;
+                    let will = self.compiled.is_violated(k, self.constraint_values[k]);
+                    match (was, will) {
+                        (false, true) => self.num_violated += 1,
+                        (true, false) => self.num_violated -= 1,
+                        _ => {}
+                    }
+                }
+            }
+        }
+        self.x[index] = value;
+    }
+
+    /// [IncrementalEvaluator::set] by decision variable ID
+    pub fn set_by_id(&mut self, id: u64, value: f64) -> Result<()> {
+        let index = self
+            .compiled
+            .variables
+            .index_of(id)
+            .with_context(|| format!("Variable id ({id}) is not registered"))?;
+        self.set(index, value);
+        Ok(())
+    }
+
+    /// Flip a binary decision variable, i.e. set `x[index]` to `1 - x[index]`
+    pub fn flip(&mut self, index: usize) {
+        self.set(index, 1.0 - self.x[index]);
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use crate::{arbitrary::arbitrary_state, v1::Instance, InstanceParameter};
+    use proptest::prelude::*;
+
+    /// Instance, initial state, and moves `(index, value)` taken from another state
+    fn instance_and_moves() -> impl Strategy<Value = (Instance, State, Vec<(usize, f64)>)> {
+        any::<InstanceParameter>()
+            .prop_flat_map(any_with::<Instance>)
+            .prop_flat_map(|instance| {
+                let initial = arbitrary_state(&instance);
+                let moves = proptest::collection::vec(
+                    (any::<prop::sample::Index>(), arbitrary_state(&instance)),
+                    0..20,
+                );
+                (Just(instance), initial, moves)
+            })
+            .prop_map(|(instance, initial, moves)| {
+                let compiled = CompiledInstance::new(&instance).unwrap();
+                let moves = moves
+                    .into_iter()
+                    .map(|(index, state)| {
+                        let i = index.index(compiled.variables().len());
+                        (i, state.get(compiled.variables().id_of(i)).unwrap())
+                    })
+                    .collect();
+                (instance, initial, moves)
+            })
+    }
+
+    /// Rounding errors accumulated over the moves
+    fn close(value: f64, expected: f64) -> bool {
+        (value - expected).abs() <= 1e-9 * (1.0 + expected.abs())
+    }
+
+    proptest! {
+        #[test]
+        fn moves_match_recompute((instance, initial, moves) in instance_and_moves()) {
+            let compiled = CompiledInstance::new(&instance).unwrap();
+            let mut evaluator = IncrementalEvaluator::from_state(&compiled, &initial).unwrap();
+            for (i, value) in moves {
+                let delta = evaluator.evaluate_move(i, value);
+                let objective = evaluator.objective();
+                let num_violated = evaluator.num_violated() as isize;
+                if value == 1.0 - evaluator.state()[i] {
+                    evaluator.flip(i);
+                } else {
+                    evaluator.set(i, value);
+                }
+                // `evaluate_move` and `set` sum up the same deltas in the same order
+                prop_assert_eq!(evaluator.objective(), objective + delta.delta_objective);
+                prop_assert_eq!(evaluator.num_violated() as isize, num_violated + delta.delta_violated);
+            }
+
+            let fresh = IncrementalEvaluator::new(&compiled, evaluator.state().to_vec());
+            prop_assert!(close(evaluator.objective(), fresh.objective()));
+            for (value, expected) in evaluator.constraint_values().iter().zip(fresh.constraint_values()) {
+                prop_assert!(close(*value, *expected));
+            }
+            // The count is kept consistent with the accumulated values, which may differ from the fresh ones near the boundaries
+            let num_violated = evaluator
+                .constraint_values()
+                .iter()
+                .enumerate()
+                .filter(|(k, v)| compiled.is_violated(*k, **v))
+                .count();
+            prop_assert_eq!(evaluator.num_violated(), num_violated);
+        }
+    }
+}
@@ -0,0 +1,276 @@
+//! Kernels for `sum_k values[k] * x[rows[k]] * x[columns[k]]` over the COO representation of [crate::v1::Quadratic]
+//!
+//! The SIMD implementation is selected at runtime based on the CPU features,
+//! and falls back to the scalar implementation if no supported feature is available.
+//!
+//! - x86_64: AVX-512F or AVX2 with gather instructions
+//! - aarch64: NEON, which does not have gather instructions, but still vectorizes the multiply-add
+//!
+//! The vectorized kernels sum up the terms in a different order from the scalar one,
+//! and thus the result may differ by rounding errors.
+//!
+//! All indices in `rows` and `columns` must be smaller than the length of `x`,
+//! which is checked by the callers in [super::CompiledFunction].
+
+/// Single state `x`
+pub fn quadratic_sum(rows: &[usize], columns: &[usize], values: &[f64], x: &[f64]) -> f64 {
+    debug_assert!(rows.len() == values.len() && columns.len() == values.len());
+    debug_assert!(rows.iter().chain(columns).all(|i| *i < x.len()));
+
+    #[cfg(target_arch = "x86_64")]
+    {
+        if is_x86_feature_detected!("avx512f") {
+            // SAFETY: AVX-512F is available, and indices are bounded by the length of `x`
+            return unsafe { quadratic_sum_avx512(rows, columns, values, x) };
+        }
+        if is_x86_feature_detected!("avx2") {
+            // SAFETY: AVX2 is available, and indices are bounded by the length of `x`
+            return unsafe { quadratic_sum_avx2(rows, columns, values, x) };
+        }
+    }
+    #[cfg(target_arch = "aarch64")]
+    {
+        if cfg!(target_feature = "neon") {
+            // SAFETY: NEON is available, and indices are bounded by the length of `x`
+            return unsafe { quadratic_sum_neon(rows, columns, values, x) };
+        }
+    }
+    quadratic_sum_scalar(rows, columns, values, x)
+}
+
+pub fn quadratic_sum_scalar(rows: &[usize], columns: &[usize], values: &[f64], x: &[f64]) -> f64 {
+    let mut sum = 0.0;
+    for ((i, j), v) in rows.iter().zip(columns).zip(values) {
+        sum += v * x[*i] * x[*j];
+    }
+    sum
+}
+
+#[cfg(target_arch = "x86_64")]
+#[target_feature(enable = "avx2")]
+unsafe fn quadratic_sum_avx2(rows: &[usize], columns: &[usize], values: &[f64], x: &[f64]) -> f64 {
+    use std::arch::x86_64::*;
+    const LANES: usize = 4;
+    let n = values.len();
+    let chunks = n / LANES;
+    let mut acc = _mm256_setzero_pd();
+    for k in 0..chunks {
+        let offset = k * LANES;
+        // `usize` is 64-bit on x86_64, and indices are smaller than `i64::MAX`
+        let i = _mm256_loadu_si256(rows.as_ptr().add(offset) as *const __m256i);
+        let j = _mm256_loadu_si256(columns.as_ptr().add(offset) as *const __m256i);
+        let xi = _mm256_i64gather_pd::<8>(x.as_ptr(), i);
+        let xj = _mm256_i64gather_pd::<8>(x.as_ptr(), j);
+        let v = _mm256_loadu_pd(values.as_ptr().add(offset));
+        acc = _mm256_add_pd(acc, _mm256_mul_pd(_mm256_mul_pd(v, xi), xj));
+    }
+    let mut lanes = [0.0; LANES];
+    _mm256_storeu_pd(lanes.as_mut_ptr(), acc);
+    let mut sum = (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+    let rest = chunks * LANES;
+    sum += quadratic_sum_scalar(&rows[rest..], &columns[rest..], &values[rest..], x);
+    sum
+}
+
+#[cfg(target_arch = "x86_64")]
+#[target_feature(enable = "avx512f")]
+unsafe fn quadratic_sum_avx512(
+    rows: &[usize],
+    columns: &[usize],
+    values: &[f64],
+    x: &[f64],
+) -> f64 {
+    use std::arch::x86_64::*;
+    const LANES: usize = 8;
+    let n = values.len();
+    let chunks = n / LANES;
+    let mut acc = _mm512_setzero_pd();
+    for k in 0..chunks {
+        let offset = k * LANES;
+        let i = _mm512_loadu_si512(rows.as_ptr().add(offset) as *const __m512i);
+        let j = _mm512_loadu_si512(columns.as_ptr().add(offset) as *const __m512i);
+        let xi = _mm512_i64gather_pd::<8>(i, x.as_ptr());
+        let xj = _mm512_i64gather_pd::<8>(j, x.as_ptr());
+        let v = _mm512_loadu_pd(values.as_ptr().add(offset));
+        acc = _mm512_add_pd(acc, _mm512_mul_pd(_mm512_mul_pd(v, xi), xj));
+    }
+    let mut sum = _mm512_reduce_add_pd(acc);
+    let rest = chunks * LANES;
+    // The remainder of less than 8 terms is summed up by AVX2, which is implied by AVX-512F
+    sum += quadratic_sum_avx2(&rows[rest..], &columns[rest..], &values[rest..], x);
+    sum
+}
+
+#[cfg(target_arch = "aarch64")]
+unsafe fn quadratic_sum_neon(rows: &[usize], columns: &[usize], values: &[f64], x: &[f64]) -> f64 {
+    use std::arch::aarch64::*;
+    const LANES: usize = 2;
+    let n = values.len();
+    let chunks = n / LANES;
+    let mut acc = vdupq_n_f64(0.0);
+    for k in 0..chunks {
+        let offset = k * LANES;
+        let xi = [
+            *x.get_unchecked(*rows.get_unchecked(offset)),
+            *x.get_unchecked(*rows.get_unchecked(offset + 1)),
+        ];
+        let xj = [
+            *x.get_unchecked(*columns.get_unchecked(offset)),
+            *x.get_unchecked(*columns.get_unchecked(offset + 1)),
+        ];
+        let v = vld1q_f64(values.as_ptr().add(offset));
+        acc = vaddq_f64(
+            acc,
+            vmulq_f64(vmulq_f64(v, vld1q_f64(xi.as_ptr())), vld1q_f64(xj.as_ptr())),
+        );
+    }
+    let mut sum = vaddvq_f64(acc);
+    let rest = chunks * LANES;
+    sum += quadratic_sum_scalar(&rows[rest..], &columns[rest..], &values[rest..], x);
+    sum
+}
+
+/// Many states at once, accumulated into `out`
+///
+/// `xs` is a `num_variables x num_samples` matrix in row-major order,
+/// i.e. `xs[i * num_samples + s]` is the value of the `i`-th variable in the `s`-th sample,
+/// so that the inner loop over samples is contiguous and vectorized.
+/// `out` must have the length `num_samples`.
+pub fn quadratic_sum_batch(
+    rows: &[usize],
+    columns: &[usize],
+    values: &[f64],
+    xs: &[f64],
+    out: &mut [f64],
+) {
+    debug_assert!(rows.len() == values.len() && columns.len() == values.len());
+    #[cfg(target_arch = "x86_64")]
+    {
+        if is_x86_feature_detected!("avx512f") {
+            // SAFETY: AVX-512F is available
+            return unsafe { quadratic_sum_batch_avx512(rows, columns, values, xs, out) };
+        }
+        if is_x86_feature_detected!("avx2") {
+            // SAFETY: AVX2 is available
+            return unsafe { quadratic_sum_batch_avx2(rows, columns, values, xs, out) };
+        }
+    }
+    quadratic_sum_batch_scalar(rows, columns, values, xs, out)
+}
+
+/// Same code as [quadratic_sum_batch_scalar], but compiled with AVX2 to let the compiler vectorize the inner loop with 256-bit registers
+#[cfg(target_arch = "x86_64")]
+#[target_feature(enable = "avx2")]
+unsafe fn quadratic_sum_batch_avx2(
+    rows: &[usize],
+    columns: &[usize],
+    values: &[f64],
+    xs: &[f64],
+    out: &mut [f64],
+) {
+    quadratic_sum_batch_scalar(rows, columns, values, xs, out)
+}
+
+/// Same as [quadratic_sum_batch_avx2] with 512-bit registers
+#[cfg(target_arch = "x86_64")]
+#[target_feature(enable = "avx512f")]
+unsafe fn quadratic_sum_batch_avx512(
+    rows: &[usize],
+    columns: &[usize],
+    values: &[f64],
+    xs: &[f64],
+    out: &mut [f64],
+) {
+    quadratic_sum_batch_scalar(rows, columns, values, xs, out)
+}
+
+#[inline(always)]
+fn quadratic_sum_batch_scalar(
+    rows: &[usize],
+    columns: &[usize],
+    values: &[f64],
+    xs: &[f64],
+    out: &mut [f64],
+) {
+    let num_samples = out.len();
+    for ((i, j), v) in rows.iter().zip(columns).zip(values) {
+        let xi = &xs[i * num_samples..(i + 1) * num_samples];
+        let xj = &xs[j * num_samples..(j + 1) * num_samples];
+        for ((o, a), b) in out.iter_mut().zip(xi).zip(xj) {
+            *o += v * a * b;
+        }
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use proptest::prelude::*;
+
+    /// `(rows, columns, values, x)` with indices bounded by the length of `x`
+    fn coo() -> impl Strategy<Value = (Vec<usize>, Vec<usize>, Vec<f64>, Vec<f64>)> {
+        (1..20_usize, 0..67_usize).prop_flat_map(|(n, nnz)| {
+            (
+                proptest::collection::vec(0..n, nnz),
+                proptest::collection::vec(0..n, nnz),
+                proptest::collection::vec(-10.0..10.0, nnz),
+                proptest::collection::vec(-10.0..10.0, n),
+            )
+        })
+    }
+
+    /// Bound of the rounding error of summing up the terms in a different order
+    fn tolerance(rows: &[usize], columns: &[usize], values: &[f64], x: &[f64]) -> f64 {
+        let abs_sum: f64 = itertools::multizip((rows, columns, values))
+            .map(|(i, j, v)| (v * x[*i] * x[*j]).abs())
+            .sum();
+        1e-12 * abs_sum + f64::EPSILON
+    }
+
+    proptest! {
+        #[test]
+        fn quadratic_sum_matches_scalar((rows, columns, values, x) in coo()) {
+            let expected = quadratic_sum_scalar(&rows, &columns, &values, &x);
+            let tol = tolerance(&rows, &columns, &values, &x);
+            prop_assert!((quadratic_sum(&rows, &columns, &values, &x) - expected).abs() <= tol);
+
+            #[cfg(target_arch = "x86_64")]
+            if is_x86_feature_detected!("avx2") {
+                let avx2 = unsafe { quadratic_sum_avx2(&rows, &columns, &values, &x) };
+                prop_assert!((avx2 - expected).abs() <= tol);
+            }
+            #[cfg(target_arch = "x86_64")]
+            if is_x86_feature_detected!("avx512f") {
+                let avx512 = unsafe { quadratic_sum_avx512(&rows, &columns, &values, &x) };
+                prop_assert!((avx512 - expected).abs() <= tol);
+            }
+            #[cfg(target_arch = "aarch64")]
+            if cfg!(target_feature = "neon") {
+                let neon = unsafe { quadratic_sum_neon(&rows, &columns, &values, &x) };
+                prop_assert!((neon - expected).abs() <= tol);
+            }
+        }
+
+        #[test]
+        fn quadratic_sum_batch_matches_scalar(
+            (rows, columns, values, x) in coo(),
+            num_samples in 1..9_usize,
+        ) {
+            // Every sample is a scaled copy of `x`, laid out as `num_variables x num_samples`
+            let n = x.len();
+            let mut xs = vec![0.0; n * num_samples];
+            for i in 0..n {
+                for s in 0..num_samples {
+                    xs[i * num_samples + s] = x[i] * (s + 1) as f64;
+                }
+            }
+            let mut out = vec![0.0; num_samples];
+            quadratic_sum_batch(&rows, &columns, &values, &xs, &mut out);
+            for (s, value) in out.iter().enumerate() {
+                let sample: Vec<f64> = (0..n).map(|i| xs[i * num_samples + s]).collect();
+                let expected = quadratic_sum_scalar(&rows, &columns, &values, &sample);
+                prop_assert!((value - expected).abs() <= tolerance(&rows, &columns, &values, &sample));
+            }
+        }
+    }
+}
@@ -3,7 +3,7 @@
 use crate::v1::{
     function::{self, Function as FunctionEnum},
     linear::Term,
-    Function, Linear, Polynomial, Quadratic, State,
+    ColumnarLinear, DenseState, Function, Linear, Polynomial, Quadratic, State,
 };
 use std::collections::{BTreeSet, HashMap};
 
@@ -29,9 +29,146 @@ impl From<Quadratic> for Function {
     }
 }
 
+impl From<Polynomial> for Function {
+    fn from(poly: Polynomial) -> Self {
+        Self {
+            function: Some(function::Function::Polynomial(poly)),
+        }
+    }
+}
+
+impl From<ColumnarLinear> for Function {
+    fn from(linear: ColumnarLinear) -> Self {
+        Self {
+            function: Some(function::Function::ColumnarLinear(linear)),
+        }
+    }
+}
+
+impl From<Linear> for ColumnarLinear {
+    fn from(linear: Linear) -> Self {
+        Self::new(
+            linear
+                .terms
+                .into_iter()
+                .map(|term| (term.id, term.coefficient)),
+            linear.constant,
+        )
+    }
+}
+
+impl From<ColumnarLinear> for Linear {
+    fn from(linear: ColumnarLinear) -> Self {
+        Self::new(linear.terms(), linear.constant)
+    }
+}
+
 impl From<HashMap<u64, f64>> for State {
     fn from(entries: HashMap<u64, f64>) -> Self {
-        Self { entries }
+        Self {
+            entries,
+            dense: None,
+        }
+    }
+}
+
+impl From<DenseState> for State {
+    fn from(dense: DenseState) -> Self {
+        Self {
+            entries: HashMap::new(),
+            dense: Some(dense),
+        }
+    }
+}
+
+impl State {
+    /// State of the variables of IDs `offset, offset + 1, ...` in the dense form
+    pub fn dense(offset: u64, values: Vec<f64>) -> Self {
+        DenseState { offset, values }.into()
+    }
+
+    /// Value of the variable, looked up in [State::dense] first, and then in [State::entries]
+    ///
+    /// ```rust
+    /// use ommx::v1::State;
+    /// use maplit::hashmap;
+    ///
+    /// let mut state = State::dense(10, vec![1.0, 2.0]);
+    /// state.entries = hashmap! { 0 => 3.0 };
+    /// assert_eq!(state.get(11), Some(2.0));
+    /// assert_eq!(state.get(0), Some(3.0));
+    /// assert_eq!(state.get(12), None);
+    /// ```
+    #[inline]
+    pub fn get(&self, id: u64) -> Option<f64> {
+        if let Some(dense) = &self.dense {
+            if let Some(value) = id
+                .checked_sub(dense.offset)
+                .and_then(|i| dense.values.get(i as usize))
+            {
+                return Some(*value);
+            }
+        }
+        self.entries.get(&id).copied()
+    }
+
+    /// Number of the variables, counting an ID stored in both forms once
+    pub fn len(&self) -> usize {
+        self.iter().count()
+    }
+
+    pub fn is_empty(&self) -> bool {
+        self.entries.is_empty() && self.dense.as_ref().map_or(true, |d| d.values.is_empty())
+    }
+
+    /// Iterate over `(id, value)` of both forms. The order is not specified.
+    pub fn iter(&self) -> impl Iterator<Item = (u64, f64)> + '_ {
+        let dense = self.dense.as_ref();
+        let dense_ids = dense.map_or(0..0, |d| d.offset..d.offset + d.values.len() as u64);
+        dense
+            .into_iter()
+            .flat_map(|d| (d.offset..).zip(d.values.iter().copied()))
+            .chain(
+                self.entries
+                    .iter()
+                    .filter(move |(id, _)| !dense_ids.contains(id))
+                    .map(|(id, value)| (*id, *value)),
+            )
+    }
+
+    /// Convert into the map form, i.e. only [State::entries] is set
+    pub fn into_entries(self) -> HashMap<u64, f64> {
+        if self.dense.is_none() {
+            return self.entries;
+        }
+        self.iter().collect()
+    }
+
+    /// Convert into the dense form if the IDs are contiguous. Otherwise the state is returned in the map form.
+    ///
+    /// ```rust
+    /// use ommx::v1::State;
+    /// use maplit::hashmap;
+    ///
+    /// let state: State = hashmap! { 3 => 1.0, 4 => 2.0, 5 => 3.0 }.into();
+    /// assert_eq!(state.into_dense(), State::dense(3, vec![1.0, 2.0, 3.0]));
+    ///
+    /// let state: State = hashmap! { 3 => 1.0, 5 => 3.0 }.into();
+    /// assert_eq!(state.clone().into_dense(), state);
+    /// ```
+    pub fn into_dense(self) -> Self {
+        let entries = self.into_entries();
+        let (Some(min), Some(max)) = (entries.keys().min(), entries.keys().max()) else {
+            return entries.into();
+        };
+        if max - min + 1 != entries.len() as u64 {
+            return entries.into();
+        }
+        let mut values = vec![0.0; entries.len()];
+        for (id, value) in &entries {
+            values[(id - min) as usize] = *value;
+        }
+        Self::dense(*min, values)
     }
 }
 
@@ -41,6 +178,7 @@ impl Function {
             Some(FunctionEnum::Linear(linear)) => linear.used_decision_variable_ids(),
             Some(FunctionEnum::Quadratic(quadratic)) => quadratic.used_decision_variable_ids(),
             Some(FunctionEnum::Polynomial(poly)) => poly.used_decision_variable_ids(),
+            Some(FunctionEnum::ColumnarLinear(linear)) => linear.used_decision_variable_ids(),
             _ => BTreeSet::new(),
         }
     }
@@ -61,6 +199,29 @@ impl Linear {
     }
 }
 
+impl ColumnarLinear {
+    pub fn new(terms: impl Iterator<Item = (u64, f64)>, constant: f64) -> Self {
+        let (ids, coefficients) = terms.unzip();
+        Self {
+            ids,
+            coefficients,
+            constant,
+        }
+    }
+
+    /// Pairs of ID and coefficient. Extra entries are ignored if `ids` and `coefficients` have different lengths.
+    pub fn terms(&self) -> impl Iterator<Item = (u64, f64)> + '_ {
+        self.ids
+            .iter()
+            .cloned()
+            .zip(self.coefficients.iter().cloned())
+    }
+
+    pub fn used_decision_variable_ids(&self) -> BTreeSet<u64> {
+        self.ids.iter().cloned().collect()
+    }
+}
+
 impl Quadratic {
     pub fn used_decision_variable_ids(&self) -> BTreeSet<u64> {
         self.columns
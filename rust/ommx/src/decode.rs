@@ -0,0 +1,151 @@
+//! Fast path decoder of large [Instance] messages
+//!
+//! [Message::decode] decodes all the constraints and decision variables one by one on a single thread.
+//! [Instance::decode_parallel] first scans the boundaries of the top-level fields,
+//! and then decodes the elements of the repeated fields in parallel.
+
+use crate::v1::{Constraint, DecisionVariable, Instance};
+use anyhow::{bail, ensure, Context, Result};
+use prost::Message;
+use rayon::prelude::*;
+use std::ops::Range;
+
+/// Field number of `Instance.decision_variables`
+const DECISION_VARIABLES: u64 = 2;
+/// Field number of `Instance.constraints`
+const CONSTRAINTS: u64 = 4;
+
+/// Messages smaller than this are decoded by [Message::decode] since scanning does not pay off
+const PARALLEL_THRESHOLD: usize = 1 << 20;
+
+fn decode_varint(buf: &[u8], pos: &mut usize) -> Result<u64> {
+    let mut value = 0_u64;
+    for shift in (0..64).step_by(7) {
+        let byte = *buf.get(*pos).context("Truncated varint")?;
+        *pos += 1;
+        value |= ((byte & 0x7f) as u64) << shift;
+        if byte & 0x80 == 0 {
+            return Ok(value);
+        }
+    }
+    bail!("Invalid varint")
+}
+
+/// Top-level fields of the serialized [Instance]
+#[derive(Default)]
+struct Fields {
+    decision_variables: Vec<Range<usize>>,
+    constraints: Vec<Range<usize>>,
+    /// Other fields copied as is, which are small and decoded by [Message::decode]
+    rest: Vec<u8>,
+}
+
+fn scan(buf: &[u8]) -> Result<Fields> {
+    let mut fields = Fields::default();
+    let mut pos = 0;
+    while pos < buf.len() {
+        let start = pos;
+        let key = decode_varint(buf, &mut pos)?;
+        let (field, wire_type) = (key >> 3, key & 0x7);
+        match wire_type {
+            // varint
+            0 => {
+                decode_varint(buf, &mut pos)?;
+            }
+            // 64-bit
+            1 => pos += 8,
+            // length-delimited
+            2 => {
+                let len = decode_varint(buf, &mut pos)? as usize;
+                let body = pos..pos.checked_add(len).context("Invalid length")?;
+                pos = body.end;
+                ensure!(pos <= buf.len(), "Truncated field {}", field);
+                match field {
+                    DECISION_VARIABLES => fields.decision_variables.push(body),
+                    CONSTRAINTS => fields.constraints.push(body),
+                    _ => fields.rest.extend_from_slice(&buf[start..pos]),
+                }
+                continue;
+            }
+            // 32-bit
+            5 => pos += 4,
+            _ => bail!("Unsupported wire type {} of field {}", wire_type, field),
+        }
+        ensure!(pos <= buf.len(), "Truncated field {}", field);
+        fields.rest.extend_from_slice(&buf[start..pos]);
+    }
+    Ok(fields)
+}
+
+fn decode_all<T: Message + Default>(buf: &[u8], ranges: &[Range<usize>]) -> Result<Vec<T>> {
+    Ok(ranges
+        .par_iter()
+        .map(|range| T::decode(&buf[range.clone()]))
+        .collect::<Result<Vec<_>, _>>()?)
+}
+
+impl Instance {
+    /// Decode the serialized instance, decoding constraints and decision variables in parallel if it is large
+    ///
+    /// The result is the same as [Message::decode], including the order of the repeated fields.
+    ///
+    /// ```rust
+    /// use ommx::{v1::Instance, random::random_lp, Message};
+    /// use rand::SeedableRng;
+    ///
+    /// let mut rng = rand_xoshiro::Xoshiro256StarStar::seed_from_u64(0);
+    /// let instance = random_lp(&mut rng, 1000, 300);
+    /// let buf = instance.encode_to_vec();
+    /// assert!(buf.len() > 1 << 20); // large enough to be decoded in parallel
+    /// assert_eq!(Instance::decode_parallel(&buf).unwrap(), instance);
+    /// ```
+    #[tracing::instrument(skip_all, fields(bytes = buf.len()))]
+    pub fn decode_parallel(buf: &[u8]) -> Result<Self> {
+        if buf.len() < PARALLEL_THRESHOLD {
+            return Ok(Self::decode(buf)?);
+        }
+        decode_scanned(buf)
+    }
+}
+
+/// Parallel path of [Instance::decode_parallel] regardless of the size
+fn decode_scanned(buf: &[u8]) -> Result<Instance> {
+    let fields = scan(buf)?;
+    let (decision_variables, constraints) = rayon::join(
+        || decode_all::<DecisionVariable>(buf, &fields.decision_variables),
+        || decode_all::<Constraint>(buf, &fields.constraints),
+    );
+    let mut instance = Instance::decode(fields.rest.as_slice())?;
+    instance.decision_variables = decision_variables?;
+    instance.constraints = constraints?;
+    Ok(instance)
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use crate::InstanceParameter;
+    use proptest::prelude::*;
+
+    proptest! {
+        #[test]
+        fn decode_scanned_matches_decode(
+            instance in any::<InstanceParameter>().prop_flat_map(any_with::<Instance>)
+        ) {
+            let buf = instance.encode_to_vec();
+            prop_assert_eq!(decode_scanned(&buf).unwrap(), Instance::decode(buf.as_slice()).unwrap());
+            prop_assert_eq!(Instance::decode_parallel(&buf).unwrap(), instance);
+        }
+
+        /// Concatenated messages are merged, i.e. the repeated fields of both are kept in order
+        #[test]
+        fn decode_scanned_merges_concatenated(
+            first in any::<InstanceParameter>().prop_flat_map(any_with::<Instance>),
+            second in any::<InstanceParameter>().prop_flat_map(any_with::<Instance>),
+        ) {
+            let mut buf = first.encode_to_vec();
+            second.encode(&mut buf).unwrap();
+            prop_assert_eq!(decode_scanned(&buf).unwrap(), Instance::decode(buf.as_slice()).unwrap());
+        }
+    }
+}
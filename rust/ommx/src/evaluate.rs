@@ -1,16 +1,78 @@
 use crate::v1::{
-    function::Function as FunctionEnum, linear::Term as LinearTerm, Constraint, Equality,
-    EvaluatedConstraint, Function, Instance, Linear, Optimality, Polynomial, Quadratic, Relaxation,
-    Solution, State,
+    function::Function as FunctionEnum, linear::Term as LinearTerm, ColumnarLinear, Constraint,
+    Equality, EvaluatedConstraint, Function, Instance, Linear, Optimality, Polynomial, Quadratic,
+    Relaxation, Solution, State,
 };
-use anyhow::{bail, Context, Result};
+use anyhow::{bail, ensure, Context, Result};
 use std::collections::BTreeSet;
 
+/// Default absolute tolerance of constraint violation used in [Instance::evaluate][Evaluate::evaluate]
+pub const DEFAULT_FEASIBILITY_ATOL: f64 = 1e-6;
+
+/// Whether the value of a constraint function violates the constraint beyond `atol`.
+///
+/// This returns `false` for `NaN`, the same as the comparisons used since the first version of [Instance::evaluate][Evaluate::evaluate].
+pub(crate) fn is_violated(equality: Equality, value: f64, atol: f64) -> bool {
+    match equality {
+        Equality::EqualToZero => value.abs() > atol,
+        _ => value > atol,
+    }
+}
+
+pub(crate) fn constraint_equality(c: &Constraint) -> Result<Equality> {
+    match Equality::try_from(c.equality) {
+        Ok(Equality::EqualToZero) => Ok(Equality::EqualToZero),
+        Ok(Equality::LessThanOrEqualToZero) => Ok(Equality::LessThanOrEqualToZero),
+        _ => bail!("Unsupported equality: {:?}", c.equality),
+    }
+}
+
 /// Evaluate with a [State]
 pub trait Evaluate {
     type Output;
     /// Evaluate to return the output with used variable ids
     fn evaluate(&self, solution: &State) -> Result<(Self::Output, BTreeSet<u64>)>;
+
+    /// Evaluate to return only the output, without collecting used variable ids into a set
+    ///
+    /// The default implementation discards the IDs returned by [Evaluate::evaluate].
+    fn evaluate_value(&self, solution: &State) -> Result<Self::Output> {
+        self.evaluate(solution).map(|(value, _)| value)
+    }
+}
+
+/// Decision variable IDs used in the objective and constraints of an [Instance], which do not depend on the state
+///
+/// [Instance::evaluate_with_atol] collects them once for each call.
+/// Build this once by [UsedDecisionVariableIds::new] and pass it to [Instance::evaluate_with_used_ids]
+/// to evaluate many states without collecting the IDs again.
+#[derive(Debug, Clone, PartialEq, Default)]
+pub struct UsedDecisionVariableIds {
+    /// IDs used in the objective or any constraint
+    pub all: BTreeSet<u64>,
+    /// Sorted IDs used in each constraint, in the order of [Instance::constraints]
+    pub constraints: Vec<Vec<u64>>,
+}
+
+impl UsedDecisionVariableIds {
+    pub fn new(instance: &Instance) -> Result<Self> {
+        let mut all = instance
+            .objective
+            .as_ref()
+            .context("Objective is not set")?
+            .used_decision_variable_ids();
+        let mut constraints = Vec::with_capacity(instance.constraints.len());
+        for c in &instance.constraints {
+            let ids = c
+                .function
+                .as_ref()
+                .context("Function is not set")?
+                .used_decision_variable_ids();
+            constraints.push(ids.iter().cloned().collect::<Vec<_>>());
+            all.extend(ids);
+        }
+        Ok(Self { all, constraints })
+    }
 }
 
 impl Evaluate for Function {
@@ -21,10 +83,22 @@ impl Evaluate for Function {
             Some(FunctionEnum::Linear(linear)) => linear.evaluate(solution)?,
             Some(FunctionEnum::Quadratic(quadratic)) => quadratic.evaluate(solution)?,
             Some(FunctionEnum::Polynomial(poly)) => poly.evaluate(solution)?,
+            Some(FunctionEnum::ColumnarLinear(linear)) => linear.evaluate(solution)?,
             None => bail!("Function is not set"),
         };
         Ok(out)
     }
+
+    fn evaluate_value(&self, solution: &State) -> Result<f64> {
+        match &self.function {
+            Some(FunctionEnum::Constant(c)) => Ok(*c),
+            Some(FunctionEnum::Linear(linear)) => linear.evaluate_value(solution),
+            Some(FunctionEnum::Quadratic(quadratic)) => quadratic.evaluate_value(solution),
+            Some(FunctionEnum::Polynomial(poly)) => poly.evaluate_value(solution),
+            Some(FunctionEnum::ColumnarLinear(linear)) => linear.evaluate_value(solution),
+            None => bail!("Function is not set"),
+        }
+    }
 }
 
 impl Evaluate for Linear {
@@ -35,13 +109,55 @@ impl Evaluate for Linear {
         for LinearTerm { id, coefficient } in &self.terms {
             used_ids.insert(*id);
             let s = solution
-                .entries
-                .get(id)
+                .get(*id)
                 .with_context(|| format!("Variable id ({id}) is not found in the solution"))?;
             sum += coefficient * s;
         }
         Ok((sum, used_ids))
     }
+
+    fn evaluate_value(&self, solution: &State) -> Result<f64> {
+        let mut sum = self.constant;
+        for LinearTerm { id, coefficient } in &self.terms {
+            let s = solution
+                .get(*id)
+                .with_context(|| format!("Variable id ({id}) is not found in the solution"))?;
+            sum += coefficient * s;
+        }
+        Ok(sum)
+    }
+}
+
+impl ColumnarLinear {
+    fn ensure_same_length(&self) -> Result<()> {
+        ensure!(
+            self.ids.len() == self.coefficients.len(),
+            "Lengths of ids ({}) and coefficients ({}) are different in ColumnarLinear",
+            self.ids.len(),
+            self.coefficients.len()
+        );
+        Ok(())
+    }
+}
+
+impl Evaluate for ColumnarLinear {
+    type Output = f64;
+    fn evaluate(&self, solution: &State) -> Result<(f64, BTreeSet<u64>)> {
+        let sum = self.evaluate_value(solution)?;
+        Ok((sum, self.ids.iter().cloned().collect()))
+    }
+
+    fn evaluate_value(&self, solution: &State) -> Result<f64> {
+        self.ensure_same_length()?;
+        let mut sum = self.constant;
+        for (id, coefficient) in self.ids.iter().zip(&self.coefficients) {
+            let s = solution
+                .get(*id)
+                .with_context(|| format!("Variable id ({id}) is not found in the solution"))?;
+            sum += coefficient * s;
+        }
+        Ok(sum)
+    }
 }
 
 impl Evaluate for Quadratic {
@@ -59,17 +175,35 @@ impl Evaluate for Quadratic {
             used_ids.insert(*j);
 
             let u = solution
-                .entries
-                .get(i)
+                .get(*i)
                 .with_context(|| format!("Variable id ({i}) is not found in the solution"))?;
             let v = solution
-                .entries
-                .get(j)
+                .get(*j)
                 .with_context(|| format!("Variable id ({j}) is not found in the solution"))?;
             sum += value * u * v;
         }
         Ok((sum, used_ids))
     }
+
+    fn evaluate_value(&self, solution: &State) -> Result<f64> {
+        let mut sum = if let Some(linear) = &self.linear {
+            linear.evaluate_value(solution)?
+        } else {
+            0.0
+        };
+        for (i, j, value) in
+            itertools::multizip((self.rows.iter(), self.columns.iter(), self.values.iter()))
+        {
+            let u = solution
+                .get(*i)
+                .with_context(|| format!("Variable id ({i}) is not found in the solution"))?;
+            let v = solution
+                .get(*j)
+                .with_context(|| format!("Variable id ({j}) is not found in the solution"))?;
+            sum += value * u * v;
+        }
+        Ok(sum)
+    }
 }
 
 impl Evaluate for Polynomial {
@@ -82,14 +216,27 @@ impl Evaluate for Polynomial {
             for id in &term.ids {
                 used_ids.insert(*id);
                 v *= solution
-                    .entries
-                    .get(id)
+                    .get(*id)
                     .with_context(|| format!("Variable id ({id}) is not found in the solution"))?;
             }
             sum += v;
         }
         Ok((sum, used_ids))
     }
+
+    fn evaluate_value(&self, solution: &State) -> Result<f64> {
+        let mut sum = 0.0;
+        for term in &self.terms {
+            let mut v = term.coefficient;
+            for id in &term.ids {
+                v *= solution
+                    .get(*id)
+                    .with_context(|| format!("Variable id ({id}) is not found in the solution"))?;
+            }
+            sum += v;
+        }
+        Ok(sum)
+    }
 }
 
 impl Evaluate for Constraint {
@@ -116,50 +263,170 @@ impl Evaluate for Constraint {
             used_ids,
         ))
     }
+
+    /// Evaluate only the value of the function.
+    /// `used_decision_variable_ids` is filled from [Function::used_decision_variable_ids]
+    /// since it does not depend on the state.
+    fn evaluate_value(&self, solution: &State) -> Result<Self::Output> {
+        let function = self.function.as_ref().context("Function is not set")?;
+        let evaluated_value = function.evaluate_value(solution)?;
+        Ok(EvaluatedConstraint {
+            id: self.id,
+            equality: self.equality,
+            evaluated_value,
+            used_decision_variable_ids: function.used_decision_variable_ids().into_iter().collect(),
+            name: self.name.clone(),
+            parameters: self.parameters.clone(),
+            description: self.description.clone(),
+            dual_variable: None,
+        })
+    }
 }
 
 impl Evaluate for Instance {
     type Output = Solution;
 
     fn evaluate(&self, state: &State) -> Result<(Self::Output, BTreeSet<u64>)> {
-        let mut used_ids = BTreeSet::new();
-        let mut evaluated_constraints = Vec::new();
+        let used_ids = UsedDecisionVariableIds::new(self)?;
+        let solution = self.evaluate_with_used_ids(state, DEFAULT_FEASIBILITY_ATOL, &used_ids)?;
+        Ok((solution, used_ids.all))
+    }
+
+    /// Same as [Instance::evaluate_with_atol] with [DEFAULT_FEASIBILITY_ATOL]
+    fn evaluate_value(&self, state: &State) -> Result<Self::Output> {
+        self.evaluate_with_atol(state, DEFAULT_FEASIBILITY_ATOL)
+    }
+}
+
+impl Instance {
+    /// Evaluate the instance, regarding constraints violated more than `atol` as infeasible
+    pub fn evaluate_with_atol(&self, state: &State, atol: f64) -> Result<Solution> {
+        self.evaluate_with_used_ids(state, atol, &UsedDecisionVariableIds::new(self)?)
+    }
+
+    /// Same as [Instance::evaluate_with_atol], but `used_decision_variable_ids` of the evaluated constraints
+    /// are taken from `used_ids` built once for this instance
+    ///
+    /// ```rust
+    /// use ommx::{random::random_lp, v1::State, UsedDecisionVariableIds};
+    /// use rand::SeedableRng;
+    ///
+    /// let mut rng = rand_xoshiro::Xoshiro256StarStar::seed_from_u64(0);
+    /// let instance = random_lp(&mut rng, 3, 2);
+    /// let used_ids = UsedDecisionVariableIds::new(&instance).unwrap();
+    /// for x in [1.0, 2.0] {
+    ///     let state = State::dense(0, vec![x; 3]);
+    ///     assert_eq!(
+    ///         instance.evaluate_with_used_ids(&state, 1e-6, &used_ids).unwrap(),
+    ///         instance.evaluate_with_atol(&state, 1e-6).unwrap()
+    ///     );
+    /// }
+    /// ```
+    #[tracing::instrument(skip_all, fields(decision_variables = self.decision_variables.len(), constraints = self.constraints.len()))]
+    pub fn evaluate_with_used_ids(
+        &self,
+        state: &State,
+        atol: f64,
+        used_ids: &UsedDecisionVariableIds,
+    ) -> Result<Solution> {
+        ensure!(
+            used_ids.constraints.len() == self.constraints.len(),
+            "Used IDs are built for another instance"
+        );
+        let mut evaluated_constraints = Vec::with_capacity(self.constraints.len());
         let mut feasible = true;
-        for c in &self.constraints {
-            let (c, used_ids_) = c.evaluate(state)?;
-            used_ids.extend(used_ids_);
-            if c.equality == Equality::EqualToZero as i32 {
-                // FIXME: Add a way to specify the tolerance
-                if c.evaluated_value.abs() > 1e-6 {
-                    feasible = false;
-                }
-            } else if c.equality == Equality::LessThanOrEqualToZero as i32 {
-                if c.evaluated_value > 1e-6 {
-                    feasible = false;
-                }
-            } else {
-                bail!("Unsupported equality: {:?}", c.equality);
+        for (c, ids) in self.constraints.iter().zip(&used_ids.constraints) {
+            let equality = constraint_equality(c)?;
+            let evaluated_value = c
+                .function
+                .as_ref()
+                .context("Function is not set")?
+                .evaluate_value(state)?;
+            if is_violated(equality, evaluated_value, atol) {
+                feasible = false;
             }
-            evaluated_constraints.push(c);
+            evaluated_constraints.push(EvaluatedConstraint {
+                id: c.id,
+                equality: c.equality,
+                evaluated_value,
+                used_decision_variable_ids: ids.clone(),
+                name: c.name.clone(),
+                parameters: c.parameters.clone(),
+                description: c.description.clone(),
+                dual_variable: None,
+            });
         }
 
-        let (objective, used_ids_) = self
+        let objective = self
             .objective
             .as_ref()
             .context("Objective is not set")?
-            .evaluate(state)?;
-        used_ids.extend(used_ids_);
-        Ok((
-            Solution {
-                decision_variables: self.decision_variables.clone(),
-                state: Some(state.clone()),
-                evaluated_constraints,
-                feasible,
-                objective,
-                optimality: Optimality::Unspecified.into(),
-                relaxation: Relaxation::Unspecified.into(),
-            },
-            used_ids,
-        ))
+            .evaluate_value(state)?;
+        Ok(Solution {
+            decision_variables: self.decision_variables.clone(),
+            state: Some(state.clone()),
+            evaluated_constraints,
+            feasible,
+            objective,
+            optimality: Optimality::Unspecified.into(),
+            relaxation: Relaxation::Unspecified.into(),
+        })
+    }
+
+    /// Find the first constraint violated more than `atol`, without evaluating the remaining constraints and the objective
+    ///
+    /// ```rust
+    /// use ommx::v1::{Constraint, Equality, Function, Instance, Linear};
+    /// use maplit::hashmap;
+    ///
+    /// // x1 - 1 <= 0, x1 + x2 - 1 <= 0
+    /// let instance = Instance {
+    ///     objective: Some(Linear::new([(1, 1.0)].into_iter(), 0.0).into()),
+    ///     constraints: vec![
+    ///         Constraint {
+    ///             id: 0,
+    ///             equality: Equality::LessThanOrEqualToZero as i32,
+    ///             function: Some(Linear::new([(1, 1.0)].into_iter(), -1.0).into()),
+    ///             ..Default::default()
+    ///         },
+    ///         Constraint {
+    ///             id: 1,
+    ///             equality: Equality::LessThanOrEqualToZero as i32,
+    ///             function: Some(Linear::new([(1, 1.0), (2, 1.0)].into_iter(), -1.0).into()),
+    ///             ..Default::default()
+    ///         },
+    ///     ],
+    ///     ..Default::default()
+    /// };
+    ///
+    /// let state = hashmap! { 1 => 1.0, 2 => 1.0 }.into();
+    /// let violated = instance.find_violated_constraint(&state, 1e-6).unwrap();
+    /// assert_eq!(violated.map(|c| c.id), Some(1));
+    /// assert!(!instance.is_feasible(&state, 1e-6).unwrap());
+    /// // Feasible with a loose tolerance
+    /// assert!(instance.is_feasible(&state, 1.0).unwrap());
+    /// ```
+    pub fn find_violated_constraint(
+        &self,
+        state: &State,
+        atol: f64,
+    ) -> Result<Option<&Constraint>> {
+        for c in &self.constraints {
+            let equality = constraint_equality(c)?;
+            let value = c
+                .function
+                .as_ref()
+                .context("Function is not set")?
+                .evaluate_value(state)?;
+            if is_violated(equality, value, atol) {
+                return Ok(Some(c));
+            }
+        }
+        Ok(None)
+    }
+
+    /// Check feasibility with early exit, see [Instance::find_violated_constraint]
+    pub fn is_feasible(&self, state: &State, atol: f64) -> Result<bool> {
+        Ok(self.find_violated_constraint(state, atol)?.is_none())
     }
 }
@@ -0,0 +1,270 @@
+//! Solver input formats of linear [Instance]s: [MPS][mps] and [CPLEX LP][lp]
+//!
+//! Writers stream the instance into a buffered writer without building strings for each term,
+//! and readers build the instance directly from the text.
+//!
+//! Decision variables and constraints are written as `x{id}` and `c{id}`, and the objective as `obj`,
+//! since [DecisionVariable::name] is not unique and may contain characters not allowed in these formats.
+//! Readers take IDs back from these names. When a file uses other names, IDs are assigned in the order of appearance,
+//! and the names are stored in [DecisionVariable::name] and [Constraint::name].
+//!
+//! Only linear objectives and constraints are supported, and quadratic ones are rejected with an error.
+//! Decision variables without [Bound] are written as unbounded, or in `[0, 1]` for binary variables,
+//! and always read with explicit bounds.
+
+pub mod lp;
+pub mod mps;
+
+use crate::v1::{
+    decision_variable::Kind, function::Function as FunctionEnum, instance::Sense, Bound,
+    Constraint, DecisionVariable, Equality, Function, Instance, Linear,
+};
+use anyhow::{bail, Context, Result};
+use std::{
+    collections::{BTreeMap, HashMap, HashSet},
+    fmt,
+};
+
+/// Linear terms and constant of the function
+fn linear_terms(function: &Function) -> Result<(Box<dyn Iterator<Item = (u64, f64)> + '_>, f64)> {
+    Ok(match &function.function {
+        Some(FunctionEnum::Constant(c)) => (Box::new(std::iter::empty()), *c),
+        Some(FunctionEnum::Linear(linear)) => (
+            Box::new(linear.terms.iter().map(|t| (t.id, t.coefficient))),
+            linear.constant,
+        ),
+        Some(FunctionEnum::ColumnarLinear(linear)) => (Box::new(linear.terms()), linear.constant),
+        Some(_) => bail!("Only linear functions can be written in MPS or LP format"),
+        None => bail!("Function is not set"),
+    })
+}
+
+fn constraint_terms(c: &Constraint) -> Result<(Box<dyn Iterator<Item = (u64, f64)> + '_>, f64)> {
+    linear_terms(c.function.as_ref().context("Function is not set")?)
+        .with_context(|| format!("Constraint (id = {})", c.id))
+}
+
+/// Kind and bound of a decision variable to be written
+#[derive(Debug, Clone, Copy, PartialEq)]
+struct Column {
+    kind: Kind,
+    lower: f64,
+    upper: f64,
+}
+
+impl Column {
+    fn new(dv: &DecisionVariable) -> Result<Self> {
+        let kind = match Kind::try_from(dv.kind) {
+            Ok(Kind::Unspecified) | Err(_) => {
+                bail!(
+                    "Kind of decision variable (id = {}) is not specified",
+                    dv.id
+                )
+            }
+            Ok(kind) => kind,
+        };
+        let (lower, upper) = match (&dv.bound, kind) {
+            (Some(bound), _) => (bound.lower, bound.upper),
+            (None, Kind::Binary) => (0.0, 1.0),
+            (None, _) => (f64::NEG_INFINITY, f64::INFINITY),
+        };
+        Ok(Self { kind, lower, upper })
+    }
+
+    fn is_integer(&self) -> bool {
+        matches!(self.kind, Kind::Integer | Kind::SemiInteger)
+    }
+
+    fn is_semi(&self) -> bool {
+        matches!(self.kind, Kind::SemiContinuous | Kind::SemiInteger)
+    }
+}
+
+/// Columns sorted by ID, including decision variables used in the functions but not registered in the instance as continuous and unbounded
+fn columns(instance: &Instance) -> Result<BTreeMap<u64, Column>> {
+    let mut columns = BTreeMap::new();
+    for dv in &instance.decision_variables {
+        columns.insert(dv.id, Column::new(dv)?);
+    }
+    let unregistered = Column {
+        kind: Kind::Continuous,
+        lower: f64::NEG_INFINITY,
+        upper: f64::INFINITY,
+    };
+    if let Some(objective) = &instance.objective {
+        for (id, _) in linear_terms(objective)?.0 {
+            columns.entry(id).or_insert(unregistered);
+        }
+    }
+    for c in &instance.constraints {
+        for (id, _) in constraint_terms(c)?.0 {
+            columns.entry(id).or_insert(unregistered);
+        }
+    }
+    Ok(columns)
+}
+
+/// Shown in the shortest form parsed back to the same value, in the exponential form for large or small values
+struct Num(f64);
+
+impl fmt::Display for Num {
+    fn fmt(&self, f: &mut fmt::Formatter<'_>) -> fmt::Result {
+        let abs = self.0.abs();
+        if abs == 0.0 || (1e-5..1e16).contains(&abs) {
+            write!(f, "{}", self.0)
+        } else {
+            write!(f, "{:e}", self.0)
+        }
+    }
+}
+
+/// Names of decision variables or constraints in the order of appearance in a file
+#[derive(Debug, Default)]
+struct NameTable {
+    names: Vec<String>,
+    index: HashMap<String, usize>,
+}
+
+impl NameTable {
+    fn get_or_insert(&mut self, name: &str) -> usize {
+        if let Some(i) = self.index.get(name) {
+            return *i;
+        }
+        let i = self.names.len();
+        self.names.push(name.to_string());
+        self.index.insert(name.to_string(), i);
+        i
+    }
+
+    /// IDs parsed from the names `{prefix}{id}` with `None` names,
+    /// or the order of appearance with the names if any name is not of this form or IDs are duplicated
+    fn into_ids(self, prefix: char) -> Vec<(u64, Option<String>)> {
+        let parsed: Option<Vec<u64>> = self
+            .names
+            .iter()
+            .map(|name| name.strip_prefix(prefix)?.parse().ok())
+            .collect();
+        let unique = |ids: &Vec<u64>| ids.iter().collect::<HashSet<_>>().len() == ids.len();
+        match parsed {
+            Some(ids) if unique(&ids) => ids.into_iter().map(|id| (id, None)).collect(),
+            _ => self
+                .names
+                .into_iter()
+                .enumerate()
+                .map(|(i, name)| (i as u64, Some(name)))
+                .collect(),
+        }
+    }
+}
+
+/// Decision variable read from a file, before assigning its ID
+#[derive(Debug, Clone, Default)]
+struct ReadColumn {
+    integer: bool,
+    binary: bool,
+    semi: bool,
+    lower: Option<f64>,
+    upper: Option<f64>,
+}
+
+impl ReadColumn {
+    fn into_decision_variable(self, id: u64, name: Option<String>) -> DecisionVariable {
+        let kind = match (self.binary, self.integer, self.semi) {
+            (true, _, _) => Kind::Binary,
+            (false, true, true) => Kind::SemiInteger,
+            (false, true, false) => Kind::Integer,
+            (false, false, true) => Kind::SemiContinuous,
+            (false, false, false) => Kind::Continuous,
+        };
+        let (default_lower, default_upper) = if self.binary {
+            (0.0, 1.0)
+        } else {
+            (0.0, f64::INFINITY)
+        };
+        DecisionVariable {
+            id,
+            kind: kind as i32,
+            bound: Some(Bound {
+                lower: self.lower.unwrap_or(default_lower),
+                upper: self.upper.unwrap_or(default_upper),
+            }),
+            name,
+            ..Default::default()
+        }
+    }
+}
+
+/// Linear function `terms + constant` of the columns read from a file
+#[derive(Debug, Clone, Default)]
+struct ReadFunction {
+    terms: Vec<(usize, f64)>,
+    constant: f64,
+}
+
+impl ReadFunction {
+    fn into_function(self, ids: &[(u64, Option<String>)]) -> Function {
+        Linear::new(
+            self.terms.into_iter().map(|(i, c)| (ids[i].0, c)),
+            self.constant,
+        )
+        .into()
+    }
+}
+
+/// Instance read from a file
+#[derive(Debug, Default)]
+struct ReadInstance {
+    maximize: bool,
+    objective: ReadFunction,
+    column_names: NameTable,
+    columns: Vec<ReadColumn>,
+    row_names: NameTable,
+    /// Constraints `f(x) <= 0` or `f(x) = 0` in the order of `row_names`
+    rows: Vec<(ReadFunction, Equality)>,
+}
+
+impl ReadInstance {
+    fn column(&mut self, name: &str) -> usize {
+        let i = self.column_names.get_or_insert(name);
+        if i == self.columns.len() {
+            self.columns.push(ReadColumn::default());
+        }
+        i
+    }
+
+    fn into_instance(self) -> Instance {
+        let column_ids = self.column_names.into_ids('x');
+        let row_ids = self.row_names.into_ids('c');
+        let mut decision_variables: Vec<DecisionVariable> = self
+            .columns
+            .into_iter()
+            .zip(column_ids.iter())
+            .map(|(column, (id, name))| column.into_decision_variable(*id, name.clone()))
+            .collect();
+        decision_variables.sort_unstable_by_key(|dv| dv.id);
+        let constraints = self
+            .rows
+            .into_iter()
+            .zip(row_ids)
+            .map(|((function, equality), (id, name))| Constraint {
+                id,
+                equality: equality as i32,
+                function: Some(function.into_function(&column_ids)),
+                name,
+                ..Default::default()
+            })
+            .collect();
+        let sense = if self.maximize {
+            Sense::Maximize
+        } else {
+            Sense::Minimize
+        };
+        Instance {
+            decision_variables,
+            objective: Some(self.objective.into_function(&column_ids)),
+            constraints,
+            sense: sense as i32,
+            ..Default::default()
+        }
+    }
+}
@@ -0,0 +1,616 @@
+//! CPLEX LP format
+//!
+//! The writer uses `Generals`, `Binaries` and `Semi-continuous` sections for the kinds of decision variables,
+//! and the bounds of semi-continuous and semi-integer variables are written in `Bounds` section.
+//!
+//! ```rust
+//! use ommx::{format::lp, v1::{Bound, Constraint, DecisionVariable, Equality, Instance, Linear, decision_variable::Kind}};
+//!
+//! // min x0 - x1 s.t. x0 + 2 x1 - 4 = 0, x0 >= -1 (continuous), x1 in [0, 10] (integer)
+//! let instance = Instance {
+//!     decision_variables: vec![
+//!         DecisionVariable { id: 0, kind: Kind::Continuous as i32, bound: Some(Bound { lower: -1.0, upper: f64::INFINITY }), ..Default::default() },
+//!         DecisionVariable { id: 1, kind: Kind::Integer as i32, bound: Some(Bound { lower: 0.0, upper: 10.0 }), ..Default::default() },
+//!     ],
+//!     objective: Some(Linear::new([(0, 1.0), (1, -1.0)].into_iter(), 0.0).into()),
+//!     constraints: vec![Constraint {
+//!         id: 0,
+//!         equality: Equality::EqualToZero as i32,
+//!         function: Some(Linear::new([(0, 1.0), (1, 2.0)].into_iter(), -4.0).into()),
+//!         ..Default::default()
+//!     }],
+//!     sense: ommx::v1::instance::Sense::Minimize as i32,
+//!     ..Default::default()
+//! };
+//!
+//! let mut buf = Vec::new();
+//! lp::write(&instance, &mut buf).unwrap();
+//! let text = String::from_utf8(buf).unwrap();
+//! assert!(text.contains(" c0: + 1 x0 + 2 x1 = 4"));
+//!
+//! let read = lp::read(text.as_bytes()).unwrap();
+//! assert_eq!(read, instance);
+//! ```
+
+use super::{columns, constraint_terms, linear_terms, Num, ReadFunction, ReadInstance};
+use crate::v1::{decision_variable::Kind, instance::Sense, Equality, Instance};
+use anyhow::{bail, ensure, Context, Result};
+use std::{
+    fmt,
+    fs::File,
+    io::{BufWriter, Read, Write},
+    path::Path,
+};
+
+/// Number of terms or names written in a line
+const TERMS_PER_LINE: usize = 8;
+
+/// Bound value, which can be infinite
+struct Bnd(f64);
+
+impl fmt::Display for Bnd {
+    fn fmt(&self, f: &mut fmt::Formatter<'_>) -> fmt::Result {
+        if self.0 == f64::INFINITY {
+            write!(f, "+inf")
+        } else if self.0 == f64::NEG_INFINITY {
+            write!(f, "-inf")
+        } else {
+            write!(f, "{}", Num(self.0))
+        }
+    }
+}
+
+/// Write terms with signs, and returns the number of terms written
+fn write_terms(out: &mut impl Write, terms: impl Iterator<Item = (u64, f64)>) -> Result<usize> {
+    let mut count = 0;
+    for (id, coefficient) in terms.filter(|(_, c)| *c != 0.0) {
+        if count > 0 && count % TERMS_PER_LINE == 0 {
+            write!(out, "\n   ")?;
+        }
+        if coefficient < 0.0 {
+            write!(out, " - {} x{}", Num(-coefficient), id)?;
+        } else {
+            write!(out, " + {} x{}", Num(coefficient), id)?;
+        }
+        count += 1;
+    }
+    Ok(count)
+}
+
+fn write_names(out: &mut impl Write, title: &str, ids: impl Iterator<Item = u64>) -> Result<()> {
+    let mut ids = ids.peekable();
+    if ids.peek().is_none() {
+        return Ok(());
+    }
+    writeln!(out, "{}", title)?;
+    for (i, id) in ids.enumerate() {
+        if i > 0 && i % TERMS_PER_LINE == 0 {
+            writeln!(out)?;
+        }
+        write!(out, " x{}", id)?;
+    }
+    writeln!(out)?;
+    Ok(())
+}
+
+/// Write the instance in the CPLEX LP format
+pub fn write(instance: &Instance, out: impl Write) -> Result<()> {
+    let mut out = BufWriter::new(out);
+    let columns = columns(instance)?;
+    let objective = instance
+        .objective
+        .as_ref()
+        .context("Objective is not set")?;
+
+    if instance.sense == Sense::Maximize as i32 {
+        writeln!(out, "Maximize")?;
+    } else {
+        writeln!(out, "Minimize")?;
+    }
+    write!(out, " obj:")?;
+    let (terms, constant) = linear_terms(objective)?;
+    let count = write_terms(&mut out, terms)?;
+    if constant < 0.0 {
+        write!(out, " - {}", Num(-constant))?;
+    } else if constant > 0.0 || count == 0 {
+        write!(out, " + {}", Num(constant))?;
+    }
+    writeln!(out)?;
+
+    writeln!(out, "Subject To")?;
+    for c in &instance.constraints {
+        let op = match Equality::try_from(c.equality) {
+            Ok(Equality::EqualToZero) => "=",
+            Ok(Equality::LessThanOrEqualToZero) => "<=",
+            _ => bail!("Unsupported equality of constraint (id = {})", c.id),
+        };
+        write!(out, " c{}:", c.id)?;
+        let (terms, constant) = constraint_terms(c)?;
+        if write_terms(&mut out, terms)? == 0 {
+            // Left-hand side must have a decision variable
+            let id = columns.keys().next().with_context(|| {
+                format!("Constraint (id = {}) without decision variables", c.id)
+            })?;
+            write!(out, " 0 x{}", id)?;
+        }
+        let rhs = if constant == 0.0 { 0.0 } else { -constant };
+        writeln!(out, " {} {}", op, Num(rhs))?;
+    }
+
+    writeln!(out, "Bounds")?;
+    for (id, column) in &columns {
+        let (lower, upper) = (column.lower, column.upper);
+        if column.is_semi() {
+            ensure!(
+                upper.is_finite(),
+                "Upper bound of semi-continuous or semi-integer decision variable (id = {}) must be finite",
+                id
+            );
+        } else if column.kind == Kind::Binary {
+            if lower == 0.0 && upper == 1.0 {
+                continue;
+            }
+        } else if lower == 0.0 && upper == f64::INFINITY {
+            // Default bound
+            continue;
+        } else if lower == f64::NEG_INFINITY && upper == f64::INFINITY {
+            writeln!(out, " x{} free", id)?;
+            continue;
+        } else if lower == upper {
+            writeln!(out, " x{} = {}", id, Num(lower))?;
+            continue;
+        }
+        writeln!(out, " {} <= x{} <= {}", Bnd(lower), id, Bnd(upper))?;
+    }
+
+    let ids = |f: fn(&super::Column) -> bool| {
+        columns
+            .iter()
+            .filter(move |(_, column)| f(column))
+            .map(|(id, _)| *id)
+    };
+    write_names(&mut out, "Generals", ids(|c| c.is_integer()))?;
+    write_names(&mut out, "Binaries", ids(|c| c.kind == Kind::Binary))?;
+    write_names(&mut out, "Semi-continuous", ids(|c| c.is_semi()))?;
+    writeln!(out, "End")?;
+    out.flush()?;
+    Ok(())
+}
+
+pub fn write_file(instance: &Instance, path: &Path) -> Result<()> {
+    write(instance, File::create(path)?)
+}
+
+#[derive(Debug, Clone, Copy, PartialEq)]
+enum Section {
+    Objective,
+    Constraints,
+    Bounds,
+    Generals,
+    Binaries,
+    SemiContinuous,
+    End,
+}
+
+/// Keywords starting sections, matched case-insensitively at the beginning of lines
+const KEYWORDS: &[(&str, Option<bool>, Section)] = &[
+    ("minimize", Some(false), Section::Objective),
+    ("minimum", Some(false), Section::Objective),
+    ("min", Some(false), Section::Objective),
+    ("maximize", Some(true), Section::Objective),
+    ("maximum", Some(true), Section::Objective),
+    ("max", Some(true), Section::Objective),
+    ("subject to", None, Section::Constraints),
+    ("such that", None, Section::Constraints),
+    ("s.t.", None, Section::Constraints),
+    ("st.", None, Section::Constraints),
+    ("st", None, Section::Constraints),
+    ("bounds", None, Section::Bounds),
+    ("bound", None, Section::Bounds),
+    ("generals", None, Section::Generals),
+    ("general", None, Section::Generals),
+    ("gen", None, Section::Generals),
+    ("integers", None, Section::Generals),
+    ("binaries", None, Section::Binaries),
+    ("binary", None, Section::Binaries),
+    ("bin", None, Section::Binaries),
+    ("semi-continuous", None, Section::SemiContinuous),
+    ("semis", None, Section::SemiContinuous),
+    ("semi", None, Section::SemiContinuous),
+    ("end", None, Section::End),
+];
+
+/// Section started by the line with the sense of objective, and the rest of the line
+fn section_keyword(line: &str) -> Option<(Option<bool>, Section, &str)> {
+    let line = line.trim_start();
+    KEYWORDS.iter().find_map(|(keyword, maximize, section)| {
+        let head = line.get(..keyword.len())?;
+        let rest = &line[keyword.len()..];
+        (head.eq_ignore_ascii_case(keyword)
+            && (rest.is_empty() || rest.starts_with(char::is_whitespace)))
+        .then_some((*maximize, *section, rest))
+    })
+}
+
+#[derive(Debug, Clone, Copy, PartialEq)]
+enum Cmp {
+    Le,
+    Ge,
+    Eq,
+}
+
+impl Cmp {
+    /// `a op b` is equivalent to `b op.flip() a`
+    fn flip(self) -> Self {
+        match self {
+            Cmp::Le => Cmp::Ge,
+            Cmp::Ge => Cmp::Le,
+            Cmp::Eq => Cmp::Eq,
+        }
+    }
+}
+
+#[derive(Debug, Clone, Copy, PartialEq)]
+enum Token<'a> {
+    Number(f64),
+    Name(&'a str),
+    /// `+1.0` or `-1.0`
+    Sign(f64),
+    Cmp(Cmp),
+    Colon,
+}
+
+fn is_infinity(name: &str) -> bool {
+    name.eq_ignore_ascii_case("inf") || name.eq_ignore_ascii_case("infinity")
+}
+
+fn tokenize<'a>(line: &'a str, tokens: &mut Vec<Token<'a>>) -> Result<()> {
+    let bytes = line.as_bytes();
+    let mut i = 0;
+    while i < bytes.len() {
+        let b = bytes[i];
+        let start = i;
+        i += 1;
+        let token = match b {
+            b if b.is_ascii_whitespace() => continue,
+            b'+' => Token::Sign(1.0),
+            b'-' => Token::Sign(-1.0),
+            b':' => Token::Colon,
+            b'<' | b'>' | b'=' => {
+                // `<`, `<=`, `=<`, `>`, `>=`, `=>`, or `=`
+                let next = bytes.get(i).cloned();
+                let cmp = match (b, next) {
+                    (b'<', Some(b'=')) | (b'=', Some(b'<')) => Some(Cmp::Le),
+                    (b'>', Some(b'=')) | (b'=', Some(b'>')) => Some(Cmp::Ge),
+                    _ => None,
+                };
+                if let Some(cmp) = cmp {
+                    i += 1;
+                    Token::Cmp(cmp)
+                } else {
+                    Token::Cmp(match b {
+                        b'<' => Cmp::Le,
+                        b'>' => Cmp::Ge,
+                        _ => Cmp::Eq,
+                    })
+                }
+            }
+            b'[' | b'^' | b'*' => bail!("Quadratic terms are not supported"),
+            b'0'..=b'9' | b'.' => {
+                while i < bytes.len() && (bytes[i].is_ascii_digit() || bytes[i] == b'.') {
+                    i += 1;
+                }
+                if i < bytes.len() && (bytes[i] == b'e' || bytes[i] == b'E') {
+                    let mut j = i + 1;
+                    if j < bytes.len() && (bytes[j] == b'+' || bytes[j] == b'-') {
+                        j += 1;
+                    }
+                    if j < bytes.len() && bytes[j].is_ascii_digit() {
+                        i = j;
+                        while i < bytes.len() && bytes[i].is_ascii_digit() {
+                            i += 1;
+                        }
+                    }
+                }
+                let number = &line[start..i];
+                Token::Number(
+                    number
+                        .parse()
+                        .with_context(|| format!("Invalid number: {}", number))?,
+                )
+            }
+            _ => {
+                while i < bytes.len()
+                    && !bytes[i].is_ascii_whitespace()
+                    && !b"+-<>=:[]^*".contains(&bytes[i])
+                {
+                    i += 1;
+                }
+                Token::Name(&line[start..i])
+            }
+        };
+        tokens.push(token);
+    }
+    Ok(())
+}
+
+struct Parser<'t, 'a> {
+    tokens: &'t [Token<'a>],
+    pos: usize,
+}
+
+impl<'t, 'a> Parser<'t, 'a> {
+    fn new(tokens: &'t [Token<'a>]) -> Self {
+        Self { tokens, pos: 0 }
+    }
+
+    fn peek(&self) -> Option<Token<'a>> {
+        self.tokens.get(self.pos).cloned()
+    }
+
+    fn next(&mut self) -> Option<Token<'a>> {
+        let token = self.peek();
+        self.pos += 1;
+        token
+    }
+
+    fn is_done(&self) -> bool {
+        self.pos >= self.tokens.len()
+    }
+
+    /// Name followed by `:`
+    fn label(&mut self) -> Option<&'a str> {
+        match (self.peek(), self.tokens.get(self.pos + 1)) {
+            (Some(Token::Name(name)), Some(Token::Colon)) => {
+                self.pos += 2;
+                Some(name)
+            }
+            _ => None,
+        }
+    }
+
+    fn sign(&mut self) -> (f64, bool) {
+        let mut sign = 1.0;
+        let mut found = false;
+        while let Some(Token::Sign(s)) = self.peek() {
+            sign *= s;
+            found = true;
+            self.pos += 1;
+        }
+        (sign, found)
+    }
+
+    /// Signed number, or infinity
+    fn value(&mut self) -> Result<f64> {
+        let (sign, _) = self.sign();
+        match self.next() {
+            Some(Token::Number(value)) => Ok(sign * value),
+            Some(Token::Name(name)) if is_infinity(name) => Ok(sign * f64::INFINITY),
+            token => bail!("Number is expected: {:?}", token),
+        }
+    }
+
+    fn cmp(&mut self) -> Result<Cmp> {
+        match self.next() {
+            Some(Token::Cmp(cmp)) => Ok(cmp),
+            token => bail!("Comparison operator is expected: {:?}", token),
+        }
+    }
+
+    /// Linear expression until a comparison operator or the end
+    fn expression(&mut self, instance: &mut ReadInstance) -> Result<ReadFunction> {
+        let mut function = ReadFunction::default();
+        loop {
+            let (sign, found) = self.sign();
+            match self.peek() {
+                Some(Token::Number(value)) => {
+                    self.pos += 1;
+                    if let Some(Token::Name(name)) = self.peek() {
+                        self.pos += 1;
+                        function.terms.push((instance.column(name), sign * value));
+                    } else {
+                        function.constant += sign * value;
+                    }
+                }
+                Some(Token::Name(name)) => {
+                    self.pos += 1;
+                    function.terms.push((instance.column(name), sign));
+                }
+                token => {
+                    ensure!(!found, "Term is expected after sign: {:?}", token);
+                    return Ok(function);
+                }
+            }
+        }
+    }
+}
+
+fn read_objective(tokens: &[Token], instance: &mut ReadInstance) -> Result<()> {
+    let mut parser = Parser::new(tokens);
+    parser.label();
+    instance.objective = parser.expression(instance)?;
+    ensure!(
+        parser.is_done(),
+        "Unexpected token in objective: {:?}",
+        parser.peek()
+    );
+    Ok(())
+}
+
+fn read_constraints(tokens: &[Token], instance: &mut ReadInstance) -> Result<()> {
+    let mut parser = Parser::new(tokens);
+    while !parser.is_done() {
+        // Unnamed constraints are named as CPLEX does
+        let name = match parser.label() {
+            Some(name) => name.to_string(),
+            None => format!("R{}", instance.rows.len() + 1),
+        };
+        let mut function = parser.expression(instance)?;
+        let cmp = parser
+            .cmp()
+            .with_context(|| format!("Constraint {}", name))?;
+        let rhs = parser
+            .value()
+            .with_context(|| format!("Constraint {}", name))?;
+        function.constant -= rhs;
+        let equality = match cmp {
+            Cmp::Le => Equality::LessThanOrEqualToZero,
+            Cmp::Eq => Equality::EqualToZero,
+            Cmp::Ge => {
+                function.terms.iter_mut().for_each(|(_, c)| *c = -*c);
+                function.constant = -function.constant;
+                Equality::LessThanOrEqualToZero
+            }
+        };
+        let index = instance.row_names.get_or_insert(&name);
+        ensure!(
+            index == instance.rows.len(),
+            "Duplicated constraint: {}",
+            name
+        );
+        instance.rows.push((function, equality));
+    }
+    Ok(())
+}
+
+fn read_bound(line: &str, instance: &mut ReadInstance) -> Result<()> {
+    let mut tokens = Vec::new();
+    tokenize(line, &mut tokens)?;
+    if tokens.is_empty() {
+        return Ok(());
+    }
+    let mut parser = Parser::new(&tokens);
+    let mut bounds = Vec::with_capacity(2);
+    let name = match parser.peek() {
+        // `x op value` or `x free`
+        Some(Token::Name(name)) if !is_infinity(name) => {
+            parser.pos += 1;
+            match parser.peek() {
+                Some(Token::Name(free)) if free.eq_ignore_ascii_case("free") => {
+                    parser.pos += 1;
+                    bounds.push((Cmp::Ge, f64::NEG_INFINITY));
+                    bounds.push((Cmp::Le, f64::INFINITY));
+                }
+                _ => {
+                    let cmp = parser.cmp()?;
+                    bounds.push((cmp, parser.value()?));
+                }
+            }
+            name
+        }
+        // `value op x` or `value op x op value`
+        _ => {
+            let value = parser.value()?;
+            bounds.push((parser.cmp()?.flip(), value));
+            let name = match parser.next() {
+                Some(Token::Name(name)) => name,
+                token => bail!("Decision variable is expected: {:?}", token),
+            };
+            if !parser.is_done() {
+                let cmp = parser.cmp()?;
+                bounds.push((cmp, parser.value()?));
+            }
+            name
+        }
+    };
+    ensure!(parser.is_done(), "Unexpected token: {:?}", parser.peek());
+    let index = instance.column(name);
+    let column = &mut instance.columns[index];
+    for (cmp, value) in bounds {
+        match cmp {
+            Cmp::Le => column.upper = Some(value),
+            Cmp::Ge => column.lower = Some(value),
+            Cmp::Eq => {
+                column.lower = Some(value);
+                column.upper = Some(value);
+            }
+        }
+    }
+    Ok(())
+}
+
+/// Read the instance from the CPLEX LP format
+///
+/// Quadratic terms, ranged constraints, and indicator constraints are not supported.
+pub fn read(mut input: impl Read) -> Result<Instance> {
+    let mut text = String::new();
+    input.read_to_string(&mut text)?;
+
+    let mut instance = ReadInstance::default();
+    let mut objective = Vec::new();
+    let mut constraints = Vec::new();
+    // Bounds and kinds are read after the constraints to keep the order of decision variables
+    let mut lines: Vec<(Section, usize, &str)> = Vec::new();
+    let mut section = None;
+    for (line_number, line) in text.lines().enumerate().map(|(i, line)| (i + 1, line)) {
+        let mut line = match line.find('\\') {
+            Some(comment) => &line[..comment],
+            None => line,
+        };
+        if let Some((maximize, next, rest)) = section_keyword(line) {
+            if let Some(maximize) = maximize {
+                instance.maximize = maximize;
+            }
+            section = Some(next);
+            line = rest;
+        }
+        let context = || format!("Invalid LP at line {}", line_number);
+        match section {
+            _ if line.trim().is_empty() => {}
+            None => bail!("{}: Objective sense is expected", context()),
+            Some(Section::Objective) => tokenize(line, &mut objective).with_context(context)?,
+            Some(Section::Constraints) => tokenize(line, &mut constraints).with_context(context)?,
+            Some(Section::End) => bail!("{}: Unexpected content after End", context()),
+            Some(section) => lines.push((section, line_number, line)),
+        }
+        if section == Some(Section::End) {
+            break;
+        }
+    }
+    ensure!(section == Some(Section::End), "End is missing");
+
+    read_objective(&objective, &mut instance).context("Invalid objective")?;
+    read_constraints(&constraints, &mut instance).context("Invalid constraints")?;
+    for (section, line_number, line) in lines {
+        let result = match section {
+            Section::Bounds => read_bound(line, &mut instance),
+            _ => {
+                for name in line.split_whitespace() {
+                    let index = instance.column(name);
+                    let column = &mut instance.columns[index];
+                    match section {
+                        Section::Generals => column.integer = true,
+                        Section::Binaries => column.binary = true,
+                        _ => column.semi = true,
+                    }
+                }
+                Ok(())
+            }
+        };
+        result.with_context(|| format!("Invalid LP at line {}", line_number))?;
+    }
+    Ok(instance.into_instance())
+}
+
+pub fn read_file(path: &Path) -> Result<Instance> {
+    read(File::open(path)?)
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use crate::arbitrary::arbitrary_sparse_mip;
+    use proptest::prelude::*;
+
+    proptest! {
+        #[test]
+        fn round_trip(mut instance in arbitrary_sparse_mip(), maximize in any::<bool>()) {
+            if maximize {
+                instance.sense = Sense::Maximize as i32;
+            }
+            let mut buf = Vec::new();
+            write(&instance, &mut buf).unwrap();
+            prop_assert_eq!(read(buf.as_slice()).unwrap(), instance);
+        }
+    }
+}
@@ -0,0 +1,459 @@
+//! Free MPS format
+//!
+//! The writer uses `OBJSENSE` section for maximization, `MARKER` lines for integer variables,
+//! and `BV` and `SC` bounds for binary and semi-continuous variables. Semi-integer variables are written as `SC` bound inside the `MARKER` lines.
+//! The constant of the objective is written as the negative `RHS` of the objective row.
+//!
+//! ```rust
+//! use ommx::{format::mps, v1::{Bound, Constraint, DecisionVariable, Equality, Instance, Linear, decision_variable::Kind}};
+//!
+//! // max x0 + 2 x1 + 1 s.t. x0 + x1 - 3 <= 0, x0 in [0, 2] (integer), x1 is binary
+//! let instance = Instance {
+//!     decision_variables: vec![
+//!         DecisionVariable { id: 0, kind: Kind::Integer as i32, bound: Some(Bound { lower: 0.0, upper: 2.0 }), ..Default::default() },
+//!         DecisionVariable { id: 1, kind: Kind::Binary as i32, bound: Some(Bound { lower: 0.0, upper: 1.0 }), ..Default::default() },
+//!     ],
+//!     objective: Some(Linear::new([(0, 1.0), (1, 2.0)].into_iter(), 1.0).into()),
+//!     constraints: vec![Constraint {
+//!         id: 0,
+//!         equality: Equality::LessThanOrEqualToZero as i32,
+//!         function: Some(Linear::new([(0, 1.0), (1, 1.0)].into_iter(), -3.0).into()),
+//!         ..Default::default()
+//!     }],
+//!     sense: ommx::v1::instance::Sense::Maximize as i32,
+//!     ..Default::default()
+//! };
+//!
+//! let mut buf = Vec::new();
+//! mps::write(&instance, &mut buf).unwrap();
+//! let text = String::from_utf8(buf).unwrap();
+//! assert!(text.contains(" BV BND x1"));
+//!
+//! let read = mps::read(text.as_bytes()).unwrap();
+//! assert_eq!(read, instance);
+//! ```
+
+use super::{columns, constraint_terms, linear_terms, Num, ReadFunction, ReadInstance};
+use crate::v1::{decision_variable::Kind, instance::Sense, Equality, Instance};
+use anyhow::{bail, ensure, Context, Result};
+use std::{
+    collections::{HashMap, HashSet},
+    fmt,
+    fs::File,
+    io::{BufRead, BufReader, BufWriter, Read, Write},
+    path::Path,
+};
+
+/// Name of the objective row if `None`, or the constraint
+#[derive(Clone, Copy)]
+struct Row(Option<u64>);
+
+impl fmt::Display for Row {
+    fn fmt(&self, f: &mut fmt::Formatter<'_>) -> fmt::Result {
+        match self.0 {
+            Some(id) => write!(f, "c{}", id),
+            None => write!(f, "obj"),
+        }
+    }
+}
+
+/// Write the instance in the free MPS format
+pub fn write(instance: &Instance, out: impl Write) -> Result<()> {
+    let mut out = BufWriter::new(out);
+    let columns = columns(instance)?;
+    let objective = instance
+        .objective
+        .as_ref()
+        .context("Objective is not set")?;
+
+    // Transpose into column-major entries
+    let mut entries: HashMap<u64, Vec<(Row, f64)>> = HashMap::with_capacity(columns.len());
+    let mut add = |row: Row, (id, coefficient): (u64, f64)| {
+        if coefficient == 0.0 {
+            return;
+        }
+        let column = entries.entry(id).or_default();
+        match column.last_mut() {
+            // Duplicated terms in the same row are adjacent
+            Some((last, c)) if last.0 == row.0 => *c += coefficient,
+            _ => column.push((row, coefficient)),
+        }
+    };
+    let (terms, objective_constant) = linear_terms(objective)?;
+    terms.for_each(|term| add(Row(None), term));
+    for c in &instance.constraints {
+        constraint_terms(c)?
+            .0
+            .for_each(|term| add(Row(Some(c.id)), term));
+    }
+
+    writeln!(out, "NAME ommx")?;
+    if instance.sense == Sense::Maximize as i32 {
+        writeln!(out, "OBJSENSE\n    MAX")?;
+    }
+    writeln!(out, "ROWS\n N  obj")?;
+    for c in &instance.constraints {
+        let ty = match Equality::try_from(c.equality) {
+            Ok(Equality::EqualToZero) => "E",
+            Ok(Equality::LessThanOrEqualToZero) => "L",
+            _ => bail!("Unsupported equality of constraint (id = {})", c.id),
+        };
+        writeln!(out, " {}  c{}", ty, c.id)?;
+    }
+
+    writeln!(out, "COLUMNS")?;
+    let mut in_marker = false;
+    for (id, column) in &columns {
+        if column.is_integer() != in_marker {
+            in_marker = column.is_integer();
+            let marker = if in_marker { "INTORG" } else { "INTEND" };
+            writeln!(out, "    MARKER 'MARKER' '{}'", marker)?;
+        }
+        match entries.get(id) {
+            Some(entries) => {
+                for (row, coefficient) in entries {
+                    writeln!(out, "    x{} {} {}", id, row, Num(*coefficient))?;
+                }
+            }
+            // Declare the column not used in any rows
+            None => writeln!(out, "    x{} obj 0", id)?,
+        }
+    }
+    if in_marker {
+        writeln!(out, "    MARKER 'MARKER' 'INTEND'")?;
+    }
+
+    writeln!(out, "RHS")?;
+    if objective_constant != 0.0 {
+        writeln!(out, "    RHS obj {}", Num(-objective_constant))?;
+    }
+    for c in &instance.constraints {
+        let constant = constraint_terms(c)?.1;
+        if constant != 0.0 {
+            writeln!(out, "    RHS c{} {}", c.id, Num(-constant))?;
+        }
+    }
+
+    writeln!(out, "BOUNDS")?;
+    for (id, column) in &columns {
+        let (lower, upper) = (column.lower, column.upper);
+        if column.kind == Kind::Binary {
+            writeln!(out, " BV BND x{}", id)?;
+            if lower != 0.0 {
+                writeln!(out, " LO BND x{} {}", id, Num(lower))?;
+            }
+            if upper != 1.0 {
+                writeln!(out, " UP BND x{} {}", id, Num(upper))?;
+            }
+            continue;
+        }
+        if column.is_semi() {
+            ensure!(
+                upper.is_finite(),
+                "Upper bound of semi-continuous or semi-integer decision variable (id = {}) must be finite",
+                id
+            );
+            if lower == f64::NEG_INFINITY {
+                writeln!(out, " MI BND x{}", id)?;
+            } else if lower != 0.0 {
+                writeln!(out, " LO BND x{} {}", id, Num(lower))?;
+            }
+            writeln!(out, " SC BND x{} {}", id, Num(upper))?;
+            continue;
+        }
+        if lower == f64::NEG_INFINITY && upper == f64::INFINITY {
+            writeln!(out, " FR BND x{}", id)?;
+            continue;
+        }
+        if lower == upper {
+            writeln!(out, " FX BND x{} {}", id, Num(lower))?;
+            continue;
+        }
+        if lower == f64::NEG_INFINITY {
+            writeln!(out, " MI BND x{}", id)?;
+        } else if lower != 0.0 || upper < 0.0 {
+            // Explicit lower bound, since negative upper bound without lower bound makes it -inf
+            writeln!(out, " LO BND x{} {}", id, Num(lower))?;
+        }
+        if upper != f64::INFINITY {
+            writeln!(out, " UP BND x{} {}", id, Num(upper))?;
+        } else if column.is_integer() {
+            // Some solvers regard integer variables without upper bound as binary
+            writeln!(out, " PL BND x{}", id)?;
+        }
+    }
+    writeln!(out, "ENDATA")?;
+    out.flush()?;
+    Ok(())
+}
+
+pub fn write_file(instance: &Instance, path: &Path) -> Result<()> {
+    write(instance, File::create(path)?)
+}
+
+#[derive(Debug, Clone, Copy, PartialEq)]
+enum Section {
+    Name,
+    ObjSense,
+    Rows,
+    Columns,
+    Rhs,
+    Bounds,
+    End,
+}
+
+fn parse_number(token: &str) -> Result<f64> {
+    token
+        .parse()
+        .with_context(|| format!("Invalid number: {}", token))
+}
+
+/// Values of `1e30` or larger are regarded as infinite as many solvers do
+fn parse_bound(token: &str) -> Result<f64> {
+    let value = parse_number(token)?;
+    Ok(if value >= 1e30 {
+        f64::INFINITY
+    } else if value <= -1e30 {
+        f64::NEG_INFINITY
+    } else {
+        value
+    })
+}
+
+/// Row of `ROWS` section other than the objective
+struct RowIndex {
+    index: usize,
+    /// `-1` for `G` rows, which are negated into `<= 0` form
+    sign: f64,
+}
+
+/// Parser state of [read]
+#[derive(Default)]
+struct Reader {
+    instance: ReadInstance,
+    objective: Option<String>,
+    rows: HashMap<String, RowIndex>,
+    /// Free rows other than the objective, which are ignored
+    free_rows: HashSet<String>,
+    in_marker: bool,
+}
+
+impl Reader {
+    fn row(&mut self, tokens: &[&str]) -> Result<()> {
+        let [ty, name] = tokens else {
+            bail!("Invalid row: {}", tokens.join(" "));
+        };
+        let (equality, sign) = match ty.to_ascii_uppercase().as_str() {
+            "N" => {
+                if self.objective.is_none() {
+                    self.objective = Some(name.to_string());
+                } else {
+                    self.free_rows.insert(name.to_string());
+                }
+                return Ok(());
+            }
+            "L" => (Equality::LessThanOrEqualToZero, 1.0),
+            "G" => (Equality::LessThanOrEqualToZero, -1.0),
+            "E" => (Equality::EqualToZero, 1.0),
+            _ => bail!("Unknown row type: {}", ty),
+        };
+        let index = self.instance.row_names.get_or_insert(name);
+        ensure!(
+            index == self.instance.rows.len(),
+            "Duplicated row: {}",
+            name
+        );
+        self.instance.rows.push((ReadFunction::default(), equality));
+        self.rows.insert(name.to_string(), RowIndex { index, sign });
+        Ok(())
+    }
+
+    /// Function and the sign of the row, or `None` for ignored free rows
+    fn function(&mut self, row: &str) -> Result<Option<(&mut ReadFunction, f64)>> {
+        if self.objective.as_deref() == Some(row) {
+            return Ok(Some((&mut self.instance.objective, 1.0)));
+        }
+        if let Some(RowIndex { index, sign }) = self.rows.get(row) {
+            return Ok(Some((&mut self.instance.rows[*index].0, *sign)));
+        }
+        ensure!(self.free_rows.contains(row), "Unknown row: {}", row);
+        Ok(None)
+    }
+
+    fn column(&mut self, tokens: &[&str]) -> Result<()> {
+        if tokens.get(1).map(|t| t.trim_matches('\'')) == Some("MARKER") {
+            match tokens.get(2).map(|t| t.trim_matches('\'')) {
+                Some("INTORG") => self.in_marker = true,
+                Some("INTEND") => self.in_marker = false,
+                _ => bail!("Unknown marker: {}", tokens.join(" ")),
+            }
+            return Ok(());
+        }
+        ensure!(
+            tokens.len() == 3 || tokens.len() == 5,
+            "Invalid column entry: {}",
+            tokens.join(" ")
+        );
+        let column = self.instance.column(tokens[0]);
+        if self.in_marker {
+            self.instance.columns[column].integer = true;
+        }
+        for pair in tokens[1..].chunks(2) {
+            let value = parse_number(pair[1])?;
+            if let Some((function, sign)) = self.function(pair[0])? {
+                function.terms.push((column, sign * value));
+            }
+        }
+        Ok(())
+    }
+
+    fn rhs(&mut self, tokens: &[&str]) -> Result<()> {
+        // The name of RHS vector is optional
+        let pairs = if tokens.len() % 2 == 1 {
+            &tokens[1..]
+        } else {
+            tokens
+        };
+        for pair in pairs.chunks(2) {
+            let value = parse_number(pair[1])?;
+            if let Some((function, sign)) = self.function(pair[0])? {
+                function.constant = -sign * value;
+            }
+        }
+        Ok(())
+    }
+
+    fn bound(&mut self, tokens: &[&str]) -> Result<()> {
+        let ty = tokens.first().context("Empty bound")?.to_ascii_uppercase();
+        let has_value = !matches!(ty.as_str(), "FR" | "MI" | "PL" | "BV");
+        // The name of bound vector is optional
+        let (name, value) = match (has_value, tokens.len()) {
+            (false, 2) => (tokens[1], None),
+            (false, 3) => (tokens[2], None),
+            (true, 3) => (tokens[1], Some(parse_bound(tokens[2])?)),
+            (true, 4) => (tokens[2], Some(parse_bound(tokens[3])?)),
+            _ => bail!("Invalid bound: {}", tokens.join(" ")),
+        };
+        let index = self.instance.column(name);
+        let column = &mut self.instance.columns[index];
+        let value = || value.context("Value of bound is missing");
+        match ty.as_str() {
+            "UP" | "UI" => {
+                let value = value()?;
+                if value < 0.0 && column.lower.is_none() {
+                    column.lower = Some(f64::NEG_INFINITY);
+                }
+                column.upper = Some(value);
+            }
+            "LO" | "LI" => column.lower = Some(value()?),
+            "FX" => {
+                column.lower = Some(value()?);
+                column.upper = Some(value()?);
+            }
+            "FR" => {
+                column.lower = Some(f64::NEG_INFINITY);
+                column.upper = Some(f64::INFINITY);
+            }
+            "MI" => column.lower = Some(f64::NEG_INFINITY),
+            "PL" => column.upper = Some(f64::INFINITY),
+            "BV" => {
+                column.binary = true;
+                column.lower = Some(0.0);
+                column.upper = Some(1.0);
+            }
+            "SC" => {
+                column.semi = true;
+                column.upper = Some(value()?);
+            }
+            _ => bail!("Unknown bound type: {}", ty),
+        }
+        if matches!(ty.as_str(), "UI" | "LI") {
+            column.integer = true;
+        }
+        Ok(())
+    }
+}
+
+/// Read the instance from the free MPS format
+///
+/// `RANGES` section and quadratic sections are not supported.
+pub fn read(input: impl Read) -> Result<Instance> {
+    let mut input = BufReader::new(input);
+    let mut reader = Reader::default();
+    let mut section = Section::Name;
+    let mut line = String::new();
+    let mut line_number = 0;
+    loop {
+        line.clear();
+        if input.read_line(&mut line)? == 0 {
+            break;
+        }
+        line_number += 1;
+        if line.starts_with('*') || line.trim().is_empty() {
+            continue;
+        }
+        let tokens: Vec<&str> = line.split_whitespace().collect();
+        let result = if !line.starts_with(char::is_whitespace) {
+            // Section header
+            section = match tokens[0].to_ascii_uppercase().as_str() {
+                "NAME" => Section::Name,
+                "OBJSENSE" => {
+                    if let Some(sense) = tokens.get(1) {
+                        reader.instance.maximize = sense.to_ascii_uppercase().starts_with("MAX");
+                    }
+                    Section::ObjSense
+                }
+                "ROWS" => Section::Rows,
+                "COLUMNS" => Section::Columns,
+                "RHS" => Section::Rhs,
+                "BOUNDS" => Section::Bounds,
+                "ENDATA" => Section::End,
+                "RANGES" => bail!("RANGES section is not supported"),
+                other => bail!("Unsupported section at line {}: {}", line_number, other),
+            };
+            Ok(())
+        } else {
+            match section {
+                Section::Name => Ok(()),
+                Section::ObjSense => {
+                    reader.instance.maximize = tokens[0].to_ascii_uppercase().starts_with("MAX");
+                    Ok(())
+                }
+                Section::Rows => reader.row(&tokens),
+                Section::Columns => reader.column(&tokens),
+                Section::Rhs => reader.rhs(&tokens),
+                Section::Bounds => reader.bound(&tokens),
+                Section::End => Ok(()),
+            }
+        };
+        result.with_context(|| format!("Invalid MPS at line {}", line_number))?;
+        if section == Section::End {
+            break;
+        }
+    }
+    ensure!(section == Section::End, "ENDATA is missing");
+    Ok(reader.instance.into_instance())
+}
+
+pub fn read_file(path: &Path) -> Result<Instance> {
+    read(File::open(path)?)
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use crate::arbitrary::arbitrary_sparse_mip;
+    use proptest::prelude::*;
+
+    proptest! {
+        #[test]
+        fn round_trip(mut instance in arbitrary_sparse_mip(), maximize in any::<bool>()) {
+            if maximize {
+                instance.sense = Sense::Maximize as i32;
+            }
+            let mut buf = Vec::new();
+            write(&instance, &mut buf).unwrap();
+            prop_assert_eq!(read(buf.as_slice()).unwrap(), instance);
+        }
+    }
+}
@@ -51,7 +51,10 @@
 //!   let (value, used_ids) = linear.evaluate(&state).unwrap();
 //!
 //!   assert_eq!(value, 1.0 * 4.0 + 2.0 * 5.0 + 3.0);
-//!   assert_eq!(used_ids, btreeset!{ 1, 2 }) // x3 is not used
+//!   assert_eq!(used_ids, btreeset!{ 1, 2 }); // x3 is not used
+//!
+//!   // Evaluate only the value, which is cheaper when used ids are not needed
+//!   assert_eq!(linear.evaluate_value(&state).unwrap(), value);
 //!   ```
 //!
 //! OMMX Artifact
@@ -144,13 +147,31 @@
 pub use ocipkg;
 
 pub mod artifact;
+pub mod format;
+pub mod profile;
 pub mod random;
 pub use prost::Message;
 mod arbitrary;
+mod canonicalize;
+mod columns;
+mod compile;
 mod convert;
+mod decode;
 mod evaluate;
+mod matrix;
+mod partial_evaluate;
+mod presolve;
 
-pub use evaluate::Evaluate;
+pub use arbitrary::InstanceParameter;
+pub use columns::SolutionColumns;
+pub use compile::{
+    CompiledFunction, CompiledInstance, EvaluatedSamples, FeasibilityChecker, IncrementalEvaluator,
+    MoveDelta, VariableIndex,
+};
+pub use evaluate::{Evaluate, UsedDecisionVariableIds, DEFAULT_FEASIBILITY_ATOL};
+pub use matrix::LinearConstraintMatrix;
+pub use partial_evaluate::PartialEvaluate;
+pub use presolve::{Postsolve, Presolved};
 
 /// Module created from `ommx.v1` proto files
 pub mod v1 {
@@ -0,0 +1,159 @@
+//! Sparse matrix export of linear [Instance] for solver adapters
+//!
+//! Solvers usually load a linear model through matrix APIs, e.g. HiGHS `passModel` or `Highs_passLp`,
+//! which take the constraint matrix in CSR (compressed sparse row) format.
+//! [LinearConstraintMatrix] collects the linear constraints of an [Instance] into such arrays at once,
+//! instead of building each constraint term by term in the adapter.
+//!
+//! For a constraint `f(x) = a^T x + c` with [Equality], the row stores `a` and `rhs = -c`, i.e.
+//!
+//! - `a^T x = rhs` for [Equality::EqualToZero]
+//! - `a^T x <= rhs` for [Equality::LessThanOrEqualToZero]
+//!
+//! ```rust
+//! use ommx::{LinearConstraintMatrix, random::random_lp};
+//! use rand::SeedableRng;
+//!
+//! let mut rng = rand_xoshiro::Xoshiro256StarStar::seed_from_u64(0);
+//! let instance = random_lp(&mut rng, 3, 2);
+//! let matrix = LinearConstraintMatrix::new(&instance).unwrap();
+//! assert_eq!(matrix.variable_ids, vec![0, 1, 2]);
+//! assert_eq!(matrix.row_offsets.len(), matrix.rhs.len() + 1);
+//! assert_eq!(matrix.columns.len(), matrix.values.len());
+//! ```
+
+use crate::{
+    compile::VariableIndex,
+    v1::{
+        decision_variable::Kind, function::Function as FunctionEnum, Equality, Function, Instance,
+    },
+};
+use anyhow::{bail, Context, Result};
+
+/// Linear constraints of [Instance] in CSR format with bounds and kinds of decision variables, see the [module document][self]
+///
+/// Columns are the dense indices of [VariableIndex], i.e. the decision variables sorted by ID.
+#[derive(Debug, Clone, PartialEq, Default)]
+pub struct LinearConstraintMatrix {
+    /// Decision variable ID of each column
+    pub variable_ids: Vec<u64>,
+    /// Lower bound of each column. `-inf` if the bound is not set, or `0` for binary variables.
+    pub lower: Vec<f64>,
+    /// Upper bound of each column. `inf` if the bound is not set, or `1` for binary variables.
+    pub upper: Vec<f64>,
+    /// [Kind] of each column as its protobuf value
+    pub kinds: Vec<i32>,
+    /// Dense coefficients of the linear objective
+    pub objective: Vec<f64>,
+    pub objective_constant: f64,
+    /// Constraint ID of each row
+    pub constraint_ids: Vec<u64>,
+    /// The `k`-th row is `columns[row_offsets[k]..row_offsets[k + 1]]` and `values[row_offsets[k]..row_offsets[k + 1]]`
+    pub row_offsets: Vec<usize>,
+    pub columns: Vec<usize>,
+    pub values: Vec<f64>,
+    pub rhs: Vec<f64>,
+    /// [Equality] of each row as its protobuf value
+    pub equalities: Vec<i32>,
+}
+
+/// Push the linear terms of the function, and return its constant
+fn push_linear(
+    function: &Function,
+    index: &VariableIndex,
+    mut push: impl FnMut(usize, f64),
+) -> Result<f64> {
+    match &function.function {
+        Some(FunctionEnum::Constant(c)) => Ok(*c),
+        Some(FunctionEnum::Linear(linear)) => {
+            for term in &linear.terms {
+                push(index.get(term.id)?, term.coefficient);
+            }
+            Ok(linear.constant)
+        }
+        Some(FunctionEnum::ColumnarLinear(linear)) => {
+            for (id, coefficient) in linear.terms() {
+                push(index.get(id)?, coefficient);
+            }
+            Ok(linear.constant)
+        }
+        Some(_) => bail!("Function must be constant or linear"),
+        None => bail!("Function is not set"),
+    }
+}
+
+impl LinearConstraintMatrix {
+    /// Returns an error if the objective or a constraint is not linear.
+    pub fn new(instance: &Instance) -> Result<Self> {
+        let index = VariableIndex::new(instance.decision_variables.iter().map(|dv| dv.id));
+        let n = index.len();
+        let mut out = Self {
+            variable_ids: index.ids().to_vec(),
+            lower: vec![f64::NEG_INFINITY; n],
+            upper: vec![f64::INFINITY; n],
+            kinds: vec![Kind::Unspecified as i32; n],
+            objective: vec![0.0; n],
+            row_offsets: Vec::with_capacity(instance.constraints.len() + 1),
+            ..Default::default()
+        };
+        for dv in &instance.decision_variables {
+            let k = index.get(dv.id)?;
+            out.kinds[k] = dv.kind;
+            if dv.kind == Kind::Binary as i32 {
+                out.lower[k] = 0.0;
+                out.upper[k] = 1.0;
+            }
+            if let Some(bound) = &dv.bound {
+                out.lower[k] = bound.lower;
+                out.upper[k] = bound.upper;
+            }
+        }
+
+        if let Some(objective) = &instance.objective {
+            let objective_coefficients = &mut out.objective;
+            out.objective_constant = push_linear(objective, &index, |k, c| {
+                objective_coefficients[k] += c;
+            })
+            .context("Objective is not linear")?;
+        }
+
+        out.row_offsets.push(0);
+        for constraint in &instance.constraints {
+            let equality = match Equality::try_from(constraint.equality) {
+                Ok(e @ (Equality::EqualToZero | Equality::LessThanOrEqualToZero)) => e,
+                _ => bail!(
+                    "Unsupported equality of constraint ({}): {:?}",
+                    constraint.id,
+                    constraint.equality
+                ),
+            };
+            let function = constraint.function.as_ref().with_context(|| {
+                format!("Function of constraint ({}) is not set", constraint.id)
+            })?;
+            let (columns, values) = (&mut out.columns, &mut out.values);
+            let constant = push_linear(function, &index, |k, c| {
+                columns.push(k);
+                values.push(c);
+            })
+            .with_context(|| format!("Constraint ({}) is not linear", constraint.id))?;
+            out.row_offsets.push(out.columns.len());
+            out.rhs.push(-constant);
+            out.equalities.push(equality as i32);
+            out.constraint_ids.push(constraint.id);
+        }
+        Ok(out)
+    }
+
+    pub fn num_rows(&self) -> usize {
+        self.rhs.len()
+    }
+
+    pub fn num_columns(&self) -> usize {
+        self.variable_ids.len()
+    }
+
+    /// Number of non-zero entries. Duplicated IDs in a constraint are not merged, see [Instance::canonicalize].
+    pub fn nnz(&self) -> usize {
+        self.values.len()
+    }
+}
@@ -18,6 +18,25 @@ pub mod linear {
         pub coefficient: f64,
     }
 }
+/// Linear function as packed parallel arrays of decision variable IDs and coefficients,
+/// i.e. a columnar (struct-of-arrays) alternative of `Linear`.
+///
+/// `{ ids: \[1, 2\], coefficients: \[2, 3\], constant: 4 }` represents `2 x_1 + 3 x_2 + 4`
+/// the same as `Linear { terms: \[{ id: 1, coefficient: 2 }, { id: 2, coefficient: 3 }\], constant: 4 }`.
+/// Since repeated scalars are packed, this is smaller on the wire and decoded without parsing each term as a message.
+///
+/// - `ids` and `coefficients` must have the same length.
+/// - IDs may be duplicated, and the coefficients of the same ID are summed up.
+#[allow(clippy::derive_partial_eq_without_eq)]
+#[derive(Clone, PartialEq, ::prost::Message)]
+pub struct ColumnarLinear {
+    #[prost(uint64, repeated, tag = "1")]
+    pub ids: ::prost::alloc::vec::Vec<u64>,
+    #[prost(double, repeated, tag = "2")]
+    pub coefficients: ::prost::alloc::vec::Vec<f64>,
+    #[prost(double, tag = "3")]
+    pub constant: f64,
+}
 /// A monomial in a multivariate polynomial.
 #[allow(clippy::derive_partial_eq_without_eq)]
 #[derive(Clone, PartialEq, ::prost::Message)]
@@ -69,7 +88,7 @@ pub struct Quadratic {
 #[allow(clippy::derive_partial_eq_without_eq)]
 #[derive(Clone, PartialEq, ::prost::Message)]
 pub struct Function {
-    #[prost(oneof = "function::Function", tags = "1, 2, 3, 4")]
+    #[prost(oneof = "function::Function", tags = "1, 2, 3, 4, 5")]
     pub function: ::core::option::Option<function::Function>,
 }
 /// Nested message and enum types in `Function`.
@@ -89,6 +108,9 @@ pub mod function {
         /// Polynomial like `f(x_1, x_2) = 4 x_1^2 + 5 x_2^3 + 6 x_1 x_2^2 + 7 x_2^2 + 8 x_1 x_2 + 9 x_1 + 10 x_2 + 11`
         #[prost(message, tag = "4")]
         Polynomial(super::Polynomial),
+        /// Linear function stored as packed arrays, see `ColumnarLinear`
+        #[prost(message, tag = "5")]
+        ColumnarLinear(super::ColumnarLinear),
     }
 }
 #[allow(clippy::derive_partial_eq_without_eq)]
@@ -340,6 +362,15 @@ pub mod instance {
         }
     }
 }
+/// Values of decision variables of contiguous IDs, i.e. `values\[i\]` is the value of the variable of ID `offset + i`.
+#[allow(clippy::derive_partial_eq_without_eq)]
+#[derive(Clone, PartialEq, ::prost::Message)]
+pub struct DenseState {
+    #[prost(uint64, tag = "1")]
+    pub offset: u64,
+    #[prost(double, repeated, tag = "2")]
+    pub values: ::prost::alloc::vec::Vec<f64>,
+}
 /// A set of values of decision variables, without any evaluation, even the
 /// feasiblity of the solution.
 #[allow(clippy::derive_partial_eq_without_eq)]
@@ -348,6 +379,10 @@ pub struct State {
     /// The value of the solution for each variable ID.
     #[prost(map = "uint64, double", tag = "1")]
     pub entries: ::std::collections::HashMap<u64, f64>,
+    /// Values of variables of contiguous IDs in a packed array, which is smaller and faster to look up than `entries`.
+    /// An ID may be stored in either `dense` or `entries`. If both have the ID, the value in `dense` is used.
+    #[prost(message, optional, tag = "2")]
+    pub dense: ::core::option::Option<DenseState>,
 }
 /// Solution with evaluated objective and constraints
 #[allow(clippy::derive_partial_eq_without_eq)]
@@ -0,0 +1,318 @@
+//! Substitute the values of a part of decision variables, e.g. to fix variables for warm-start or decomposition
+//!
+//! [PartialEvaluate::partial_evaluate] folds the variables found in the [State] into constants,
+//! and keeps the other variables as they are. [Function]s are degraded into the lowest form representing the result,
+//! e.g. a [Quadratic] whose quadratic terms are all fixed becomes a [Linear].
+
+use crate::{
+    evaluate::{constraint_equality, is_violated, DEFAULT_FEASIBILITY_ATOL},
+    v1::{
+        function::Function as FunctionEnum, linear::Term, ColumnarLinear, Constraint, Function,
+        Instance, Linear, Monomial, Polynomial, Quadratic, State,
+    },
+};
+use anyhow::{bail, Context, Result};
+use rayon::prelude::*;
+
+/// Substitute a partial [State]
+pub trait PartialEvaluate {
+    type Output;
+    fn partial_evaluate(&self, state: &State) -> Result<Self::Output>;
+}
+
+impl PartialEvaluate for Linear {
+    type Output = Linear;
+    fn partial_evaluate(&self, state: &State) -> Result<Linear> {
+        let mut constant = self.constant;
+        let mut terms = Vec::with_capacity(self.terms.len());
+        for term in &self.terms {
+            match state.get(term.id) {
+                Some(value) => constant += term.coefficient * value,
+                None => terms.push(term.clone()),
+            }
+        }
+        Ok(Linear { terms, constant })
+    }
+}
+
+impl PartialEvaluate for ColumnarLinear {
+    type Output = ColumnarLinear;
+    fn partial_evaluate(&self, state: &State) -> Result<ColumnarLinear> {
+        let mut constant = self.constant;
+        let mut out = ColumnarLinear::default();
+        for (id, coefficient) in self.terms() {
+            match state.get(id) {
+                Some(value) => constant += coefficient * value,
+                None => {
+                    out.ids.push(id);
+                    out.coefficients.push(coefficient);
+                }
+            }
+        }
+        out.constant = constant;
+        Ok(out)
+    }
+}
+
+impl PartialEvaluate for Quadratic {
+    type Output = Function;
+    /// Entries with one fixed variable move into the linear part,
+    /// whose terms are then merged by ID as [Polynomial::partial_evaluate] does.
+    /// This returns [Linear] or a constant if no quadratic entry remains.
+    ///
+    /// ```rust
+    /// use ommx::{PartialEvaluate, v1::{Linear, Quadratic, State}};
+    /// use maplit::hashmap;
+    ///
+    /// // x1 * x2 + 2 x1 * x3 + x3
+    /// let quad = Quadratic {
+    ///     rows: vec![1, 1],
+    ///     columns: vec![2, 3],
+    ///     values: vec![1.0, 2.0],
+    ///     linear: Some(Linear::new([(3, 1.0)].into_iter(), 0.0)),
+    /// };
+    /// // x1 = 3 yields 3 x2 + 7 x3
+    /// let state: State = hashmap! { 1 => 3.0 }.into();
+    /// let f = quad.partial_evaluate(&state).unwrap();
+    /// assert_eq!(f, Linear::new([(2, 3.0), (3, 7.0)].into_iter(), 0.0).into());
+    /// ```
+    fn partial_evaluate(&self, state: &State) -> Result<Function> {
+        let mut linear = match &self.linear {
+            Some(linear) => linear.partial_evaluate(state)?,
+            None => Linear::default(),
+        };
+        let mut quad = Quadratic::default();
+        let mut folded = false;
+        for (i, j, value) in
+            itertools::multizip((self.rows.iter(), self.columns.iter(), self.values.iter()))
+        {
+            match (state.get(*i), state.get(*j)) {
+                (Some(u), Some(v)) => linear.constant += value * u * v,
+                (Some(u), None) => {
+                    folded = true;
+                    linear.terms.push(Term {
+                        id: *j,
+                        coefficient: value * u,
+                    })
+                }
+                (None, Some(v)) => {
+                    folded = true;
+                    linear.terms.push(Term {
+                        id: *i,
+                        coefficient: value * v,
+                    })
+                }
+                (None, None) => {
+                    quad.rows.push(*i);
+                    quad.columns.push(*j);
+                    quad.values.push(*value);
+                }
+            }
+        }
+        // The folded terms may have the same ID as the existing ones
+        if folded {
+            linear.canonicalize(0.0);
+        }
+        if quad.values.is_empty() {
+            return Ok(degrade_linear(linear));
+        }
+        if !linear.terms.is_empty() || linear.constant != 0.0 {
+            quad.linear = Some(linear);
+        }
+        Ok(quad.into())
+    }
+}
+
+impl PartialEvaluate for Polynomial {
+    type Output = Function;
+    /// Monomials which become the same are merged, and the result is degraded into [Quadratic], [Linear] or a constant
+    /// if the remaining degree is low enough.
+    fn partial_evaluate(&self, state: &State) -> Result<Function> {
+        let mut poly = Polynomial {
+            terms: Vec::with_capacity(self.terms.len()),
+        };
+        for term in &self.terms {
+            let mut coefficient = term.coefficient;
+            let mut ids = Vec::with_capacity(term.ids.len());
+            for id in &term.ids {
+                match state.get(*id) {
+                    Some(value) => coefficient *= value,
+                    None => ids.push(*id),
+                }
+            }
+            poly.terms.push(Monomial { ids, coefficient });
+        }
+        poly.canonicalize(0.0);
+        Ok(degrade_polynomial(poly))
+    }
+}
+
+fn degrade_linear(linear: Linear) -> Function {
+    if linear.terms.is_empty() {
+        Function {
+            function: Some(FunctionEnum::Constant(linear.constant)),
+        }
+    } else {
+        linear.into()
+    }
+}
+
+/// Canonicalized polynomial into the lowest form
+fn degrade_polynomial(poly: Polynomial) -> Function {
+    let degree = poly.terms.iter().map(|t| t.ids.len()).max().unwrap_or(0);
+    if degree > 2 {
+        return poly.into();
+    }
+    let mut linear = Linear::default();
+    let mut quad = Quadratic::default();
+    for Monomial { ids, coefficient } in poly.terms {
+        match ids[..] {
+            [] => linear.constant += coefficient,
+            [id] => linear.terms.push(Term { id, coefficient }),
+            [i, j] => {
+                quad.rows.push(i);
+                quad.columns.push(j);
+                quad.values.push(coefficient);
+            }
+            _ => unreachable!(),
+        }
+    }
+    if quad.values.is_empty() {
+        return degrade_linear(linear);
+    }
+    if !linear.terms.is_empty() || linear.constant != 0.0 {
+        quad.linear = Some(linear);
+    }
+    quad.into()
+}
+
+impl PartialEvaluate for Function {
+    type Output = Function;
+    fn partial_evaluate(&self, state: &State) -> Result<Function> {
+        Ok(match &self.function {
+            Some(FunctionEnum::Constant(c)) => Function {
+                function: Some(FunctionEnum::Constant(*c)),
+            },
+            Some(FunctionEnum::Linear(linear)) => degrade_linear(linear.partial_evaluate(state)?),
+            Some(FunctionEnum::ColumnarLinear(linear)) => {
+                let linear = linear.partial_evaluate(state)?;
+                if linear.ids.is_empty() {
+                    Function {
+                        function: Some(FunctionEnum::Constant(linear.constant)),
+                    }
+                } else {
+                    linear.into()
+                }
+            }
+            Some(FunctionEnum::Quadratic(quad)) => quad.partial_evaluate(state)?,
+            Some(FunctionEnum::Polynomial(poly)) => poly.partial_evaluate(state)?,
+            None => bail!("Function is not set"),
+        })
+    }
+}
+
+impl PartialEvaluate for Constraint {
+    type Output = Constraint;
+    fn partial_evaluate(&self, state: &State) -> Result<Constraint> {
+        let function = self
+            .function
+            .as_ref()
+            .context("Function is not set")?
+            .partial_evaluate(state)?;
+        Ok(Constraint {
+            id: self.id,
+            equality: self.equality,
+            function: Some(function),
+            name: self.name.clone(),
+            parameters: self.parameters.clone(),
+            description: self.description.clone(),
+        })
+    }
+}
+
+impl PartialEvaluate for Instance {
+    type Output = Instance;
+    /// Reduced instance without the fixed decision variables
+    ///
+    /// Constraints which become constant are removed if they are satisfied within [DEFAULT_FEASIBILITY_ATOL],
+    /// and this returns an error if violated. Constraints are substituted in parallel.
+    ///
+    /// ```rust
+    /// use ommx::{Evaluate, PartialEvaluate, v1::{Constraint, DecisionVariable, Equality, Instance, Linear, State}};
+    /// use maplit::hashmap;
+    ///
+    /// // min x1 + x2 + x3 s.t. x1 + x2 - 1 <= 0, x2 + x3 - 1 <= 0
+    /// let instance = Instance {
+    ///     decision_variables: (1..=3).map(|id| DecisionVariable { id, ..Default::default() }).collect(),
+    ///     objective: Some(Linear::new([(1, 1.0), (2, 1.0), (3, 1.0)].into_iter(), 0.0).into()),
+    ///     constraints: vec![
+    ///         Constraint {
+    ///             id: 0,
+    ///             equality: Equality::LessThanOrEqualToZero as i32,
+    ///             function: Some(Linear::new([(1, 1.0), (2, 1.0)].into_iter(), -1.0).into()),
+    ///             ..Default::default()
+    ///         },
+    ///         Constraint {
+    ///             id: 1,
+    ///             equality: Equality::LessThanOrEqualToZero as i32,
+    ///             function: Some(Linear::new([(2, 1.0), (3, 1.0)].into_iter(), -1.0).into()),
+    ///             ..Default::default()
+    ///         },
+    ///     ],
+    ///     ..Default::default()
+    /// };
+    ///
+    /// // Fix x1 = 1, x2 = 0
+    /// let reduced = instance.partial_evaluate(&hashmap! { 1 => 1.0, 2 => 0.0 }.into()).unwrap();
+    /// assert_eq!(reduced.decision_variables.len(), 1);
+    /// assert_eq!(reduced.constraints.len(), 1); // x1 + x2 - 1 <= 0 is satisfied
+    ///
+    /// // The reduced instance gives the same objective as the original one
+    /// let solution = reduced.evaluate(&hashmap! { 3 => 1.0 }.into()).unwrap().0;
+    /// assert_eq!(solution.objective, 2.0);
+    /// ```
+    fn partial_evaluate(&self, state: &State) -> Result<Instance> {
+        let objective = self
+            .objective
+            .as_ref()
+            .context("Objective is not set")?
+            .partial_evaluate(state)?;
+        let constraints = self
+            .constraints
+            .par_iter()
+            .map(|c| -> Result<Option<Constraint>> {
+                let equality = constraint_equality(c)?;
+                let c = c.partial_evaluate(state)?;
+                if let Some(Function {
+                    function: Some(FunctionEnum::Constant(value)),
+                }) = c.function
+                {
+                    if is_violated(equality, value, DEFAULT_FEASIBILITY_ATOL) {
+                        bail!(
+                            "Constraint (id = {}) is violated by the fixed variables: {}",
+                            c.id,
+                            value
+                        );
+                    }
+                    return Ok(None);
+                }
+                Ok(Some(c))
+            })
+            .collect::<Result<Vec<_>>>()?
+            .into_iter()
+            .flatten()
+            .collect();
+        Ok(Instance {
+            decision_variables: self
+                .decision_variables
+                .iter()
+                .filter(|dv| state.get(dv.id).is_none())
+                .cloned()
+                .collect(),
+            objective: Some(objective),
+            constraints,
+            description: self.description.clone(),
+            sense: self.sense,
+        })
+    }
+}
@@ -0,0 +1,343 @@
+//! Presolve to remove redundancy of instances before passing them to solvers
+//!
+//! [Instance::presolve] repeats the following reductions until nothing changes:
+//!
+//! - Decision variables whose lower and upper bounds are the same are fixed, and substituted by [PartialEvaluate].
+//!   Constraints which become trivially satisfied are removed.
+//! - Linear constraints of a single decision variable, i.e. `a x + b <= 0` or `a x + b = 0`, are converted into its bound.
+//!   Bounds of integer and binary variables are rounded into integers.
+//!
+//! and then removes duplicated linear constraints, i.e. constraints which are the same up to a positive factor
+//! (or any non-zero factor for equality constraints). Only the tightest one of duplicated inequalities is kept.
+//! Coefficients are compared exactly after the normalization, and thus parallel constraints which differ by rounding errors are not detected.
+//!
+//! Semi-continuous and semi-integer variables are not reduced, since their bounds do not restrict the value `0`.
+//!
+//! The [Postsolve] returned with the reduced instance lifts a [State] of the reduced instance back to the original one.
+
+use crate::{
+    evaluate::constraint_equality,
+    v1::{
+        decision_variable::Kind, function::Function as FunctionEnum, Bound, Constraint, Equality,
+        Function, Instance, Linear, State,
+    },
+    PartialEvaluate,
+};
+use anyhow::{bail, Result};
+use std::collections::{BTreeSet, HashMap, HashSet};
+
+/// Reduced instance and how to lift its solution, returned by [Instance::presolve]
+#[derive(Debug, Clone, PartialEq)]
+pub struct Presolved {
+    pub instance: Instance,
+    pub postsolve: Postsolve,
+}
+
+/// Record of [Instance::presolve] to lift a [State] of the reduced instance back to the original instance
+#[derive(Debug, Clone, PartialEq, Default)]
+pub struct Postsolve {
+    /// Values of the decision variables fixed and removed from the instance
+    pub fixed: HashMap<u64, f64>,
+    /// IDs of the removed constraints, which are satisfied by any state of the reduced instance within its bounds
+    pub removed_constraints: BTreeSet<u64>,
+}
+
+impl Postsolve {
+    /// State for the original instance, i.e. `state` with the values of the fixed decision variables
+    pub fn lift(&self, state: &State) -> State {
+        let mut entries = state.clone().into_entries();
+        entries.extend(self.fixed.iter().map(|(id, value)| (*id, *value)));
+        entries.into()
+    }
+}
+
+fn is_semi(kind: i32) -> bool {
+    matches!(
+        Kind::try_from(kind),
+        Ok(Kind::SemiContinuous) | Ok(Kind::SemiInteger)
+    )
+}
+
+fn is_integral(kind: i32) -> bool {
+    matches!(Kind::try_from(kind), Ok(Kind::Integer) | Ok(Kind::Binary))
+}
+
+/// `(id, coefficient, constant)` if the function is linear of a single decision variable
+fn singleton(function: &Function) -> Option<(u64, f64, f64)> {
+    let (mut terms, constant): (Box<dyn Iterator<Item = (u64, f64)> + '_>, f64) = match &function
+        .function
+    {
+        Some(FunctionEnum::Linear(linear)) => (
+            Box::new(linear.terms.iter().map(|t| (t.id, t.coefficient))),
+            linear.constant,
+        ),
+        Some(FunctionEnum::ColumnarLinear(linear)) => (Box::new(linear.terms()), linear.constant),
+        _ => return None,
+    };
+    let (id, mut coefficient) = terms.next()?;
+    for (other, c) in terms {
+        if other != id {
+            return None;
+        }
+        coefficient += c;
+    }
+    (coefficient != 0.0).then_some((id, coefficient, constant))
+}
+
+/// Convert singleton constraints into bounds, and remove them. Returns whether some constraints are removed.
+fn tighten_bounds(instance: &mut Instance, removed: &mut BTreeSet<u64>, atol: f64) -> Result<bool> {
+    let index: HashMap<u64, usize> = instance
+        .decision_variables
+        .iter()
+        .enumerate()
+        .map(|(i, dv)| (dv.id, i))
+        .collect();
+    let mut retained = Vec::with_capacity(instance.constraints.len());
+    let mut changed = false;
+    for c in std::mem::take(&mut instance.constraints) {
+        let equality = constraint_equality(&c)?;
+        let target = c
+            .function
+            .as_ref()
+            .and_then(singleton)
+            .and_then(|(id, a, b)| Some((index.get(&id)?, a, b)));
+        let Some((&i, a, b)) = target else {
+            retained.push(c);
+            continue;
+        };
+        let dv = &mut instance.decision_variables[i];
+        if is_semi(dv.kind) {
+            retained.push(c);
+            continue;
+        }
+        let bound = dv.bound.get_or_insert(Bound {
+            lower: f64::NEG_INFINITY,
+            upper: f64::INFINITY,
+        });
+        // a x + b <= 0 or = 0
+        let value = -b / a;
+        if equality == Equality::EqualToZero || a > 0.0 {
+            bound.upper = bound.upper.min(value);
+        }
+        if equality == Equality::EqualToZero || a < 0.0 {
+            bound.lower = bound.lower.max(value);
+        }
+        if is_integral(dv.kind) {
+            bound.lower = (bound.lower - atol).ceil();
+            bound.upper = (bound.upper + atol).floor();
+        }
+        if bound.lower > bound.upper + atol {
+            bail!(
+                "Infeasible: bound of decision variable (id = {}) becomes [{}, {}] by constraint (id = {})",
+                dv.id,
+                bound.lower,
+                bound.upper,
+                c.id
+            );
+        }
+        if bound.lower > bound.upper {
+            bound.lower = bound.upper;
+        }
+        removed.insert(c.id);
+        changed = true;
+    }
+    instance.constraints = retained;
+    Ok(changed)
+}
+
+fn fixed_variables(instance: &Instance) -> HashMap<u64, f64> {
+    instance
+        .decision_variables
+        .iter()
+        .filter(|dv| !is_semi(dv.kind))
+        .filter_map(|dv| {
+            let bound = dv.bound.as_ref()?;
+            (bound.lower == bound.upper).then_some((dv.id, bound.lower))
+        })
+        .collect()
+}
+
+/// IDs and bit patterns of the coefficients of the linear constraints normalized so that the first coefficient is `1` or `-1`
+type RowKey = (i32, Vec<(u64, u64)>);
+
+/// Normalized row with its constant, or `None` if the constraint is not linear
+fn normalize(c: &Constraint, equality: Equality) -> Option<(RowKey, f64)> {
+    let mut linear: Linear = match &c.function.as_ref()?.function {
+        Some(FunctionEnum::Linear(linear)) => linear.clone(),
+        Some(FunctionEnum::ColumnarLinear(linear)) => linear.clone().into(),
+        _ => return None,
+    };
+    linear.canonicalize(0.0);
+    let first = linear.terms.first()?.coefficient;
+    // Equality constraints can be multiplied by a negative factor, but inequalities cannot
+    let scale = if equality == Equality::EqualToZero {
+        first
+    } else {
+        first.abs()
+    };
+    let key = linear
+        .terms
+        .iter()
+        .map(|t| (t.id, (t.coefficient / scale).to_bits()))
+        .collect();
+    Some(((equality as i32, key), linear.constant / scale))
+}
+
+/// Remove duplicated linear constraints, keeping the tightest inequality
+fn remove_duplicates(
+    instance: &mut Instance,
+    removed: &mut BTreeSet<u64>,
+    atol: f64,
+) -> Result<()> {
+    let mut rows: HashMap<RowKey, (usize, f64)> = HashMap::new();
+    let mut duplicated = vec![false; instance.constraints.len()];
+    for (position, c) in instance.constraints.iter().enumerate() {
+        let equality = constraint_equality(c)?;
+        let Some((key, constant)) = normalize(c, equality) else {
+            continue;
+        };
+        let Some((kept, kept_constant)) = rows.get_mut(&key) else {
+            rows.insert(key, (position, constant));
+            continue;
+        };
+        if equality == Equality::EqualToZero {
+            if (constant - *kept_constant).abs() > atol {
+                bail!(
+                    "Infeasible: equality constraints (id = {}, {}) are parallel but different",
+                    instance.constraints[*kept].id,
+                    c.id
+                );
+            }
+            duplicated[position] = true;
+        } else if constant > *kept_constant {
+            // `a x + b <= 0` with larger `b` is tighter
+            duplicated[*kept] = true;
+            *kept = position;
+            *kept_constant = constant;
+        } else {
+            duplicated[position] = true;
+        }
+    }
+    let mut position = 0;
+    instance.constraints.retain(|c| {
+        let keep = !duplicated[position];
+        position += 1;
+        if !keep {
+            removed.insert(c.id);
+        }
+        keep
+    });
+    Ok(())
+}
+
+impl Instance {
+    /// Reduce the instance by fixing decision variables, converting singleton constraints into bounds,
+    /// and removing duplicated constraints.
+    /// `atol` is used for rounding the bounds of integer variables, and for detecting infeasibility.
+    ///
+    /// This returns an error if the instance is found to be infeasible.
+    ///
+    /// ```rust
+    /// use ommx::{Evaluate, v1::{Bound, Constraint, DecisionVariable, Equality, Instance, Linear, decision_variable::Kind}};
+    /// use maplit::hashmap;
+    ///
+    /// let dv = |id, lower, upper| DecisionVariable {
+    ///     id,
+    ///     kind: Kind::Integer as i32,
+    ///     bound: Some(Bound { lower, upper }),
+    ///     ..Default::default()
+    /// };
+    /// let c = |id, terms: Vec<(u64, f64)>, constant| Constraint {
+    ///     id,
+    ///     equality: Equality::LessThanOrEqualToZero as i32,
+    ///     function: Some(Linear::new(terms.into_iter(), constant).into()),
+    ///     ..Default::default()
+    /// };
+    /// // min x1 + x2 + x3 with fixed x1 = 2
+    /// let instance = Instance {
+    ///     decision_variables: vec![dv(1, 2.0, 2.0), dv(2, 0.0, 10.0), dv(3, 0.0, 10.0)],
+    ///     objective: Some(Linear::new([(1, 1.0), (2, 1.0), (3, 1.0)].into_iter(), 0.0).into()),
+    ///     constraints: vec![
+    ///         c(0, vec![(1, 1.0), (2, 1.0)], -5.5),  // x2 <= 3.5 after substituting x1 = 2, i.e. x2 <= 3
+    ///         c(1, vec![(2, 1.0), (3, 1.0)], -4.0),  // x2 + x3 <= 4
+    ///         c(2, vec![(2, 2.0), (3, 2.0)], -6.0),  // x2 + x3 <= 3, tighter than the above
+    ///     ],
+    ///     ..Default::default()
+    /// };
+    ///
+    /// let presolved = instance.presolve(1e-9).unwrap();
+    /// let reduced = &presolved.instance;
+    /// assert_eq!(reduced.decision_variables.len(), 2);
+    /// assert_eq!(reduced.decision_variables[0].bound, Some(Bound { lower: 0.0, upper: 3.0 }));
+    /// assert_eq!(reduced.constraints.len(), 1);
+    /// assert_eq!(reduced.constraints[0].id, 2);
+    ///
+    /// // Lift the solution of the reduced instance to evaluate with the original instance
+    /// let state = presolved.postsolve.lift(&hashmap! { 2 => 0.0, 3 => 0.0 }.into());
+    /// let (solution, _) = instance.evaluate(&state).unwrap();
+    /// assert_eq!(solution.objective, 2.0);
+    /// ```
+    pub fn presolve(&self, atol: f64) -> Result<Presolved> {
+        let mut instance = self.clone();
+        let mut postsolve = Postsolve::default();
+        loop {
+            let tightened =
+                tighten_bounds(&mut instance, &mut postsolve.removed_constraints, atol)?;
+            let fixed = fixed_variables(&instance);
+            if fixed.is_empty() {
+                if tightened {
+                    continue;
+                }
+                break;
+            }
+            let before: Vec<u64> = instance.constraints.iter().map(|c| c.id).collect();
+            instance = instance.partial_evaluate(&fixed.clone().into())?;
+            // Constraints which become constant are removed by `partial_evaluate`
+            let after: HashSet<u64> = instance.constraints.iter().map(|c| c.id).collect();
+            postsolve
+                .removed_constraints
+                .extend(before.into_iter().filter(|id| !after.contains(id)));
+            postsolve.fixed.extend(fixed);
+        }
+        remove_duplicates(&mut instance, &mut postsolve.removed_constraints, atol)?;
+        Ok(Presolved {
+            instance,
+            postsolve,
+        })
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use crate::{
+        arbitrary::{arbitrary_sparse_mip, arbitrary_state},
+        evaluate::{is_violated, DEFAULT_FEASIBILITY_ATOL},
+        Evaluate,
+    };
+    use proptest::prelude::*;
+
+    /// Instance, its presolved one, and a state within the bounds of the presolved one
+    fn presolved_and_state() -> impl Strategy<Value = (Instance, Presolved, State)> {
+        arbitrary_sparse_mip().prop_flat_map(|instance| {
+            let presolved = instance.presolve(1e-9).unwrap();
+            let state = arbitrary_state(&presolved.instance);
+            (Just(instance), Just(presolved), state)
+        })
+    }
+
+    proptest! {
+        #[test]
+        fn lift_preserves_objective_and_feasibility((instance, presolved, state) in presolved_and_state()) {
+            let (reduced, _) = presolved.instance.evaluate(&state).unwrap();
+            let (lifted, _) = instance.evaluate(&presolved.postsolve.lift(&state)).unwrap();
+            prop_assert!((lifted.objective - reduced.objective).abs() <= 1e-9 * (1.0 + reduced.objective.abs()));
+            prop_assert_eq!(lifted.feasible, reduced.feasible);
+            for c in &lifted.evaluated_constraints {
+                if presolved.postsolve.removed_constraints.contains(&c.id) {
+                    prop_assert!(!is_violated(Equality::try_from(c.equality).unwrap(), c.evaluated_value, DEFAULT_FEASIBILITY_ATOL));
+                }
+            }
+        }
+    }
+}
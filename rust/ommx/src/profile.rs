@@ -0,0 +1,155 @@
+//! Timing breakdown of the instrumented operations
+//!
+//! Artifact operations, blob reads, encoding and decoding of messages, and evaluation of instances
+//! are wrapped in [tracing] spans named after the functions, e.g. `pull_with` or `decode_parallel`.
+//! Spans carry the sizes of the operation as fields, e.g. `bytes`, `constraints` and `nnz`.
+//! They cost almost nothing unless a subscriber is installed,
+//! and any [tracing] subscriber, e.g. the OpenTelemetry layer of `tracing-opentelemetry`, can export them.
+//!
+//! [Profiler] is a [Layer] which aggregates the spans by name, used by the `--profile` flag of the `ommx` CLI.
+//!
+//! ```rust
+//! use ommx::{profile::Profiler, random::random_lp, Evaluate};
+//! use rand::SeedableRng;
+//! use tracing_subscriber::layer::SubscriberExt;
+//!
+//! let profiler = Profiler::default();
+//! let subscriber = tracing_subscriber::registry().with(profiler.clone());
+//! tracing::subscriber::with_default(subscriber, || {
+//!     let mut rng = rand_xoshiro::Xoshiro256StarStar::seed_from_u64(0);
+//!     let instance = random_lp(&mut rng, 10, 5);
+//!     let state = (0..10).map(|id| (id, 0.0)).collect::<std::collections::HashMap<_, _>>().into();
+//!     instance.evaluate(&state).unwrap();
+//! });
+//! let report = profiler.report();
+//! assert_eq!(report["evaluate_with_used_ids"].count, 1);
+//! println!("{}", profiler);
+//! ```
+
+use std::{
+    collections::BTreeMap,
+    fmt,
+    sync::{Arc, Mutex},
+    time::{Duration, Instant},
+};
+use tracing::{
+    field::{Field, Visit},
+    span::{Attributes, Id, Record},
+    Subscriber,
+};
+use tracing_subscriber::{layer::Context, registry::LookupSpan, Layer};
+
+/// Aggregated spans of the same name
+#[derive(Debug, Clone, Copy, PartialEq, Default)]
+pub struct SpanStat {
+    pub count: usize,
+    /// Sum of the wall-clock time from the creation to the close of the spans, including their child spans
+    pub total: Duration,
+    /// Sum of the `bytes` fields of the spans
+    pub bytes: u64,
+}
+
+/// [Layer] aggregating closed spans into [SpanStat] by their names
+///
+/// Clones share the same statistics, so that a clone can be installed as a subscriber and the other is used for [Profiler::report].
+#[derive(Debug, Clone, Default)]
+pub struct Profiler {
+    stats: Arc<Mutex<BTreeMap<&'static str, SpanStat>>>,
+}
+
+impl Profiler {
+    /// Snapshot of the statistics of the spans closed so far
+    pub fn report(&self) -> BTreeMap<&'static str, SpanStat> {
+        self.stats.lock().unwrap().clone()
+    }
+}
+
+/// Shown as a table sorted by the total time
+impl fmt::Display for Profiler {
+    fn fmt(&self, f: &mut fmt::Formatter<'_>) -> fmt::Result {
+        let mut stats: Vec<_> = self.report().into_iter().collect();
+        stats.sort_by(|(_, a), (_, b)| b.total.cmp(&a.total));
+        writeln!(
+            f,
+            "{:<32} {:>8} {:>12} {:>12} {:>14}",
+            "span", "count", "total (ms)", "mean (ms)", "bytes"
+        )?;
+        for (name, stat) in stats {
+            let total = stat.total.as_secs_f64() * 1e3;
+            writeln!(
+                f,
+                "{:<32} {:>8} {:>12.3} {:>12.3} {:>14}",
+                name,
+                stat.count,
+                total,
+                total / stat.count as f64,
+                stat.bytes
+            )?;
+        }
+        Ok(())
+    }
+}
+
+/// Stored in the extensions of each span
+struct Timing {
+    start: Instant,
+    bytes: u64,
+}
+
+struct BytesVisitor<'a>(&'a mut u64);
+
+impl Visit for BytesVisitor<'_> {
+    fn record_u64(&mut self, field: &Field, value: u64) {
+        if field.name() == "bytes" {
+            *self.0 = value;
+        }
+    }
+
+    fn record_i64(&mut self, field: &Field, value: i64) {
+        self.record_u64(field, value.max(0) as u64);
+    }
+
+    fn record_debug(&mut self, _field: &Field, _value: &dyn fmt::Debug) {}
+}
+
+impl<S> Layer<S> for Profiler
+where
+    S: Subscriber + for<'a> LookupSpan<'a>,
+{
+    fn on_new_span(&self, attrs: &Attributes<'_>, id: &Id, ctx: Context<'_, S>) {
+        let Some(span) = ctx.span(id) else {
+            return;
+        };
+        let mut bytes = 0;
+        attrs.record(&mut BytesVisitor(&mut bytes));
+        span.extensions_mut().insert(Timing {
+            start: Instant::now(),
+            bytes,
+        });
+    }
+
+    /// Fields recorded after the creation, e.g. the size of a downloaded blob
+    fn on_record(&self, id: &Id, values: &Record<'_>, ctx: Context<'_, S>) {
+        let Some(span) = ctx.span(id) else {
+            return;
+        };
+        if let Some(timing) = span.extensions_mut().get_mut::<Timing>() {
+            values.record(&mut BytesVisitor(&mut timing.bytes));
+        }
+    }
+
+    fn on_close(&self, id: Id, ctx: Context<'_, S>) {
+        let Some(span) = ctx.span(&id) else {
+            return;
+        };
+        let extensions = span.extensions();
+        let Some(timing) = extensions.get::<Timing>() else {
+            return;
+        };
+        let mut stats = self.stats.lock().unwrap();
+        let stat = stats.entry(span.name()).or_default();
+        stat.count += 1;
+        stat.total += timing.start.elapsed();
+        stat.bytes += timing.bytes;
+    }
+}
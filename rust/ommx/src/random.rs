@@ -1,7 +1,10 @@
 //! Randomly generate OMMX components for benchmarking and testing
 
-use crate::v1::{self, linear::Term, Constraint, Equality};
-use rand::Rng;
+use crate::v1::{
+    self, decision_variable::Kind, instance::Sense, linear::Term, Bound, Constraint,
+    DecisionVariable, Equality, Monomial,
+};
+use rand::{seq::index, Rng};
 
 /// Create a random linear programming (LP) instance in a form of `min c^T x` subject to `Ax = b` and `x >= 0` with continuous variables `x`.
 pub fn random_lp(rng: &mut impl Rng, num_variables: usize, num_constraints: usize) -> v1::Instance {
@@ -38,3 +41,217 @@ pub fn random_lp(rng: &mut impl Rng, num_variables: usize, num_constraints: usiz
 
     instance
 }
+
+fn decision_variable(id: u64, kind: Kind, lower: f64, upper: f64) -> DecisionVariable {
+    DecisionVariable {
+        id,
+        kind: kind as i32,
+        bound: Some(Bound { lower, upper }),
+        ..Default::default()
+    }
+}
+
+/// Sorted `amount` distinct integers in `0..length`, using memory proportional to `amount` when `amount << length`
+fn sample_sorted(rng: &mut impl Rng, length: usize, amount: usize) -> Vec<usize> {
+    let mut indices = index::sample(rng, length, amount).into_vec();
+    indices.sort_unstable();
+    indices
+}
+
+/// Lazily generate `num_constraints` random sparse linear constraints `a^T x - b <= 0` with `b >= 0`, so that `x = 0` is always feasible.
+///
+/// Each constraint has `max(1, round(density * num_variables))` terms on distinct variables chosen uniformly in `0..num_variables`.
+/// If `num_variables` is `0`, each constraint is the constant `-b <= 0`.
+/// Since constraints are generated one by one, a large instance can be written out, e.g. into shards, without holding all of them.
+///
+/// # Panics
+///
+/// Panics if `density` is not in `(0, 1]`.
+pub fn random_sparse_constraints(
+    rng: &mut impl Rng,
+    num_variables: usize,
+    num_constraints: usize,
+    density: f64,
+) -> impl Iterator<Item = Constraint> + '_ {
+    assert!(
+        density > 0.0 && density <= 1.0,
+        "Density must be in (0, 1]: {density}"
+    );
+    // `clamp(1, num_variables)` panics for `num_variables == 0`
+    let num_terms = ((density * num_variables as f64).round() as usize)
+        .max(1)
+        .min(num_variables);
+    (0..num_constraints).map(move |constraint_id| {
+        let linear = v1::Linear {
+            terms: sample_sorted(rng, num_variables, num_terms)
+                .into_iter()
+                .map(|id| Term {
+                    id: id as u64,
+                    coefficient: rng.gen_range(-1.0..1.0),
+                })
+                .collect(),
+            constant: -rng.gen_range(0.0..1.0),
+        };
+        Constraint {
+            id: constraint_id as u64,
+            equality: Equality::LessThanOrEqualToZero as i32,
+            function: Some(linear.into()),
+            ..Default::default()
+        }
+    })
+}
+
+/// Create a random sparse mixed integer programming (MIP) instance `min c^T x` subject to `Ax <= b` and `0 <= x <= 10`.
+///
+/// Each variable is integer with probability `integer_ratio`, and continuous otherwise.
+/// `A` is generated by [random_sparse_constraints], i.e. it has about `density * num_variables * num_constraints` non-zeros,
+/// and the whole generation takes time and memory proportional to the size of the instance.
+///
+/// ```rust
+/// use ommx::random::random_sparse_mip;
+/// use rand::SeedableRng;
+///
+/// let mut rng = rand_xoshiro::Xoshiro256StarStar::seed_from_u64(0);
+/// let instance = random_sparse_mip(&mut rng, 1000, 10, 0.01, 0.5);
+/// assert_eq!(instance.decision_variables.len(), 1000);
+/// assert_eq!(instance.constraints.len(), 10);
+/// ```
+///
+/// # Panics
+///
+/// Panics if `density` is not in `(0, 1]`.
+pub fn random_sparse_mip(
+    rng: &mut impl Rng,
+    num_variables: usize,
+    num_constraints: usize,
+    density: f64,
+    integer_ratio: f64,
+) -> v1::Instance {
+    let decision_variables = (0..num_variables as u64)
+        .map(|id| {
+            let kind = if rng.gen_bool(integer_ratio.clamp(0.0, 1.0)) {
+                Kind::Integer
+            } else {
+                Kind::Continuous
+            };
+            decision_variable(id, kind, 0.0, 10.0)
+        })
+        .collect();
+    let objective = v1::Linear {
+        terms: (0..num_variables as u64)
+            .map(|id| Term {
+                id,
+                coefficient: rng.gen_range(-1.0..1.0),
+            })
+            .collect(),
+        constant: 0.0,
+    };
+    let constraints =
+        random_sparse_constraints(rng, num_variables, num_constraints, density).collect();
+    v1::Instance {
+        decision_variables,
+        objective: Some(objective.into()),
+        constraints,
+        sense: Sense::Minimize as i32,
+        ..Default::default()
+    }
+}
+
+/// `k`-th entry of the upper triangular part of a matrix, ordered as `(0, 0), (0, 1), (1, 1), (0, 2), (1, 2), (2, 2), ...`
+fn upper_triangular_entry(k: u64) -> (u64, u64) {
+    let mut column = ((((8 * k + 1) as f64).sqrt() - 1.0) / 2.0) as u64;
+    // Fix the rounding error of floating point
+    while column * (column + 1) / 2 > k {
+        column -= 1;
+    }
+    while (column + 1) * (column + 2) / 2 <= k {
+        column += 1;
+    }
+    (k - column * (column + 1) / 2, column)
+}
+
+/// Create a random quadratic unconstrained binary optimization (QUBO) instance `min x^T Q x` with binary variables `x`.
+///
+/// `Q` is an upper triangular matrix with `nnz` non-zero entries, including the diagonal, at distinct positions chosen uniformly.
+/// The memory used for generation is proportional to `nnz` unless `nnz` is comparable to `num_variables^2 / 2`.
+///
+/// ```rust
+/// use ommx::random::random_qubo;
+/// use rand::SeedableRng;
+///
+/// let mut rng = rand_xoshiro::Xoshiro256StarStar::seed_from_u64(0);
+/// let instance = random_qubo(&mut rng, 1_000_000, 100);
+/// assert_eq!(instance.decision_variables.len(), 1_000_000);
+/// ```
+///
+/// # Panics
+///
+/// Panics if `nnz` exceeds `num_variables * (num_variables + 1) / 2`.
+pub fn random_qubo(rng: &mut impl Rng, num_variables: usize, nnz: usize) -> v1::Instance {
+    let num_entries = num_variables * (num_variables + 1) / 2;
+    assert!(
+        nnz <= num_entries,
+        "nnz ({nnz}) exceeds the number of upper triangular entries ({num_entries})"
+    );
+    let mut quadratic = v1::Quadratic {
+        rows: Vec::with_capacity(nnz),
+        columns: Vec::with_capacity(nnz),
+        values: Vec::with_capacity(nnz),
+        linear: None,
+    };
+    for k in sample_sorted(rng, num_entries, nnz) {
+        let (row, column) = upper_triangular_entry(k as u64);
+        quadratic.rows.push(row);
+        quadratic.columns.push(column);
+        quadratic.values.push(rng.gen_range(-1.0..1.0));
+    }
+    v1::Instance {
+        decision_variables: (0..num_variables as u64)
+            .map(|id| decision_variable(id, Kind::Binary, 0.0, 1.0))
+            .collect(),
+        objective: Some(quadratic.into()),
+        sense: Sense::Minimize as i32,
+        ..Default::default()
+    }
+}
+
+/// Create a random unconstrained polynomial instance with binary variables,
+/// i.e. higher-order binary optimization (HUBO), for stress tests of [v1::Polynomial].
+///
+/// The objective has `num_terms` monomials, each of which has a degree chosen uniformly in `1..=max_degree` and distinct variables.
+/// The same monomial may appear twice.
+///
+/// # Panics
+///
+/// Panics if `max_degree` is zero or exceeds `num_variables`.
+pub fn random_polynomial(
+    rng: &mut impl Rng,
+    num_variables: usize,
+    num_terms: usize,
+    max_degree: usize,
+) -> v1::Instance {
+    assert!(
+        max_degree >= 1 && max_degree <= num_variables,
+        "max_degree ({max_degree}) must be in 1..=num_variables ({num_variables})"
+    );
+    let terms = (0..num_terms)
+        .map(|_| {
+            let degree = rng.gen_range(1..=max_degree);
+            Monomial {
+                ids: sample_sorted(rng, num_variables, degree)
+                    .into_iter()
+                    .map(|id| id as u64)
+                    .collect(),
+                coefficient: rng.gen_range(-1.0..1.0),
+            }
+        })
+        .collect();
+    v1::Instance {
+        decision_variables: (0..num_variables as u64)
+            .map(|id| decision_variable(id, Kind::Binary, 0.0, 1.0))
+            .collect(),
+        objective: Some(v1::Polynomial { terms }.into()),
+        sense: Sense::Minimize as i32,
+        ..Default::default()
+    }
+}